@@ -1,5 +1,7 @@
 ##############################################################################
-ifndef EMSCRIPTEN
+ifdef HOST
+BUILD = ./build-host
+else ifndef EMSCRIPTEN
 BUILD = ./build
 else
 BUILD = ./build-sim
@@ -23,7 +25,7 @@ override BOARD = OSO-SWAT-A1-05
 endif
 
 ##############################################################################
-.PHONY: all directory clean size
+.PHONY: all directory clean size bench test
 
 # OS detection, adapted from https://gist.github.com/sighingnow/deee806603ec9274fd47
 DETECTED_OS :=
@@ -57,7 +59,57 @@ ifeq ($(DETECTED_OS), WINDOWS)
   MAKEFLAGS += -j $(NUMBER_OF_PROCESSORS)
 endif
 
-ifndef EMSCRIPTEN
+ifdef HOST
+
+CFLAGS += -W -Wall -Wextra -Wmissing-prototypes -Wmissing-declarations
+CFLAGS += -Wno-format -Wno-unused-parameter
+CFLAGS += --std=gnu99 -O2 -g
+CFLAGS += -MD -MP -MT $(BUILD)/$(*F).o -MF $(BUILD)/$(@F).d
+
+LIBS += -lm
+
+INCLUDES += \
+  -I$(TOP)/boards/$(BOARD) \
+  -I$(TOP)/watch-library/shared/driver/ \
+  -I$(TOP)/watch-library/shared/config/ \
+  -I$(TOP)/watch-library/shared/watch/ \
+  -I$(TOP)/watch-library/host/watch/ \
+  -I$(TOP)/watch-library/simulator/hpl/port/ \
+  -I$(TOP)/watch-library/hardware/include/component \
+  -I$(TOP)/watch-library/hardware/hal/include/ \
+  -I$(TOP)/watch-library/hardware/hal/utils/include/ \
+  -I$(TOP)/watch-library/hardware/hpl/slcd/ \
+  -I$(TOP)/watch-library/hardware/hw/ \
+
+# the host backend borrows the simulator's implementations wherever they are plain C.
+SRCS += \
+  $(TOP)/watch-library/host/main.c \
+  $(TOP)/watch-library/host/main_loop.c \
+  $(TOP)/watch-library/host/watch/watch_rtc.c \
+  $(TOP)/watch-library/host/watch/watch_slcd.c \
+  $(TOP)/watch-library/host/watch/watch_extint.c \
+  $(TOP)/watch-library/host/watch/watch_led.c \
+  $(TOP)/watch-library/host/watch/watch_buzzer.c \
+  $(TOP)/watch-library/simulator/watch/watch_adc.c \
+  $(TOP)/watch-library/simulator/watch/watch_gpio.c \
+  $(TOP)/watch-library/host/watch/watch_i2c.c \
+  $(TOP)/watch-library/simulator/watch/watch_spi.c \
+  $(TOP)/watch-library/simulator/watch/watch_uart.c \
+  $(TOP)/watch-library/host/watch/watch_storage.c \
+  $(TOP)/watch-library/host/watch/watch_deepsleep.c \
+  $(TOP)/watch-library/host/watch/watch_private.c \
+  $(TOP)/watch-library/host/watch/watch.c \
+  $(TOP)/watch-library/shared/driver/thermistor_driver.c \
+  $(TOP)/watch-library/shared/driver/lis2dw.c \
+  $(TOP)/watch-library/shared/driver/opt3001.c \
+  $(TOP)/watch-library/shared/driver/spiflash.c \
+  $(TOP)/watch-library/shared/watch/watch_private_display.c \
+  $(TOP)/watch-library/shared/watch/watch_utility.c \
+
+DEFINES += \
+  -DWATCH_HOST=1
+
+else ifndef EMSCRIPTEN
 CC = arm-none-eabi-gcc
 OBJCOPY = arm-none-eabi-objcopy
 SIZE = arm-none-eabi-size
@@ -215,6 +267,9 @@ SRCS += \
 
 endif
 
+# generated headers, like the glyph table, end up in the build directory.
+INCLUDES += -I$(BUILD)
+
 ifeq ($(LED), BLUE)
 CFLAGS += -DWATCH_IS_BLUE_BOARD
 endif
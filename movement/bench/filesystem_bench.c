@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// parses a 100-line totp_uris.txt the way totp_face_lfs used to, calling filesystem_read_line for every line,
+// and then with a filesystem_reader_t, and reports how much flash each one read.
+// build and run it with `make HOST=1 COLOR=GREEN bench` in movement/make.
+
+#include <stdio.h>
+#include <string.h>
+#include "filesystem.h"
+
+#define NUM_LINES 100
+
+static void print_stats(const char *name, uint32_t lines) {
+    watch_host_storage_stats_t stats = watch_host_get_storage_stats(true);
+    printf("%-16s %3lu lines: %5lu flash reads, %6lu bytes read\n", name,
+           (unsigned long)lines, (unsigned long)stats.reads, (unsigned long)stats.bytes_read);
+}
+
+int main(void) {
+    static char contents[NUM_LINES * 48];
+    char line[256];
+    size_t length = 0;
+
+    if (!filesystem_init()) {
+        printf("couldn't mount the filesystem\n");
+        return 1;
+    }
+
+    for (int i = 0; i < NUM_LINES; i++) {
+        length += sprintf(contents + length, "otpauth://totp/a%02d?secret=JBSWY3DPEHPK3PXP\n", i);
+    }
+    if (!filesystem_write_file("totp_uris.txt", contents, length)) {
+        printf("couldn't write totp_uris.txt\n");
+        return 1;
+    }
+    watch_host_get_storage_stats(true);
+
+    uint32_t lines_before = 0;
+    int32_t offset = 0;
+    while (filesystem_read_line("totp_uris.txt", line, &offset, 255) && strlen(line)) lines_before++;
+    print_stats("read_line", lines_before);
+
+    uint32_t lines_after = 0;
+    filesystem_reader_t reader;
+    if (!filesystem_open(&reader, "totp_uris.txt")) {
+        printf("couldn't open totp_uris.txt\n");
+        return 1;
+    }
+    while (filesystem_next_line(&reader, line, sizeof(line)) && strlen(line)) lines_after++;
+    filesystem_close(&reader);
+    print_stats("reader", lines_after);
+
+    return lines_before == NUM_LINES && lines_after == NUM_LINES ? 0 : 1;
+}
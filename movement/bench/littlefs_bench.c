@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// replays the kinds of things faces do with the filesystem, and reports how hard each one works the flash.
+// movement/make builds it twice, with filesystem.c's default littlefs configuration and with FILESYSTEM_TUNED,
+// and `make HOST=1 COLOR=GREEN bench` runs both, so you can compare them.
+
+#include <stdio.h>
+#include <string.h>
+#include "filesystem.h"
+#include "datalog.h"
+
+#define NUM_TOTP_URIS 8
+#define NUM_TOTP_PARSES 20
+#define NUM_SETTINGS_SAVES 50
+#define NUM_LOG_RECORDS (24 * 14)
+
+static void print_stats(const char *name, uint32_t operations) {
+    watch_host_storage_stats_t stats = watch_host_get_storage_stats(true);
+    printf("%-14s %4lu ops: %5lu reads %7lu bytes, %4lu progs %6lu bytes, %3lu erases (%2lu on the busiest row), %4lu syncs, %5lu ms waiting\n",
+           name, (unsigned long)operations,
+           (unsigned long)stats.reads, (unsigned long)stats.bytes_read,
+           (unsigned long)stats.writes, (unsigned long)stats.bytes_written,
+           (unsigned long)stats.erases, (unsigned long)stats.most_erases, (unsigned long)stats.syncs,
+           (unsigned long)(stats.wait_ticks * 1000 / MAIN_LOOP_TICKS_PER_SECOND));
+}
+
+// writes a handful of TOTP URIs, then reads them back the way totp_face_lfs does each time it's activated.
+static bool totp_parse(void) {
+    char contents[NUM_TOTP_URIS * 96];
+    char line[128];
+    size_t length = 0;
+
+    for (int i = 0; i < NUM_TOTP_URIS; i++) {
+        length += sprintf(contents + length, "otpauth://totp/Site%d:me@example.com?secret=JBSWY3DPEHPK3PXP&issuer=Site%d\n", i, i);
+    }
+    if (!filesystem_write_file("totp_uris.txt", contents, length)) return false;
+    print_stats("totp write", 1);
+
+    for (int i = 0; i < NUM_TOTP_PARSES; i++) {
+        filesystem_reader_t reader;
+        int lines = 0;
+        if (!filesystem_open(&reader, "totp_uris.txt")) return false;
+        while (filesystem_next_line(&reader, line, sizeof(line)) && strlen(line)) lines++;
+        filesystem_close(&reader);
+        if (lines != NUM_TOTP_URIS) return false;
+    }
+    print_stats("totp parse", NUM_TOTP_PARSES);
+
+    return true;
+}
+
+// saves a small settings struct over and over, like nanosec_face and tempchart_face do when they resign.
+static bool settings_save(void) {
+    struct {
+        int16_t correction_cadence;
+        int16_t freq_correction;
+        int16_t center_temperature;
+        int16_t quadratic_tempco;
+        int16_t crystal_aging;
+        uint32_t last_correction_time;
+    } settings = {0};
+
+    for (int i = 0; i < NUM_SETTINGS_SAVES; i++) {
+        settings.freq_correction = i;
+        if (!filesystem_write_file("nanosec.ini", (char *)&settings, sizeof(settings))) return false;
+    }
+    print_stats("settings save", NUM_SETTINGS_SAVES);
+
+    for (int i = 0; i < NUM_SETTINGS_SAVES; i++) {
+        if (!filesystem_read_file("nanosec.ini", (char *)&settings, sizeof(settings))) return false;
+    }
+    print_stats("settings load", NUM_SETTINGS_SAVES);
+
+    return settings.freq_correction == NUM_SETTINGS_SAVES - 1;
+}
+
+// two weeks of hourly readings, logged the way thermistor_logging_face does.
+static bool log_appends(void) {
+    datalog_t log = {
+        .name = "templog",
+        .payload_size = sizeof(float),
+        .num_segments = 3,
+        .records_per_segment = 50,
+        .flush_every = 4,
+    };
+
+    if (!datalog_open(&log)) return false;
+    for (int i = 0; i < NUM_LOG_RECORDS; i++) {
+        float temperature_c = 20 + (i % 24) / 4.0;
+        if (!datalog_append(&log, i, &temperature_c)) return false;
+    }
+    if (!datalog_flush(&log)) return false;
+    print_stats("log append", NUM_LOG_RECORDS);
+
+    int32_t count = datalog_count(&log);
+    int32_t index = datalog_find(&log, NUM_LOG_RECORDS - 24);
+    print_stats("log find", 1);
+
+    return count >= 100 && index == count - 24;
+}
+
+int main(void) {
+#if FILESYSTEM_TUNED
+    printf("tuned littlefs configuration\n");
+#else
+    printf("default littlefs configuration\n");
+#endif
+
+    if (!filesystem_init()) {
+        printf("couldn't mount the filesystem\n");
+        return 1;
+    }
+    print_stats("format", 1);
+
+    bool success = totp_parse() && settings_save() && log_appends();
+    printf("%ld bytes free\n", (long)filesystem_get_free_space());
+    print_stats("df", 1);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "datalog.h"
+#include "filesystem.h"
+
+// room for the log's name, a dot, a one-digit segment number and a null terminator.
+#define DATALOG_FILENAME_SIZE (32)
+
+// each segment file starts with this header, followed by its records.
+typedef struct {
+    uint32_t sequence;      // goes up by one for each new segment, so we can tell which is the newest
+    uint16_t record_size;   // the size of each record, timestamp included
+    uint16_t reserved;
+} datalog_header_t;
+
+static uint16_t _datalog_record_size(datalog_t *log) {
+    return sizeof(uint32_t) + log->payload_size;
+}
+
+static void _datalog_filename(datalog_t *log, uint8_t segment, char *filename) {
+    snprintf(filename, DATALOG_FILENAME_SIZE, "%s.%d", log->name, segment);
+}
+
+// segments in order from oldest (0) to the head (num_segments - 1)
+static uint8_t _datalog_segment(datalog_t *log, uint8_t i) {
+    return (log->head + 1 + i) % log->num_segments;
+}
+
+static int32_t _datalog_segment_count(datalog_t *log, uint8_t segment) {
+    char filename[DATALOG_FILENAME_SIZE];
+    _datalog_filename(log, segment, filename);
+    int32_t size = filesystem_get_file_size(filename);
+    if (size < (int32_t)sizeof(datalog_header_t)) return 0;
+    return (size - sizeof(datalog_header_t)) / _datalog_record_size(log);
+}
+
+static bool _datalog_open_segment(datalog_t *log, uint8_t segment, filesystem_reader_t *reader) {
+    char filename[DATALOG_FILENAME_SIZE];
+    _datalog_filename(log, segment, filename);
+    return filesystem_open(reader, filename);
+}
+
+static bool _datalog_read_record(datalog_t *log, filesystem_reader_t *reader, int32_t index, uint32_t *timestamp, void *payload) {
+    int32_t offset = sizeof(datalog_header_t) + index * _datalog_record_size(log);
+    if (timestamp != NULL && !filesystem_read_bytes(reader, offset, timestamp, sizeof(uint32_t))) return false;
+    if (payload != NULL && !filesystem_read_bytes(reader, offset + sizeof(uint32_t), payload, log->payload_size)) return false;
+    return true;
+}
+
+static uint8_t *_datalog_buffered_record(datalog_t *log, uint8_t index) {
+    // the buffer has room for a segment header before the records; see datalog_flush.
+    return log->buffer + sizeof(datalog_header_t) + index * _datalog_record_size(log);
+}
+
+static void _datalog_unpack(datalog_t *log, uint8_t *record, uint32_t *timestamp, void *payload) {
+    if (timestamp != NULL) memcpy(timestamp, record, sizeof(uint32_t));
+    if (payload != NULL) memcpy(payload, record + sizeof(uint32_t), log->payload_size);
+}
+
+bool datalog_open(datalog_t *log) {
+    uint16_t record_size = _datalog_record_size(log);
+    log->buffer = malloc(sizeof(datalog_header_t) + log->flush_every * record_size);
+    if (log->buffer == NULL) return false;
+    log->buffered = 0;
+
+    // with nothing on the filesystem, act as if the last segment were full, so the first flush starts segment 0.
+    log->head = log->num_segments - 1;
+    log->head_count = log->records_per_segment;
+    log->sequence = 0;
+
+    for (uint8_t segment = 0; segment < log->num_segments; segment++) {
+        char filename[DATALOG_FILENAME_SIZE];
+        datalog_header_t header;
+        _datalog_filename(log, segment, filename);
+        if (!filesystem_file_exists(filename)) continue;
+        if (!filesystem_read_file(filename, (char *)&header, sizeof(header)) || header.record_size != record_size) {
+            filesystem_rm(filename);
+            continue;
+        }
+        if (header.sequence > log->sequence) {
+            log->sequence = header.sequence;
+            log->head = segment;
+            log->head_count = _datalog_segment_count(log, segment);
+        }
+    }
+
+    return true;
+}
+
+bool datalog_append(datalog_t *log, uint32_t timestamp, const void *payload) {
+    if (log->buffer == NULL) return false;
+    if (log->buffered == log->flush_every && !datalog_flush(log)) return false;
+
+    uint8_t *record = _datalog_buffered_record(log, log->buffered);
+    memcpy(record, &timestamp, sizeof(uint32_t));
+    memcpy(record + sizeof(uint32_t), payload, log->payload_size);
+    log->buffered++;
+
+    // if this write fails, the records stay in the buffer and we try again next time.
+    if (log->buffered == log->flush_every) datalog_flush(log);
+
+    return true;
+}
+
+bool datalog_flush(datalog_t *log) {
+    uint16_t record_size = _datalog_record_size(log);
+    uint8_t written = 0;
+
+    while (written < log->buffered) {
+        char filename[DATALOG_FILENAME_SIZE];
+        uint8_t *data = _datalog_buffered_record(log, written);
+        uint16_t count;
+        bool success;
+
+        if (log->head_count >= log->records_per_segment) {
+            // time to replace the oldest segment. the header goes just before the records, in the space set aside
+            // for it or over records we've already written out, so the whole segment starts with a single write.
+            uint8_t segment = (log->head + 1) % log->num_segments;
+            datalog_header_t header = { .sequence = log->sequence + 1, .record_size = record_size, .reserved = 0 };
+            count = min(log->buffered - written, log->records_per_segment);
+            data -= sizeof(header);
+            memcpy(data, &header, sizeof(header));
+            _datalog_filename(log, segment, filename);
+            success = filesystem_write_file(filename, (char *)data, sizeof(header) + count * record_size);
+            if (success) {
+                log->head = segment;
+                log->head_count = 0;
+                log->sequence++;
+            }
+        } else {
+            count = min(log->buffered - written, log->records_per_segment - log->head_count);
+            _datalog_filename(log, log->head, filename);
+            success = filesystem_append_file(filename, (char *)data, count * record_size);
+        }
+
+        if (!success) break;
+        log->head_count += count;
+        written += count;
+    }
+
+    if (written) {
+        log->buffered -= written;
+        memmove(_datalog_buffered_record(log, 0), _datalog_buffered_record(log, written), log->buffered * record_size);
+    }
+
+    return log->buffered == 0;
+}
+
+int32_t datalog_count(datalog_t *log) {
+    int32_t count = log->buffered;
+    for (uint8_t segment = 0; segment < log->num_segments; segment++) {
+        count += _datalog_segment_count(log, segment);
+    }
+
+    return count;
+}
+
+bool datalog_get(datalog_t *log, int32_t index, uint32_t *timestamp, void *payload) {
+    if (index < 0) return false;
+
+    for (uint8_t i = 0; i < log->num_segments; i++) {
+        uint8_t segment = _datalog_segment(log, i);
+        int32_t count = _datalog_segment_count(log, segment);
+        if (index < count) {
+            filesystem_reader_t reader;
+            if (!_datalog_open_segment(log, segment, &reader)) return false;
+            bool success = _datalog_read_record(log, &reader, index, timestamp, payload);
+            filesystem_close(&reader);
+            return success;
+        }
+        index -= count;
+    }
+
+    if (index >= log->buffered) return false;
+    _datalog_unpack(log, _datalog_buffered_record(log, index), timestamp, payload);
+
+    return true;
+}
+
+int32_t datalog_find(datalog_t *log, uint32_t timestamp) {
+    int32_t base = 0;
+    uint32_t record_timestamp;
+
+    for (uint8_t i = 0; i < log->num_segments; i++) {
+        uint8_t segment = _datalog_segment(log, i);
+        int32_t count = _datalog_segment_count(log, segment);
+        if (count == 0) continue;
+
+        filesystem_reader_t reader;
+        if (!_datalog_open_segment(log, segment, &reader)) return -1;
+        if (!_datalog_read_record(log, &reader, count - 1, &record_timestamp, NULL)) {
+            filesystem_close(&reader);
+            return -1;
+        }
+        if (record_timestamp < timestamp) {
+            // everything in this segment is too early.
+            filesystem_close(&reader);
+            base += count;
+            continue;
+        }
+
+        // the record is in this segment; find the first one that isn't too early.
+        int32_t low = 0;
+        int32_t high = count - 1;
+        while (low < high) {
+            int32_t middle = (low + high) / 2;
+            if (!_datalog_read_record(log, &reader, middle, &record_timestamp, NULL)) {
+                filesystem_close(&reader);
+                return -1;
+            }
+            if (record_timestamp < timestamp) low = middle + 1;
+            else high = middle;
+        }
+        filesystem_close(&reader);
+
+        return base + low;
+    }
+
+    for (uint8_t i = 0; i < log->buffered; i++) {
+        _datalog_unpack(log, _datalog_buffered_record(log, i), &record_timestamp, NULL);
+        if (record_timestamp >= timestamp) return base + i;
+    }
+
+    return base + log->buffered;
+}
+
+// calls callback for up to max_count records from index, stopping early at the first one at or after end.
+static int32_t _datalog_read(datalog_t *log, int32_t index, int32_t max_count, uint32_t end, datalog_callback_t callback, void *user_data) {
+    // one extra byte, so that a log with no payload doesn't ask for zero bytes.
+    uint8_t *payload = malloc(log->payload_size + 1);
+    if (payload == NULL) return -1;
+
+    int32_t visited = 0;
+    bool done = max_count <= 0;
+    uint32_t timestamp;
+
+    for (uint8_t i = 0; i < log->num_segments && !done; i++) {
+        uint8_t segment = _datalog_segment(log, i);
+        int32_t count = _datalog_segment_count(log, segment);
+        if (index >= count) {
+            index -= count;
+            continue;
+        }
+
+        filesystem_reader_t reader;
+        if (!_datalog_open_segment(log, segment, &reader)) {
+            visited = -1;
+            break;
+        }
+        for (; index < count && !done; index++) {
+            if (!_datalog_read_record(log, &reader, index, &timestamp, payload)) {
+                visited = -1;
+                break;
+            }
+            if (timestamp >= end) {
+                done = true;
+            } else {
+                visited++;
+                done = !callback(timestamp, payload, user_data) || visited == max_count;
+            }
+        }
+        filesystem_close(&reader);
+        if (visited < 0) break;
+        index = 0;
+    }
+
+    for (; visited >= 0 && !done && index < log->buffered; index++) {
+        _datalog_unpack(log, _datalog_buffered_record(log, index), &timestamp, payload);
+        if (timestamp >= end) break;
+        visited++;
+        done = !callback(timestamp, payload, user_data) || visited == max_count;
+    }
+
+    free(payload);
+
+    return visited;
+}
+
+int32_t datalog_read_range(datalog_t *log, uint32_t start, uint32_t end, datalog_callback_t callback, void *user_data) {
+    int32_t index = datalog_find(log, start);
+    if (index < 0) return -1;
+
+    return _datalog_read(log, index, INT32_MAX, end, callback, user_data);
+}
+
+int32_t datalog_read(datalog_t *log, int32_t index, int32_t count, datalog_callback_t callback, void *user_data) {
+    if (index < 0) return -1;
+
+    return _datalog_read(log, index, count, UINT32_MAX, callback, user_data);
+}
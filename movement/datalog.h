@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef DATALOG_H_
+#define DATALOG_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief A log of fixed-size records, kept on the filesystem in a few rotating segment files.
+  * @details Each record is a timestamp and a payload of payload_size bytes. The timestamp can be any
+  *          uint32 that goes up as time passes (a watch_date_time's reg works, and so does a UNIX time),
+  *          and records should be appended in order, since datalog_find relies on it.
+  *
+  *          New records collect in a RAM buffer and are written out flush_every at a time, so that a face
+  *          logging once a minute doesn't wear the flash by opening and writing a file every minute. The
+  *          records in the buffer are lost if the watch resets, so call datalog_flush when your face resigns,
+  *          and pick flush_every with that in mind.
+  *
+  *          Records go into files named <name>.0 through <name>.<num_segments - 1>. When the current segment
+  *          has records_per_segment records, the log moves on to the next file, replacing whatever was there;
+  *          so the log always holds at least (num_segments - 1) * records_per_segment of the newest records.
+  *
+  *          To use it, fill in the first five fields (in your face's setup, say) and call datalog_open, which
+  *          picks up any records already on the filesystem. Treat the rest of the fields as private.
+  */
+typedef struct {
+    char *name;                     // segment file names start with this; keep it short.
+    uint8_t payload_size;           // the size of each record, not counting its timestamp.
+    uint8_t num_segments;           // how many segment files to rotate through, 2 to 10.
+    uint16_t records_per_segment;   // how many records go in each segment file.
+    uint8_t flush_every;            // how many records to buffer in RAM before writing them out.
+    uint8_t head;                   // the segment we're appending to
+    uint16_t head_count;            // the number of records written to that segment
+    uint32_t sequence;              // the sequence number in that segment's header
+    uint8_t buffered;               // the number of records waiting in the buffer
+    uint8_t *buffer;
+} datalog_t;
+
+/** @brief A function to call for each record in datalog_read_range.
+  * @param timestamp the record's timestamp
+  * @param payload the record's payload; this is only valid until the function returns.
+  * @param user_data the pointer you passed to datalog_read_range
+  * @return true to keep going, or false to stop early.
+  * @note Don't touch the filesystem in this function; the segment being read is still open.
+  */
+typedef bool (*datalog_callback_t)(uint32_t timestamp, const void *payload, void *user_data);
+
+/** @brief Opens a log, finding any records that were written to it before.
+  * @details Segments that don't match the log's payload_size (say, from an older version of your face)
+  *          are deleted. This allocates the RAM buffer, so only call it once for each log.
+  * @param log the log to open, with its first five fields filled in.
+  * @return true if the log is ready; false if the buffer couldn't be allocated.
+  */
+bool datalog_open(datalog_t *log);
+
+/** @brief Adds a record to the end of the log.
+  * @param log the log
+  * @param timestamp the record's timestamp, which should be no earlier than the last one.
+  * @param payload payload_size bytes of data for the record
+  * @return true if the record was added; false if the buffer was full and couldn't be written out.
+  */
+bool datalog_append(datalog_t *log, uint32_t timestamp, const void *payload);
+
+/** @brief Writes any buffered records out to the filesystem.
+  * @param log the log
+  * @return true if the buffer is empty now; false if the write failed, in which case the records stay
+  *         in the buffer for next time.
+  */
+bool datalog_flush(datalog_t *log);
+
+/** @brief Gets the number of records in the log, including any that are still in the buffer.
+  * @param log the log
+  * @return the number of records
+  */
+int32_t datalog_count(datalog_t *log);
+
+/** @brief Reads one record from the log.
+  * @param log the log
+  * @param index the record to read, where 0 is the oldest and datalog_count(log) - 1 is the newest.
+  * @param timestamp if not NULL, set to the record's timestamp
+  * @param payload if not NULL, a buffer of payload_size bytes to read the record's payload into
+  * @return true if the record was read; false if there's no such record or the read failed.
+  */
+bool datalog_get(datalog_t *log, int32_t index, uint32_t *timestamp, void *payload);
+
+/** @brief Finds the first record at or after a given time.
+  * @details This only reads the last record of each segment and then does a binary search in the one
+  *          that has the record, so it's cheap even when the log holds weeks of data.
+  * @param log the log
+  * @param timestamp the time to look for
+  * @return the index of the oldest record whose timestamp is at least timestamp, datalog_count(log)
+  *         if there isn't one, or -1 if a read failed.
+  */
+int32_t datalog_find(datalog_t *log, uint32_t timestamp);
+
+/** @brief Calls a function for each record from start up to (but not including) end, oldest first.
+  * @details Each segment is opened once and read in order.
+  * @param log the log
+  * @param start the earliest timestamp to include
+  * @param end the first timestamp not to include
+  * @param callback the function to call for each record
+  * @param user_data passed along to callback
+  * @return the number of records passed to callback, or -1 if a read failed.
+  */
+int32_t datalog_read_range(datalog_t *log, uint32_t start, uint32_t end, datalog_callback_t callback, void *user_data);
+
+/** @brief Calls a function for up to count records, starting from the one at index, oldest first.
+  * @details This is for reading a log a piece at a time, like the shell's dump command does: pass the index you
+  *          got to last time. If records are appended in between, that's fine; but if the log moved on to a new
+  *          segment and dropped its oldest one, the indexes will have shifted down by records_per_segment.
+  * @param log the log
+  * @param index the first record to read, where 0 is the oldest.
+  * @param count the most records to read.
+  * @param callback the function to call for each record
+  * @param user_data passed along to callback
+  * @return the number of records passed to callback, which is less than count once the log runs out, or -1 if
+  *         a read failed.
+  */
+int32_t datalog_read(datalog_t *log, int32_t index, int32_t count, datalog_callback_t callback, void *user_data);
+
+#endif // DATALOG_H_
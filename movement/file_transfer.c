@@ -0,0 +1,285 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_transfer.h"
+#include "filesystem.h"
+
+// an upload is gathered here and appended to its .part file a few flash pages at a time, rather than a block at a time.
+#ifndef FILE_TRANSFER_BUFFER_SIZE
+#define FILE_TRANSFER_BUFFER_SIZE 512
+#endif
+
+#define FILE_TRANSFER_NAME_SIZE 32
+#define FILE_TRANSFER_PART_SUFFIX ".part"
+
+typedef struct {
+    char filename[FILE_TRANSFER_NAME_SIZE];
+    char part_filename[FILE_TRANSFER_NAME_SIZE + sizeof(FILE_TRANSFER_PART_SUFFIX) - 1];
+    uint32_t size;
+    uint32_t crc;
+    uint32_t received;  // including whatever is still in the buffer
+    uint16_t buffered;
+    uint8_t buffer[FILE_TRANSFER_BUFFER_SIZE];
+} file_transfer_upload_t;
+
+// only allocated while an upload is in progress.
+static file_transfer_upload_t *upload;
+
+static const char _base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// the same CRC-32 as zlib's crc32, so the other end can use whatever it has on hand. pass 0 to start.
+static uint32_t _file_transfer_crc32(uint32_t crc, const uint8_t *data, int32_t length) {
+    crc = ~crc;
+    for (int32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+static void _file_transfer_base64_encode(const uint8_t *data, int32_t length, char *text) {
+    for (int32_t i = 0; i < length; i += 3) {
+        uint32_t bits = data[i] << 16;
+        if (i + 1 < length) bits |= data[i + 1] << 8;
+        if (i + 2 < length) bits |= data[i + 2];
+        *text++ = _base64_alphabet[(bits >> 18) & 0x3F];
+        *text++ = _base64_alphabet[(bits >> 12) & 0x3F];
+        *text++ = i + 1 < length ? _base64_alphabet[(bits >> 6) & 0x3F] : '=';
+        *text++ = i + 2 < length ? _base64_alphabet[bits & 0x3F] : '=';
+    }
+    *text = 0;
+}
+
+// returns the number of bytes decoded, or -1 if the text isn't base64 or decodes to more than max_length bytes.
+static int32_t _file_transfer_base64_decode(const char *text, uint8_t *data, int32_t max_length) {
+    size_t text_length = strlen(text);
+    int32_t length = 0;
+    if (text_length % 4) return -1;
+    for (size_t i = 0; i < text_length; i += 4) {
+        uint32_t bits = 0;
+        uint8_t padding = 0;
+        for (uint8_t j = 0; j < 4; j++) {
+            const char *value = strchr(_base64_alphabet, text[i + j]);
+            if (text[i + j] == '=' && i + 4 == text_length && j >= 2) {
+                padding++;
+                bits <<= 6;
+            } else if (value != NULL && text[i + j] != 0 && padding == 0) {
+                bits = (bits << 6) | (value - _base64_alphabet);
+            } else {
+                return -1;
+            }
+        }
+        if (length + 3 - padding > max_length) return -1;
+        data[length++] = bits >> 16;
+        if (padding < 2) data[length++] = bits >> 8;
+        if (padding < 1) data[length++] = bits;
+    }
+    return length;
+}
+
+static bool _file_transfer_file_crc(char *filename, uint32_t size, uint32_t *crc) {
+    filesystem_reader_t reader;
+    uint8_t buf[64];
+    if (!filesystem_open(&reader, filename)) return false;
+    *crc = 0;
+    for (uint32_t offset = 0; offset < size; offset += sizeof(buf)) {
+        int32_t length = size - offset < sizeof(buf) ? size - offset : sizeof(buf);
+        if (!filesystem_read_bytes(&reader, offset, buf, length)) {
+            filesystem_close(&reader);
+            return false;
+        }
+        *crc = _file_transfer_crc32(*crc, buf, length);
+    }
+    filesystem_close(&reader);
+    return true;
+}
+
+static void _file_transfer_end_upload(bool keep_part) {
+    if (!keep_part && filesystem_file_exists(upload->part_filename)) filesystem_rm(upload->part_filename);
+    free(upload);
+    upload = NULL;
+}
+
+static bool _file_transfer_flush(void) {
+    if (upload->buffered == 0) return true;
+    bool success = filesystem_append_file(upload->part_filename, (char *)upload->buffer, upload->buffered);
+    upload->buffered = 0;
+    return success;
+}
+
+// once the last block is in, checks the whole file against its CRC before putting it in place.
+static void _file_transfer_finish_upload(void) {
+    uint32_t crc;
+    if (!_file_transfer_flush()) {
+        printf("err write\r\n");
+    } else if (!_file_transfer_file_crc(upload->part_filename, upload->size, &crc) || crc != upload->crc) {
+        printf("err crc\r\n");
+    } else if (!filesystem_rename(upload->part_filename, upload->filename)) {
+        printf("err write\r\n");
+    } else {
+        printf("done\r\n");
+        _file_transfer_end_upload(true);
+        return;
+    }
+    _file_transfer_end_upload(false);
+}
+
+int file_transfer_cmd_put(int argc, char *argv[]) {
+    (void) argc;
+    char *filename = argv[1];
+    uint32_t size = strtoul(argv[2], NULL, 10);
+    uint32_t crc = strtoul(argv[3], NULL, 16);
+
+    if (strchr(filename, '/') || strlen(filename) >= FILE_TRANSFER_NAME_SIZE) {
+        printf("err name\r\n");
+        return -1;
+    }
+
+    // the same upload again means the other end lost its place; tell it where we'd got to.
+    if (upload != NULL && !strcmp(upload->filename, filename) && upload->size == size && upload->crc == crc) {
+        printf("ok %lu\r\n", (unsigned long)upload->received);
+        return 0;
+    }
+
+    if (upload != NULL) _file_transfer_end_upload(false);
+    upload = malloc(sizeof(file_transfer_upload_t));
+    if (upload == NULL) {
+        printf("err memory\r\n");
+        return -1;
+    }
+    memset(upload, 0, sizeof(file_transfer_upload_t));
+    strcpy(upload->filename, filename);
+    sprintf(upload->part_filename, "%s" FILE_TRANSFER_PART_SUFFIX, filename);
+    upload->size = size;
+    upload->crc = crc;
+
+    // start from an empty file, so that a zero-length upload is complete straight away.
+    if (!filesystem_write_file(upload->part_filename, "", 0)) {
+        printf("err write\r\n");
+        _file_transfer_end_upload(false);
+        return -1;
+    }
+    if (size == 0) {
+        _file_transfer_finish_upload();
+        return 0;
+    }
+
+    printf("ok 0\r\n");
+    return 0;
+}
+
+int file_transfer_cmd_blk(int argc, char *argv[]) {
+    (void) argc;
+    uint8_t data[FILE_TRANSFER_BLOCK_SIZE];
+
+    if (upload == NULL) {
+        printf("err put\r\n");
+        return -1;
+    }
+
+    uint32_t offset = strtoul(argv[1], NULL, 10);
+    int32_t length = _file_transfer_base64_decode(argv[2], data, sizeof(data));
+    uint32_t crc = strtoul(argv[3], NULL, 16);
+
+    if (offset != upload->received) {
+        printf("err offset %lu\r\n", (unsigned long)upload->received);
+        return -1;
+    }
+    if (length <= 0 || _file_transfer_crc32(0, data, length) != crc) {
+        printf("err crc %lu\r\n", (unsigned long)upload->received);
+        return -1;
+    }
+    if (upload->received + length > upload->size) {
+        printf("err size\r\n");
+        _file_transfer_end_upload(false);
+        return -1;
+    }
+
+    for (int32_t i = 0; i < length; i++) {
+        upload->buffer[upload->buffered++] = data[i];
+        if (upload->buffered == FILE_TRANSFER_BUFFER_SIZE && !_file_transfer_flush()) {
+            printf("err write\r\n");
+            _file_transfer_end_upload(false);
+            return -1;
+        }
+    }
+    upload->received += length;
+
+    if (upload->received == upload->size) _file_transfer_finish_upload();
+    else printf("ok %lu\r\n", (unsigned long)upload->received);
+
+    return 0;
+}
+
+int file_transfer_cmd_get(int argc, char *argv[]) {
+    char *filename = argv[1];
+    int32_t size = filesystem_get_file_size(filename);
+    uint32_t crc;
+
+    if (size < 0) {
+        printf("err file\r\n");
+        return -1;
+    }
+
+    if (argc < 3) {
+        if (!_file_transfer_file_crc(filename, size, &crc)) {
+            printf("err read\r\n");
+            return -1;
+        }
+        printf("file %ld %08lx\r\n", (long)size, (unsigned long)crc);
+        return 0;
+    }
+
+    uint32_t offset = strtoul(argv[2], NULL, 10);
+    uint8_t data[FILE_TRANSFER_BLOCK_SIZE];
+    char text[(FILE_TRANSFER_BLOCK_SIZE + 2) / 3 * 4 + 1];
+    filesystem_reader_t reader;
+
+    if (offset >= (uint32_t)size) {
+        printf("err offset %ld\r\n", (long)size);
+        return -1;
+    }
+    int32_t length = size - offset < FILE_TRANSFER_BLOCK_SIZE ? size - offset : FILE_TRANSFER_BLOCK_SIZE;
+    if (!filesystem_open(&reader, filename)) {
+        printf("err read\r\n");
+        return -1;
+    }
+    bool success = filesystem_read_bytes(&reader, offset, data, length);
+    filesystem_close(&reader);
+    if (!success) {
+        printf("err read\r\n");
+        return -1;
+    }
+
+    _file_transfer_base64_encode(data, length, text);
+    printf("blk %lu %s %08lx\r\n", (unsigned long)offset, text, (unsigned long)_file_transfer_crc32(0, data, length));
+
+    return 0;
+}
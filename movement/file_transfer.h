@@ -0,0 +1,55 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef FILE_TRANSFER_H_
+#define FILE_TRANSFER_H_
+
+/** @brief Shell commands for moving whole files to and from the filesystem over USB.
+  * @details Files travel in base64 blocks of up to FILE_TRANSFER_BLOCK_SIZE bytes, one block per command, each with
+  *          its offset and a CRC-32 (the same one as zlib's crc32), so a garbled block is caught and sent again rather
+  *          than written. utils/shell_transfer.py speaks this protocol for you; every reply is one line:
+  *
+  *            put FILE SIZE CRC          start uploading FILE. replies "ok OFFSET": the number of bytes the watch
+  *                                       already has, if this is the upload it was in the middle of, or 0.
+  *            blk OFFSET DATA CRC        the next block of the upload. replies "ok OFFSET" with the new offset,
+  *                                       "done" once the whole file has arrived and matched its CRC, or
+  *                                       "err REASON [OFFSET]": carry on from OFFSET, or if there isn't one, the
+  *                                       upload has been abandoned and needs to start again with put.
+  *            get FILE                   replies "file SIZE CRC".
+  *            get FILE OFFSET            replies "blk OFFSET DATA CRC" with the block of FILE at OFFSET.
+  *
+  *          An upload is put together in FILE.part and only renamed to FILE once it's complete, so a failed upload
+  *          never leaves half a file in place of the old one.
+  */
+
+// the largest block, in bytes. 144 bytes is 192 characters of base64, which keeps a block well inside the shell's
+// 256-character command line.
+#define FILE_TRANSFER_BLOCK_SIZE 144
+
+int file_transfer_cmd_put(int argc, char *argv[]);
+int file_transfer_cmd_blk(int argc, char *argv[]);
+int file_transfer_cmd_get(int argc, char *argv[]);
+
+#endif // FILE_TRANSFER_H_
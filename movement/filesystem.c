@@ -32,6 +32,36 @@ int lfs_storage_sync(const struct lfs_config *cfg) {
     return !watch_storage_sync();
 }
 
+// littlefs's caches and wear leveling. the defaults keep RAM use to a minimum, and any of them can be overridden
+// from the build. FILESYSTEM_TUNED spends about 600 bytes more on read and program caches a whole row long, so
+// littlefs reads each row in one go instead of in page-sized pieces, and moves metadata to fresh rows less often.
+// with littlefs 2.9 or newer, it also lets files of up to a quarter row live inline in their directory's metadata
+// instead of taking a row of their own, and compacts metadata rows that are three quarters full while the watch is
+// idle, rather than when a write finds them full. littlefs_bench (`make HOST=1 bench` in movement/make) runs both
+// configurations; the tuned one stays opt-in until it has been measured against littlefs itself.
+#if FILESYSTEM_TUNED
+#define FILESYSTEM_CACHE_SIZE NVMCTRL_ROW_SIZE
+#define FILESYSTEM_BLOCK_CYCLES 500
+#define FILESYSTEM_INLINE_MAX (NVMCTRL_ROW_SIZE / 4)
+#define FILESYSTEM_COMPACT_THRESH (NVMCTRL_ROW_SIZE * 3 / 4)
+#endif
+
+#ifndef FILESYSTEM_READ_SIZE
+#define FILESYSTEM_READ_SIZE 16
+#endif
+
+#ifndef FILESYSTEM_CACHE_SIZE
+#define FILESYSTEM_CACHE_SIZE NVMCTRL_PAGE_SIZE
+#endif
+
+#ifndef FILESYSTEM_LOOKAHEAD_SIZE
+#define FILESYSTEM_LOOKAHEAD_SIZE 16
+#endif
+
+#ifndef FILESYSTEM_BLOCK_CYCLES
+#define FILESYSTEM_BLOCK_CYCLES 100
+#endif
+
 const struct lfs_config cfg = {
     // block device operations
     .read  = lfs_storage_read,
@@ -40,19 +70,29 @@ const struct lfs_config cfg = {
     .sync  = lfs_storage_sync,
 
     // block device configuration
-    .read_size = 16,
+    .read_size = FILESYSTEM_READ_SIZE,
     .prog_size = NVMCTRL_PAGE_SIZE,
     .block_size = NVMCTRL_ROW_SIZE,
     .block_count = NVMCTRL_RWWEE_PAGES / 4,
-    .cache_size = NVMCTRL_PAGE_SIZE,
-    .lookahead_size = 16,
-    .block_cycles = 100,
+    .cache_size = FILESYSTEM_CACHE_SIZE,
+    .lookahead_size = FILESYSTEM_LOOKAHEAD_SIZE,
+    .block_cycles = FILESYSTEM_BLOCK_CYCLES,
+#if defined(FILESYSTEM_INLINE_MAX) && LFS_VERSION >= 0x00020009
+    .inline_max = FILESYSTEM_INLINE_MAX,
+#endif
+#if defined(FILESYSTEM_COMPACT_THRESH) && LFS_VERSION >= 0x00020009
+    .compact_thresh = FILESYSTEM_COMPACT_THRESH,
+#endif
 };
 
 static lfs_t lfs;
 static lfs_file_t file;
 static struct lfs_info info;
 
+// counting the free space means walking every block in use, so we remember the answer until something changes
+// the filesystem. -1 means we need to count again.
+static int32_t free_space = -1;
+
 static int _traverse_df_cb(void *p, lfs_block_t block) {
     (void) block;
 	uint32_t *nb = p;
@@ -60,7 +100,7 @@ static int _traverse_df_cb(void *p, lfs_block_t block) {
 	return 0;
 }
 
-int32_t filesystem_get_free_space(void) {
+static int32_t _filesystem_count_free_space(void) {
 	int err;
 
 	uint32_t free_blocks = 0;
@@ -74,6 +114,17 @@ int32_t filesystem_get_free_space(void) {
 	return (int32_t)available;
 }
 
+int32_t filesystem_get_free_space(void) {
+    if (free_space < 0) {
+#if defined(FILESYSTEM_COMPACT_THRESH) && LFS_VERSION >= 0x00020009
+        // something changed, and Movement asks here after its background tasks, when there's time to tidy up.
+        lfs_fs_gc(&lfs);
+#endif
+        free_space = _filesystem_count_free_space();
+    }
+    return free_space;
+}
+
 static int filesystem_ls(lfs_t *lfs, const char *path) {
     lfs_dir_t dir;
     int err = lfs_dir_open(lfs, &dir, path);
@@ -134,6 +185,7 @@ int _filesystem_format(void) {
         printf("Couldn't unmount - continuing to format, but you should reboot afterwards!\r\n");
     }
 
+    free_space = -1;
     err = lfs_format(&lfs, &cfg);
     if (err < 0) return err;
 
@@ -153,6 +205,7 @@ bool filesystem_rm(char *filename) {
     info.type = 0;
     lfs_stat(&lfs, filename, &info);
     if (filesystem_file_exists(filename)) {
+        free_space = -1;
         return lfs_remove(&lfs, filename) == LFS_ERR_OK;
     } else {
         printf("rm: %s: No such file\r\n", filename);
@@ -160,6 +213,11 @@ bool filesystem_rm(char *filename) {
     }
 }
 
+bool filesystem_rename(char *old_filename, char *new_filename) {
+    free_space = -1;
+    return lfs_rename(&lfs, old_filename, new_filename) == LFS_ERR_OK;
+}
+
 int32_t filesystem_get_file_size(char *filename) {
     if (filesystem_file_exists(filename)) {
         return info.size; // info struct was just populated by filesystem_file_exists
@@ -205,25 +263,69 @@ bool filesystem_read_line(char *filename, char *buf, int32_t *offset, int32_t le
     return false;
 }
 
-static void filesystem_cat(char *filename) {
-    info.type = 0;
-    lfs_stat(&lfs, filename, &info);
-    if (filesystem_file_exists(filename)) {
-        if (info.size > 0) {
-            char *buf = malloc(info.size + 1);
-            filesystem_read_file(filename, buf, info.size);
-            buf[info.size] = '\0';
-            printf("%s\r\n", buf);
-            free(buf);
-        } else {
-            printf("\r\n");
+bool filesystem_open(filesystem_reader_t *reader, char *filename) {
+    reader->offset = 0;
+    reader->start = 0;
+    reader->end = 0;
+    return lfs_file_open(&lfs, &reader->file, filename, LFS_O_RDONLY) == LFS_ERR_OK;
+}
+
+bool filesystem_next_line(filesystem_reader_t *reader, char *buf, int32_t length) {
+    int32_t line_length = 0;
+    bool read_anything = false;
+
+    while (true) {
+        if (reader->start == reader->end) {
+            lfs_ssize_t bytes_read = lfs_file_read(&lfs, &reader->file, reader->buf, sizeof(reader->buf));
+            if (bytes_read < 0) return false;
+            if (bytes_read == 0) break;
+            reader->start = 0;
+            reader->end = bytes_read;
         }
-    } else {
-        printf("cat: %s: No such file\r\n", filename);
+
+        char c = reader->buf[reader->start++];
+        reader->offset++;
+        read_anything = true;
+        if (c == '\n') break;
+        if (line_length < length - 1) buf[line_length++] = c;
     }
+
+    buf[line_length] = 0;
+    return read_anything;
+}
+
+bool filesystem_read_bytes(filesystem_reader_t *reader, int32_t offset, void *buf, int32_t length) {
+    reader->start = 0;
+    reader->end = 0;
+    if (lfs_file_seek(&lfs, &reader->file, offset, LFS_SEEK_SET) < 0) return false;
+    lfs_ssize_t bytes_read = lfs_file_read(&lfs, &reader->file, buf, length);
+    if (bytes_read < 0) return false;
+    reader->offset = offset + bytes_read;
+    return bytes_read == length;
+}
+
+int32_t filesystem_read(filesystem_reader_t *reader, void *buf, int32_t length) {
+    // anything filesystem_next_line read ahead comes first.
+    int32_t buffered = reader->end - reader->start;
+    if (buffered > length) buffered = length;
+    memcpy(buf, &reader->buf[reader->start], buffered);
+    reader->start += buffered;
+
+    lfs_ssize_t bytes_read = 0;
+    if (buffered < length) {
+        bytes_read = lfs_file_read(&lfs, &reader->file, (uint8_t *)buf + buffered, length - buffered);
+        if (bytes_read < 0) return -1;
+    }
+    reader->offset += buffered + bytes_read;
+    return buffered + bytes_read;
+}
+
+void filesystem_close(filesystem_reader_t *reader) {
+    lfs_file_close(&lfs, &reader->file);
 }
 
 bool filesystem_write_file(char *filename, char *text, int32_t length) {
+    free_space = -1;
     int err = lfs_file_open(&lfs, &file, filename, LFS_O_RDWR | LFS_O_CREAT | LFS_O_TRUNC);
     if (err < 0) return false;
     err = lfs_file_write(&lfs, &file, text, length);
@@ -232,6 +334,7 @@ bool filesystem_write_file(char *filename, char *text, int32_t length) {
 }
 
 bool filesystem_append_file(char *filename, char *text, int32_t length) {
+    free_space = -1;
     int err = lfs_file_open(&lfs, &file, filename, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
     if (err < 0) return false;
     err = lfs_file_write(&lfs, &file, text, length);
@@ -248,12 +351,6 @@ int filesystem_cmd_ls(int argc, char *argv[]) {
     return 0;
 }
 
-int filesystem_cmd_cat(int argc, char *argv[]) {
-    (void) argc;
-    filesystem_cat(argv[1]);
-    return 0;
-}
-
 int filesystem_cmd_df(int argc, char *argv[]) {
     (void) argc;
     (void) argv;
@@ -27,6 +27,24 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "watch.h"
+#include "lfs.h"
+
+// the size of the read buffer in each filesystem_reader_t, up to 255 bytes.
+#ifndef FILESYSTEM_READER_BUFFER_SIZE
+#define FILESYSTEM_READER_BUFFER_SIZE 64
+#endif
+
+/** @brief A file that's open for reading a line at a time. See filesystem_open.
+  * @details offset is the position in the file of the next line to be read; you can note it before
+  *          calling filesystem_next_line to learn where a line began. Treat the rest as private.
+  */
+typedef struct {
+    lfs_file_t file;
+    int32_t offset;
+    char buf[FILESYSTEM_READER_BUFFER_SIZE];
+    uint8_t start;
+    uint8_t end;
+} filesystem_reader_t;
 
 /** @brief Initializes and mounts the tiny 8kb filesystem, formatting it if need be.
   * @return true if the filesystem was mounted successfully.
@@ -34,6 +52,8 @@
 bool filesystem_init(void);
 
 /** @brief Gets the space available on the filesystem.
+  * @details Counting the free space means walking every block in use, so the answer is kept until a file is
+  *          written or removed. Movement counts again in the background after that, so this is usually quick.
   * @return the free space in bytes
   */
 int32_t filesystem_get_free_space(void);
@@ -50,6 +70,13 @@ bool filesystem_file_exists(char *filename);
   */
 bool filesystem_rm(char *filename);
 
+/** @brief Renames a file, replacing any file that already has the new name.
+  * @param old_filename the file's current name
+  * @param new_filename the name to give it
+  * @return true if the file was renamed; false otherwise
+  */
+bool filesystem_rename(char *old_filename, char *new_filename);
+
 /** @brief Gets the size of a file on the filesystem.
   * @param filename the file whose size you wish to determine
   * @return the file's size in bytes, or -1 if the file does not exist.
@@ -80,6 +107,48 @@ bool filesystem_read_file(char *filename, char *buf, int32_t length);
   */
 bool filesystem_read_line(char *filename, char *buf, int32_t *offset, int32_t length);
 
+/** @brief Opens a file for reading line by line.
+  * @details Unlike filesystem_read_line, which opens the file and seeks to the offset for every line it
+  *          reads, this opens the file once and reads through it in order. Use it when you want to read
+  *          more than a line or two, and call filesystem_close when you're done.
+  * @param reader the reader to set up; it holds the open file and a small read buffer.
+  * @param filename the file you wish to read
+  * @return true if the file was opened; false otherwise
+  */
+bool filesystem_open(filesystem_reader_t *reader, char *filename);
+
+/** @brief Reads the next line of a file opened with filesystem_open.
+  * @param reader the reader for the open file
+  * @param buf A buffer of at least length bytes; the line will be read into this buffer without its
+  *            newline, and null-terminated. If the line doesn't fit, the rest of it is skipped.
+  * @param length The size of buf
+  * @return true if a line was read; false at the end of the file or if the read failed
+  */
+bool filesystem_next_line(filesystem_reader_t *reader, char *buf, int32_t length);
+
+/** @brief Reads bytes from a file opened with filesystem_open.
+  * @param reader the reader for the open file
+  * @param offset the position in the file to read from
+  * @param buf A buffer of at least length bytes
+  * @param length The number of bytes to read
+  * @return true if length bytes were read; false if the file ended first or the read failed
+  * @note This moves the reader; if you go back to reading lines, they start after these bytes.
+  */
+bool filesystem_read_bytes(filesystem_reader_t *reader, int32_t offset, void *buf, int32_t length);
+
+/** @brief Reads the next bytes of a file opened with filesystem_open.
+  * @param reader the reader for the open file
+  * @param buf A buffer of at least length bytes
+  * @param length The most bytes to read
+  * @return the number of bytes read, which is less than length at the end of the file, or -1 if the read failed
+  */
+int32_t filesystem_read(filesystem_reader_t *reader, void *buf, int32_t length);
+
+/** @brief Closes a file opened with filesystem_open.
+  * @param reader the reader for the open file
+  */
+void filesystem_close(filesystem_reader_t *reader);
+
 /** @brief Writes file to the filesystem
   * @param filename the file you wish to write
   * @param text The contents of the file
@@ -97,7 +166,6 @@ bool filesystem_write_file(char *filename, char *text, int32_t length);
 bool filesystem_append_file(char *filename, char *text, int32_t length);
 
 int filesystem_cmd_ls(int argc, char *argv[]);
-int filesystem_cmd_cat(int argc, char *argv[]);
 int filesystem_cmd_df(int argc, char *argv[]);
 int filesystem_cmd_rm(int argc, char *argv[]);
 int filesystem_cmd_format(int argc, char *argv[]);
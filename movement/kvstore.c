@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+#include "kvstore.h"
+#include "filesystem.h"
+
+#define KVSTORE_FILENAME "kvstore.bin"
+
+typedef enum {
+    KVSTORE_TYPE_DELETED = 0,
+    KVSTORE_TYPE_BLOB,
+    KVSTORE_TYPE_UINT32,
+    KVSTORE_TYPE_INT32,
+    KVSTORE_TYPE_FLOAT,
+} kvstore_type_t;
+
+// records are the same in RAM as in the file. the key isn't null-terminated if it's KVSTORE_KEY_SIZE long.
+typedef struct {
+    char key[KVSTORE_KEY_SIZE];
+    uint8_t type;
+    uint8_t length;
+    uint8_t value[KVSTORE_VALUE_SIZE];
+    uint16_t crc;
+} kvstore_record_t;
+
+static kvstore_record_t records[KVSTORE_MAX_KEYS];
+static uint8_t num_records;
+static uint16_t records_in_file;
+
+// CRC-16/CCITT of everything but the CRC itself.
+static uint16_t _kvstore_crc(const kvstore_record_t *record) {
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < offsetof(kvstore_record_t, crc); i++) {
+        crc ^= bytes[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+static kvstore_record_t *_kvstore_find(const char *key) {
+    if (strlen(key) > KVSTORE_KEY_SIZE) return NULL;
+    for (uint8_t i = 0; i < num_records; i++) {
+        if (strncmp(records[i].key, key, KVSTORE_KEY_SIZE) == 0) return &records[i];
+    }
+
+    return NULL;
+}
+
+// updates the cache with a record, as read from the file or about to be written to it.
+static bool _kvstore_apply(const kvstore_record_t *record) {
+    kvstore_record_t *existing = _kvstore_find(record->key);
+    if (record->type == KVSTORE_TYPE_DELETED) {
+        if (existing != NULL) *existing = records[--num_records];
+    } else if (existing != NULL) {
+        *existing = *record;
+    } else if (num_records < KVSTORE_MAX_KEYS) {
+        records[num_records++] = *record;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+static bool _kvstore_compact(void) {
+    // littlefs swaps in a file's new contents all at once when it's closed, so if this write doesn't make it, the
+    // old file is still there.
+    if (!filesystem_write_file(KVSTORE_FILENAME, (char *)records, num_records * sizeof(kvstore_record_t))) return false;
+    records_in_file = num_records;
+
+    return true;
+}
+
+static bool _kvstore_set(const char *key, kvstore_type_t type, const void *value, uint8_t length) {
+    size_t key_length = strlen(key);
+    if (key_length == 0 || key_length > KVSTORE_KEY_SIZE || length > KVSTORE_VALUE_SIZE) return false;
+
+    kvstore_record_t record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.key, key, key_length);
+    record.type = type;
+    record.length = length;
+    if (length) memcpy(record.value, value, length);
+    record.crc = _kvstore_crc(&record);
+
+    // don't wear the flash writing down what's already there.
+    kvstore_record_t *existing = _kvstore_find(key);
+    if (existing == NULL && type == KVSTORE_TYPE_DELETED) return true;
+    if (existing != NULL && memcmp(existing, &record, sizeof(record)) == 0) return true;
+
+    // compacting writes out the cache, so the change goes there first, and comes back out if the write fails.
+    // a deleted record's slot gets the last one, which is still in its old slot too, so putting back the record
+    // and the count undoes any change.
+    kvstore_record_t previous;
+    uint8_t previous_count = num_records;
+    if (existing != NULL) previous = *existing;
+    if (!_kvstore_apply(&record)) return false;
+
+    if (records_in_file >= num_records + KVSTORE_MAX_KEYS) {
+        if (_kvstore_compact()) return true;
+    } else if (filesystem_append_file(KVSTORE_FILENAME, (char *)&record, sizeof(record))) {
+        records_in_file++;
+        return true;
+    }
+
+    if (existing != NULL) *existing = previous;
+    num_records = previous_count;
+
+    return false;
+}
+
+static bool _kvstore_get(const char *key, kvstore_type_t type, void *value, uint8_t length) {
+    kvstore_record_t *record = _kvstore_find(key);
+    if (record == NULL || record->type != type || record->length != length) return false;
+    memcpy(value, record->value, length);
+
+    return true;
+}
+
+bool kvstore_init(void) {
+    filesystem_reader_t reader;
+    kvstore_record_t record;
+    bool damaged = false;
+
+    num_records = 0;
+    records_in_file = 0;
+
+    int32_t file_size = filesystem_get_file_size(KVSTORE_FILENAME);
+    if (file_size <= 0) return true;
+    if (!filesystem_open(&reader, KVSTORE_FILENAME)) return false;
+
+    while (filesystem_read_bytes(&reader, records_in_file * sizeof(record), &record, sizeof(record))) {
+        records_in_file++;
+        // a record that fails its CRC, or that doesn't fit, is lost; the rest are fine.
+        if (record.crc != _kvstore_crc(&record) || !_kvstore_apply(&record)) damaged = true;
+    }
+    filesystem_close(&reader);
+
+    // a partial record at the end would throw off every record appended after it, so start the file over.
+    if (damaged || file_size % sizeof(record)) {
+        _kvstore_compact();
+        return false;
+    }
+
+    return true;
+}
+
+bool kvstore_get_uint32(const char *key, uint32_t *value) {
+    return _kvstore_get(key, KVSTORE_TYPE_UINT32, value, sizeof(uint32_t));
+}
+
+bool kvstore_set_uint32(const char *key, uint32_t value) {
+    return _kvstore_set(key, KVSTORE_TYPE_UINT32, &value, sizeof(uint32_t));
+}
+
+bool kvstore_get_int32(const char *key, int32_t *value) {
+    return _kvstore_get(key, KVSTORE_TYPE_INT32, value, sizeof(int32_t));
+}
+
+bool kvstore_set_int32(const char *key, int32_t value) {
+    return _kvstore_set(key, KVSTORE_TYPE_INT32, &value, sizeof(int32_t));
+}
+
+bool kvstore_get_float(const char *key, float *value) {
+    return _kvstore_get(key, KVSTORE_TYPE_FLOAT, value, sizeof(float));
+}
+
+bool kvstore_set_float(const char *key, float value) {
+    return _kvstore_set(key, KVSTORE_TYPE_FLOAT, &value, sizeof(float));
+}
+
+bool kvstore_get_blob(const char *key, void *value, uint8_t length) {
+    return _kvstore_get(key, KVSTORE_TYPE_BLOB, value, length);
+}
+
+bool kvstore_set_blob(const char *key, const void *value, uint8_t length) {
+    return _kvstore_set(key, KVSTORE_TYPE_BLOB, value, length);
+}
+
+bool kvstore_delete(const char *key) {
+    return _kvstore_set(key, KVSTORE_TYPE_DELETED, NULL, 0);
+}
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef KVSTORE_H_
+#define KVSTORE_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief A small key-value store for settings, kept in a file on the filesystem.
+  * @details Faces that need to remember a few settings across a reset can keep them here, instead of claiming one
+  *          of the RTC's backup registers or writing a file of their own. Each value lives under a short key (up to
+  *          KVSTORE_KEY_SIZE characters; prefix it with your face's name, and its index if there can be more than
+  *          one of it) and holds up to KVSTORE_VALUE_SIZE bytes.
+  *
+  *          Every value is cached in RAM, so reads never touch the flash. Changing a value appends a 32-byte record
+  *          to kvstore.bin; setting a value to what it already is writes nothing, so it's fine to save every time
+  *          your face resigns. Each record has a CRC, so a damaged one is skipped rather than read as garbage, and
+  *          when the file has grown to hold KVSTORE_MAX_KEYS records more than there are keys, it's rewritten
+  *          with just the current values.
+  */
+
+#define KVSTORE_KEY_SIZE 8
+#define KVSTORE_VALUE_SIZE 20
+
+// the most keys the store can hold. each one takes 32 bytes of RAM.
+#ifndef KVSTORE_MAX_KEYS
+#define KVSTORE_MAX_KEYS 16
+#endif
+
+/** @brief Loads the store from the filesystem. Movement calls this at startup, after mounting the filesystem.
+  * @return true if the store was loaded (or there was nothing to load); false if its file was damaged. Any values
+  *         that could be read are still available.
+  */
+bool kvstore_init(void);
+
+/** @brief Gets an unsigned integer from the store.
+  * @param key the value's key
+  * @param value set to the stored value, if there is one
+  * @return true if the key holds an unsigned integer; false otherwise, in which case value is left alone.
+  */
+bool kvstore_get_uint32(const char *key, uint32_t *value);
+
+/** @brief Stores an unsigned integer.
+  * @param key the value's key
+  * @param value the value to store
+  * @return true if the value was stored; false if the key is too long, the store is full, or the write failed.
+  */
+bool kvstore_set_uint32(const char *key, uint32_t value);
+
+/// @brief Like kvstore_get_uint32, for signed integers.
+bool kvstore_get_int32(const char *key, int32_t *value);
+
+/// @brief Like kvstore_set_uint32, for signed integers.
+bool kvstore_set_int32(const char *key, int32_t value);
+
+/// @brief Like kvstore_get_uint32, for floats.
+bool kvstore_get_float(const char *key, float *value);
+
+/// @brief Like kvstore_set_uint32, for floats.
+bool kvstore_set_float(const char *key, float value);
+
+/** @brief Gets a block of bytes (say, a struct of settings) from the store.
+  * @param key the value's key
+  * @param value a buffer of length bytes to read the value into
+  * @param length the size of the value you expect
+  * @return true if the key holds a block of exactly length bytes; false otherwise, in which case value is left
+  *         alone. This way, if your struct changes size, you get your defaults rather than a mangled struct.
+  */
+bool kvstore_get_blob(const char *key, void *value, uint8_t length);
+
+/** @brief Stores a block of bytes.
+  * @param key the value's key
+  * @param value the bytes to store
+  * @param length how many bytes to store, up to KVSTORE_VALUE_SIZE
+  * @return true if the value was stored; false if it's too long, the key is too long, the store is full, or the
+  *         write failed.
+  */
+bool kvstore_set_blob(const char *key, const void *value, uint8_t length);
+
+/** @brief Removes a key and its value from the store.
+  * @param key the key to remove
+  * @return true if the key is gone; false if the write failed.
+  */
+bool kvstore_delete(const char *key);
+
+#endif // KVSTORE_H_
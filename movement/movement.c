@@ -31,9 +31,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "watch.h"
+#include "watch_utility.h"
 #include "filesystem.h"
+#include "kvstore.h"
 #include "movement.h"
 #include "shell.h"
+#include "movement_accelerometer.h"
 
 #ifndef MOVEMENT_FIRMWARE
 #include "movement_config.h"
@@ -95,16 +98,75 @@
 #define MOVEMENT_DEFAULT_LED_DURATION 1
 #endif
 
+// Size of the queue between the interrupt callbacks and app_loop. Must be a power of two no larger than 128.
+#ifndef MOVEMENT_EVENT_QUEUE_SIZE
+#define MOVEMENT_EVENT_QUEUE_SIZE 16
+#endif
+
+// Number of background timers that can be pending at once, across all watch faces. Must be less than 255.
+#ifndef MOVEMENT_MAX_TIMERS
+#define MOVEMENT_MAX_TIMERS (MOVEMENT_NUM_FACES + 8)
+#endif
+
+#define MOVEMENT_TIMER_NOT_SCHEDULED 0xFF
+
+#define MOVEMENT_FACE_MASK_WORDS ((MOVEMENT_NUM_FACES + 31) / 32)
+
 #if __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
 movement_state_t movement_state;
 void * watch_face_contexts[MOVEMENT_NUM_FACES];
-watch_date_time scheduled_tasks[MOVEMENT_NUM_FACES];
 const int32_t movement_le_inactivity_deadlines[8] = {INT_MAX, 600, 3600, 7200, 21600, 43200, 86400, 604800};
 const int16_t movement_timeout_inactivity_deadlines[4] = {60, 120, 300, 1800};
-movement_event_t event;
+
+// Events generated by the button, tick and fast tick callbacks land in this ring buffer, and app_loop drains
+// them in order. The callbacks are the only writers of head and app_loop is the only writer of tail, so no
+// locking is needed as long as the callbacks don't preempt one another (they all run at the same priority).
+typedef struct {
+    movement_event_t events[MOVEMENT_EVENT_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+} movement_event_queue_t;
+
+static movement_event_queue_t event_queue;
+
+// Background timers live in a binary min-heap ordered by due time, so the next one due is always timers[0].
+// timer_positions maps each face's timer IDs to their index in the heap, so a timer can be found without a search.
+typedef struct {
+    uint32_t timestamp;
+    uint8_t watch_face_index;
+    uint8_t timer_id;
+} movement_timer_t;
+
+static movement_timer_t timers[MOVEMENT_MAX_TIMERS];
+static uint8_t num_timers;
+static uint8_t timer_positions[MOVEMENT_NUM_FACES][MOVEMENT_TIMERS_PER_FACE];
+
+// For each background cadence, a bitmask of the faces that asked for it, so that at the top of the minute we only
+// call wants_background_task on the faces that are due.
+static uint32_t background_masks[MOVEMENT_NUM_BACKGROUND_CADENCES][MOVEMENT_FACE_MASK_WORDS];
+static struct {
+    uint8_t hour;
+    uint8_t minute;
+} background_times[MOVEMENT_NUM_FACES];
+
+// the faces that registered a log for the shell's dump command.
+static watch_face_export exports[MOVEMENT_NUM_FACES];
+
+// EVENT_ACTIVATE is generated from the main loop rather than an interrupt, so it doesn't go through the queue.
+static bool activate_pending;
+
+#if __EMSCRIPTEN__ || WATCH_HOST
+// the simulator and host builds keep count of how often we wake from standby, which shows what tickless mode buys us.
+static uint32_t wakeups_this_hour;
+static uint8_t wakeup_hour;
+// ...and how many background checks we make each day, compared to polling every face every minute.
+static uint32_t background_checks_today;
+static uint32_t background_polls_today;
+static uint8_t background_stats_day;
+#endif
 
 const int16_t movement_timezone_offsets[] = {
     0,      //  0 :   0:00:00 (UTC)
@@ -158,12 +220,120 @@ void cb_light_btn_interrupt(void);
 void cb_alarm_btn_interrupt(void);
 void cb_alarm_btn_extwake(void);
 void cb_alarm_fired(void);
+void cb_timer_alarm_fired(void);
 void cb_fast_tick(void);
 void cb_tick(void);
 
+static void _movement_queue_event(movement_event_type_t event_type) {
+    uint8_t head = event_queue.head;
+    uint8_t pending = head - event_queue.tail;
+
+    // if the most recent event is a tick that app_loop hasn't gotten to yet, just bring its subsecond up to date.
+    // we only do this when it isn't the oldest pending event, since app_loop may be reading that one right now.
+    if (event_type == EVENT_TICK && pending > 1) {
+        movement_event_t *last = &event_queue.events[(uint8_t)(head - 1) % MOVEMENT_EVENT_QUEUE_SIZE];
+        if (last->event_type == EVENT_TICK) {
+            last->subsecond = movement_state.subsecond;
+            return;
+        }
+    }
+
+    // if the queue is full, drop the event. with app_loop draining the whole queue on every wake, this should
+    // only happen if a watch face blocks for a very long time.
+    if (pending >= MOVEMENT_EVENT_QUEUE_SIZE) return;
+
+    event_queue.events[head % MOVEMENT_EVENT_QUEUE_SIZE].event_type = event_type;
+    event_queue.events[head % MOVEMENT_EVENT_QUEUE_SIZE].subsecond = movement_state.subsecond;
+    event_queue.head = head + 1;
+}
+
+static bool _movement_dequeue_event(movement_event_t *event) {
+    uint8_t tail = event_queue.tail;
+    if (tail == event_queue.head) return false;
+    *event = event_queue.events[tail % MOVEMENT_EVENT_QUEUE_SIZE];
+    event_queue.tail = tail + 1;
+    return true;
+}
+
+static bool _movement_tick_is_pending(void) {
+    for(uint8_t i = event_queue.tail; i != event_queue.head; i++) {
+        if (event_queue.events[i % MOVEMENT_EVENT_QUEUE_SIZE].event_type == EVENT_TICK) return true;
+    }
+    return false;
+}
+
+static inline void _movement_flush_events(void) {
+    event_queue.tail = event_queue.head;
+}
+
+static inline uint32_t _movement_timestamp(watch_date_time date_time) {
+    return watch_utility_date_time_to_unix_time(date_time, 0);
+}
+
+static watch_date_time _movement_top_of_next_minute(watch_date_time date_time) {
+    date_time.unit.second = 0;
+    return watch_utility_date_time_from_unix_time(_movement_timestamp(date_time) + 60, 0);
+}
+
 static inline void _movement_reset_inactivity_countdown(void) {
     movement_state.le_mode_ticks = movement_le_inactivity_deadlines[movement_state.settings.bit.le_interval];
     movement_state.timeout_ticks = movement_timeout_inactivity_deadlines[movement_state.settings.bit.to_interval];
+    // in tickless mode, the countdowns are measured from this timestamp instead of being decremented by the tick.
+    if (movement_state.tickless) movement_state.countdown_timestamp = _movement_timestamp(watch_rtc_get_date_time());
+}
+
+static void _movement_update_tickless_countdowns(uint32_t now) {
+    if (now <= movement_state.countdown_timestamp) return;
+    int32_t elapsed = now - movement_state.countdown_timestamp;
+    if (movement_state.settings.bit.le_interval && movement_state.le_mode_ticks > 0) {
+        movement_state.le_mode_ticks = max(movement_state.le_mode_ticks - elapsed, 0);
+    }
+    if (movement_state.timeout_ticks > 0) {
+        movement_state.timeout_ticks = max(movement_state.timeout_ticks - elapsed, 0);
+    }
+    movement_state.countdown_timestamp = now;
+}
+
+static void _movement_register_minute_alarm(void) {
+    // set up the 1 minute alarm (for background tasks and low power updates)
+    watch_date_time alarm_time;
+    alarm_time.reg = 0;
+    alarm_time.unit.second = 59; // after a match, the alarm fires at the next rising edge of CLK_RTC_CNT, so 59 seconds lets us update at :00
+    watch_rtc_register_alarm_callback(cb_alarm_fired, alarm_time, ALARM_MATCH_SS);
+}
+
+static void _movement_disable_tickless(void) {
+    _movement_update_tickless_countdowns(_movement_timestamp(watch_rtc_get_date_time()));
+    movement_state.tickless = false;
+    movement_state.tickless_alarm = 0;
+    _movement_register_minute_alarm();
+}
+
+static void _movement_schedule_tickless_wake(void) {
+    watch_date_time date_time = watch_rtc_get_date_time();
+    uint32_t now = _movement_timestamp(date_time);
+
+    // we always wake at the top of the minute, since that's when background tasks run...
+    uint32_t deadline = _movement_timestamp(_movement_top_of_next_minute(date_time));
+    // ...but we may need to wake sooner for a redraw,
+    deadline = min(deadline, _movement_timestamp(movement_state.next_redraw));
+    // a scheduled background task,
+    if (num_timers) deadline = min(deadline, timers[0].timestamp);
+    // or the end of one of our inactivity countdowns.
+    if (movement_state.settings.bit.le_interval && movement_state.le_mode_ticks > 0) {
+        deadline = min(deadline, movement_state.countdown_timestamp + movement_state.le_mode_ticks);
+    }
+    if (movement_state.timeout_ticks > 0) {
+        deadline = min(deadline, movement_state.countdown_timestamp + movement_state.timeout_ticks);
+    }
+
+    // the alarm fires one second after it matches, and it can't match a time that's already here.
+    if (deadline < now + 2) deadline = now + 2;
+    // if the alarm we already set fires sooner, leave it alone. otherwise, if something else kept waking us,
+    // we'd push an overdue deadline out to now + 2 every time, and the alarm would never fire.
+    if (movement_state.tickless_alarm > now && movement_state.tickless_alarm <= deadline) return;
+    movement_state.tickless_alarm = deadline;
+    watch_rtc_register_alarm_callback(cb_alarm_fired, watch_utility_date_time_from_unix_time(deadline - 1, 0), ALARM_MATCH_YYMMDDHHMMSS);
 }
 
 static inline void _movement_enable_fast_tick_if_needed(void) {
@@ -184,44 +354,136 @@ static inline void _movement_disable_fast_tick_if_possible(void) {
 }
 
 static void _movement_handle_background_tasks(void) {
-    for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
-        // For each face, if the watch face wants a background task...
-        if (watch_faces[i].wants_background_task != NULL && watch_faces[i].wants_background_task(&movement_state.settings, watch_face_contexts[i])) {
-            // ...we give it one. pretty straightforward!
-            movement_event_t background_event = { EVENT_BACKGROUND_TASK, 0 };
-            watch_faces[i].loop(background_event, &movement_state.settings, watch_face_contexts[i]);
-        }
+    watch_date_time date_time = watch_rtc_get_date_time();
+
+#if __EMSCRIPTEN__ || WATCH_HOST
+    if (date_time.unit.day != background_stats_day) {
+        printf("%lu background checks today (%lu if polling every face every minute)\n", background_checks_today, background_polls_today);
+        background_checks_today = 0;
+        background_polls_today = 0;
+        background_stats_day = date_time.unit.day;
     }
-    movement_state.needs_background_tasks_handled = false;
-}
+#endif
 
-static void _movement_handle_scheduled_tasks(void) {
-    watch_date_time date_time = watch_rtc_get_date_time();
-    uint8_t num_active_tasks = 0;
+    for(uint8_t word = 0; word < MOVEMENT_FACE_MASK_WORDS; word++) {
+        uint32_t due = background_masks[MOVEMENT_BACKGROUND_EVERY_MINUTE][word];
+        uint32_t hourly = background_masks[MOVEMENT_BACKGROUND_HOURLY][word];
+        uint32_t daily = background_masks[MOVEMENT_BACKGROUND_DAILY][word];
 
-    for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
-        if (scheduled_tasks[i].reg) {
-            if (scheduled_tasks[i].reg <= date_time.reg) {
-                scheduled_tasks[i].reg = 0;
+#if __EMSCRIPTEN__ || WATCH_HOST
+        background_polls_today += __builtin_popcount(due | hourly | daily);
+#endif
+
+        // faces on the hourly and daily cadences are only due when the clock matches their time.
+        for (uint32_t candidates = hourly | daily; candidates; candidates &= candidates - 1) {
+            uint8_t bit = __builtin_ctz(candidates);
+            uint8_t i = word * 32 + bit;
+            if (background_times[i].minute != date_time.unit.minute) continue;
+            if ((daily & (1ul << bit)) && background_times[i].hour != date_time.unit.hour) continue;
+            due |= 1ul << bit;
+        }
+
+        for (; due; due &= due - 1) {
+            uint8_t i = word * 32 + __builtin_ctz(due);
+#if __EMSCRIPTEN__ || WATCH_HOST
+            background_checks_today++;
+#endif
+            // For each watch face that is due, if the watch face wants a background task...
+            if (watch_faces[i].wants_background_task(&movement_state.settings, watch_face_contexts[i])) {
+                // ...we give it one. pretty straightforward!
                 movement_event_t background_event = { EVENT_BACKGROUND_TASK, 0 };
                 watch_faces[i].loop(background_event, &movement_state.settings, watch_face_contexts[i]);
-                // check if loop scheduled a new task
-                if (scheduled_tasks[i].reg) {
-                    num_active_tasks++;
-                }
-            } else {
-                num_active_tasks++;
             }
         }
     }
 
-    if (num_active_tasks == 0) {
+    // if anything wrote to the filesystem, count its free space now, so that a face asking later gets an answer
+    // without waiting for the count.
+    filesystem_get_free_space();
+
+    movement_state.needs_background_tasks_handled = false;
+}
+
+static inline void _movement_place_timer(uint8_t position, movement_timer_t timer) {
+    timers[position] = timer;
+    timer_positions[timer.watch_face_index][timer.timer_id] = position;
+}
+
+static void _movement_sift_timer_up(uint8_t position) {
+    movement_timer_t timer = timers[position];
+    while (position > 0) {
+        uint8_t parent = (position - 1) / 2;
+        if (timers[parent].timestamp <= timer.timestamp) break;
+        _movement_place_timer(position, timers[parent]);
+        position = parent;
+    }
+    _movement_place_timer(position, timer);
+}
+
+static void _movement_sift_timer_down(uint8_t position) {
+    movement_timer_t timer = timers[position];
+    while (true) {
+        uint16_t child = 2 * position + 1;
+        if (child >= num_timers) break;
+        if (child + 1 < num_timers && timers[child + 1].timestamp < timers[child].timestamp) child++;
+        if (timer.timestamp <= timers[child].timestamp) break;
+        _movement_place_timer(position, timers[child]);
+        position = child;
+    }
+    _movement_place_timer(position, timer);
+}
+
+static void _movement_remove_timer(uint8_t position) {
+    movement_timer_t removed = timers[position];
+    timer_positions[removed.watch_face_index][removed.timer_id] = MOVEMENT_TIMER_NOT_SCHEDULED;
+    num_timers--;
+    if (position == num_timers) return;
+
+    // move the last timer into the hole, then let it find its place, which may be in either direction.
+    movement_timer_t moved = timers[num_timers];
+    _movement_place_timer(position, moved);
+    _movement_sift_timer_down(position);
+    _movement_sift_timer_up(timer_positions[moved.watch_face_index][moved.timer_id]);
+}
+
+static void _movement_handle_scheduled_tasks(void) {
+    uint32_t now = _movement_timestamp(watch_rtc_get_date_time());
+
+    // the heap keeps the next timer due at the top, so we only ever look past it when it has fired.
+    while (num_timers && timers[0].timestamp <= now) {
+        movement_timer_t timer = timers[0];
+        // remove the timer before invoking the face, since its loop may well schedule it again.
+        _movement_remove_timer(0);
+        movement_event_t background_event = { EVENT_BACKGROUND_TASK, timer.timer_id };
+        watch_faces[timer.watch_face_index].loop(background_event, &movement_state.settings, watch_face_contexts[timer.watch_face_index]);
+    }
+
+    if (num_timers == 0) {
         movement_state.has_scheduled_background_task = false;
-    } else {
+    } else if (movement_state.le_mode_ticks != -1 && timers[0].timestamp < now + 60) {
+        // a timer that's about to fire shouldn't find the watch gone to sleep or moved on from its face.
         _movement_reset_inactivity_countdown();
     }
 }
 
+// in low energy mode, the minute alarm wakes us at the top of every minute. a timer that comes due before then
+// borrows the alarm, and gives it back once it has fired.
+static void _movement_schedule_sleep_wake(void) {
+    watch_date_time date_time = watch_rtc_get_date_time();
+    uint32_t now = _movement_timestamp(date_time);
+    uint32_t next_minute = _movement_timestamp(_movement_top_of_next_minute(date_time));
+
+    // the alarm fires one second after it matches, and it can't match a time that's already here.
+    uint32_t deadline = num_timers ? max(timers[0].timestamp, now + 2) : next_minute;
+    if (deadline < next_minute) {
+        watch_rtc_register_alarm_callback(cb_timer_alarm_fired, watch_utility_date_time_from_unix_time(deadline - 1, 0), ALARM_MATCH_YYMMDDHHMMSS);
+        movement_state.timer_alarm = true;
+    } else if (movement_state.timer_alarm) {
+        _movement_register_minute_alarm();
+        movement_state.timer_alarm = false;
+    }
+}
+
 void movement_request_tick_frequency(uint8_t freq) {
     // Movement uses the 128 Hz tick internally
     if (freq == 128) return;
@@ -233,11 +495,31 @@ void movement_request_tick_frequency(uint8_t freq) {
     // disable all callbacks except the 128 Hz one
     watch_rtc_disable_matching_periodic_callbacks(0xFE);
 
+    if (movement_state.tickless) _movement_disable_tickless();
+
     movement_state.subsecond = 0;
     movement_state.tick_frequency = freq;
     watch_rtc_register_periodic_callback(cb_tick, freq);
 }
 
+void movement_request_next_redraw(watch_date_time date_time) {
+    // in low energy mode, we only wake once a minute anyway.
+    if (movement_state.le_mode_ticks == -1) return;
+
+    watch_date_time now = watch_rtc_get_date_time();
+
+    if (!movement_state.tickless) {
+        // disable all callbacks except the 128 Hz one; from here on, the RTC alarm wakes us up.
+        watch_rtc_disable_matching_periodic_callbacks(0xFE);
+        movement_state.countdown_timestamp = _movement_timestamp(now);
+        movement_state.last_minute = now.unit.minute;
+        movement_state.tickless = true;
+    }
+
+    if (date_time.reg == 0) date_time = _movement_top_of_next_minute(now);
+    movement_state.next_redraw = date_time;
+}
+
 void movement_illuminate_led(void) {
     if (movement_state.settings.bit.led_duration != 0b111) {
         watch_set_led_color(movement_state.settings.bit.led_red_color ? (0xF | movement_state.settings.bit.led_red_color << 4) : 0,
@@ -310,23 +592,64 @@ void movement_cancel_background_task(void) {
 }
 
 void movement_schedule_background_task_for_face(uint8_t watch_face_index, watch_date_time date_time) {
+    movement_schedule_background_timer(watch_face_index, 0, date_time);
+}
+
+void movement_cancel_background_task_for_face(uint8_t watch_face_index) {
+    movement_cancel_background_timer(watch_face_index, 0);
+}
+
+bool movement_schedule_background_timer(uint8_t watch_face_index, uint8_t timer_id, watch_date_time date_time) {
+    if (watch_face_index >= MOVEMENT_NUM_FACES || timer_id >= MOVEMENT_TIMERS_PER_FACE) return false;
+
     watch_date_time now = watch_rtc_get_date_time();
-    if (date_time.reg > now.reg) {
-        movement_state.has_scheduled_background_task = true;
-        scheduled_tasks[watch_face_index].reg = date_time.reg;
+    if (date_time.reg <= now.reg) return false;
+
+    uint32_t timestamp = _movement_timestamp(date_time);
+    uint8_t position = timer_positions[watch_face_index][timer_id];
+
+    if (position != MOVEMENT_TIMER_NOT_SCHEDULED) {
+        // this timer is already pending; move it to its new time.
+        timers[position].timestamp = timestamp;
+        _movement_sift_timer_up(position);
+        _movement_sift_timer_down(timer_positions[watch_face_index][timer_id]);
+    } else {
+        if (num_timers >= MOVEMENT_MAX_TIMERS) return false;
+        movement_timer_t timer = { timestamp, watch_face_index, timer_id };
+        _movement_place_timer(num_timers, timer);
+        num_timers++;
+        _movement_sift_timer_up(num_timers - 1);
     }
+
+    movement_state.has_scheduled_background_task = true;
+    return true;
 }
 
-void movement_cancel_background_task_for_face(uint8_t watch_face_index) {
-    scheduled_tasks[watch_face_index].reg = 0;
-    bool other_tasks_scheduled = false;
-    for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
-        if (scheduled_tasks[i].reg != 0) {
-            other_tasks_scheduled = true;
-            break;
-        }
+void movement_cancel_background_timer(uint8_t watch_face_index, uint8_t timer_id) {
+    if (watch_face_index >= MOVEMENT_NUM_FACES || timer_id >= MOVEMENT_TIMERS_PER_FACE) return;
+
+    uint8_t position = timer_positions[watch_face_index][timer_id];
+    if (position != MOVEMENT_TIMER_NOT_SCHEDULED) _movement_remove_timer(position);
+    movement_state.has_scheduled_background_task = num_timers > 0;
+}
+
+void movement_set_background_cadence(uint8_t watch_face_index, movement_background_cadence_t cadence, uint8_t hour, uint8_t minute) {
+    if (watch_face_index >= MOVEMENT_NUM_FACES || cadence >= MOVEMENT_NUM_BACKGROUND_CADENCES) return;
+    if (watch_faces[watch_face_index].wants_background_task == NULL) return;
+
+    uint8_t word = watch_face_index / 32;
+    uint32_t bit = 1ul << (watch_face_index % 32);
+    for(uint8_t i = 0; i < MOVEMENT_NUM_BACKGROUND_CADENCES; i++) {
+        background_masks[i][word] &= ~bit;
     }
-    movement_state.has_scheduled_background_task = other_tasks_scheduled;
+    background_masks[cadence][word] |= bit;
+    background_times[watch_face_index].hour = hour;
+    background_times[watch_face_index].minute = minute;
+}
+
+void movement_set_export(uint8_t watch_face_index, watch_face_export export) {
+    if (watch_face_index >= MOVEMENT_NUM_FACES) return;
+    exports[watch_face_index] = export;
 }
 
 void movement_request_wake() {
@@ -389,6 +712,43 @@ uint8_t movement_claim_backup_register(void) {
     return movement_state.next_available_backup_register++;
 }
 
+// dump prints a few records each time around the app loop, so a long log doesn't hold up the watch.
+static struct {
+    uint8_t face;
+    int32_t position;
+} dump_state;
+
+static bool _movement_dump_step(void *user_data) {
+    (void) user_data;
+    dump_state.position = exports[dump_state.face](&movement_state.settings, watch_face_contexts[dump_state.face], dump_state.position);
+    if (dump_state.position == MOVEMENT_EXPORT_FAILED) printf("dump: couldn't read the log\r\n");
+
+    return dump_state.position >= 0;
+}
+
+int movement_cmd_dump(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("faces with a log to dump:");
+        for (uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
+            if (exports[i] != NULL) printf(" %d", i);
+        }
+        printf("\r\n");
+        return 0;
+    }
+
+    char *end;
+    long index = strtol(argv[1], &end, 10);
+    if (*end != 0 || index < 0 || index >= (long)MOVEMENT_NUM_FACES || exports[index] == NULL) {
+        printf("dump: face %s has no log to dump\r\n", argv[1]);
+        return -1;
+    }
+    dump_state.face = index;
+    dump_state.position = 0;
+    shell_continue(_movement_dump_step, NULL);
+
+    return 0;
+}
+
 void app_init(void) {
 #if defined(NO_FREQCORR)
     watch_rtc_freqcorr_write(0, 0);
@@ -412,7 +772,11 @@ void app_init(void) {
     movement_state.next_available_backup_register = 4;
     _movement_reset_inactivity_countdown();
 
+    num_timers = 0;
+    memset(timer_positions, MOVEMENT_TIMER_NOT_SCHEDULED, sizeof(timer_positions));
+
     filesystem_init();
+    kvstore_init();
 
 #if __EMSCRIPTEN__
     int32_t time_zone_offset = EM_ASM_INT({
@@ -443,15 +807,12 @@ void app_setup(void) {
 
         for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
             watch_face_contexts[i] = NULL;
-            scheduled_tasks[i].reg = 0;
             is_first_launch = false;
+            // until the face tells us otherwise, poll it for background tasks every minute.
+            movement_set_background_cadence(i, MOVEMENT_BACKGROUND_EVERY_MINUTE, 0, 0);
         }
 
-        // set up the 1 minute alarm (for background tasks and low power updates)
-        watch_date_time alarm_time;
-        alarm_time.reg = 0;
-        alarm_time.unit.second = 59; // after a match, the alarm fires at the next rising edge of CLK_RTC_CNT, so 59 seconds lets us update at :00
-        watch_rtc_register_alarm_callback(cb_alarm_fired, alarm_time, ALARM_MATCH_SS);
+        _movement_register_minute_alarm();
     }
     if (movement_state.le_mode_ticks != -1) {
         watch_disable_extwake_interrupt(BTN_ALARM);
@@ -460,6 +821,7 @@ void app_setup(void) {
         watch_register_interrupt_callback(BTN_MODE, cb_mode_btn_interrupt, INTERRUPT_TRIGGER_BOTH);
         watch_register_interrupt_callback(BTN_LIGHT, cb_light_btn_interrupt, INTERRUPT_TRIGGER_BOTH);
         watch_register_interrupt_callback(BTN_ALARM, cb_alarm_btn_interrupt, INTERRUPT_TRIGGER_BOTH);
+        movement_accelerometer_wake();
 
         watch_enable_buzzer();
         watch_enable_leds();
@@ -472,8 +834,7 @@ void app_setup(void) {
         }
 
         watch_faces[movement_state.current_face_idx].activate(&movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
-        event.subsecond = 0;
-        event.event_type = EVENT_ACTIVATE;
+        activate_pending = true;
     }
 }
 
@@ -481,28 +842,59 @@ void app_prepare_for_standby(void) {
 }
 
 void app_wake_from_standby(void) {
+#if __EMSCRIPTEN__ || WATCH_HOST
+    watch_date_time date_time = watch_rtc_get_date_time();
+    if (date_time.unit.hour != wakeup_hour) {
+        printf("%lu wakeups between %02d:00 and %02d:00\n", wakeups_this_hour, wakeup_hour, date_time.unit.hour);
+        wakeups_this_hour = 0;
+        wakeup_hour = date_time.unit.hour;
+    }
+    wakeups_this_hour++;
+#endif
 }
 
 static void _sleep_mode_app_loop(void) {
+    movement_event_t event = { EVENT_LOW_ENERGY_UPDATE, 0 };
+    // the face updates the screen as we go to sleep, and then once a minute; timers and the accelerometer may wake
+    // us up in between.
+    bool needs_update = true;
     movement_state.needs_wake = false;
     // as long as le_mode_ticks is -1 (i.e. we are in low energy mode), we wake up here, update the screen, and go right back to sleep.
     while (movement_state.le_mode_ticks == -1) {
         // we also have to handle background tasks here in the mini-runloop
-        if (movement_state.needs_background_tasks_handled) _movement_handle_background_tasks();
-
-        event.event_type = EVENT_LOW_ENERGY_UPDATE;
-        watch_faces[movement_state.current_face_idx].loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+        if (movement_state.needs_background_tasks_handled) {
+            _movement_handle_background_tasks();
+            needs_update = true;
+        }
+        // and any timers that have come due,
+        if (movement_state.has_scheduled_background_task) _movement_handle_scheduled_tasks();
+        // and whatever the accelerometer has collected.
+        movement_accelerometer_sleep_task();
+
+        if (needs_update) {
+            watch_faces[movement_state.current_face_idx].loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+            needs_update = false;
+        }
 
         // if we need to wake immediately, do it!
-        if (movement_state.needs_wake) return;
+        if (movement_state.needs_wake) break;
         // otherwise enter sleep mode, and when the extwake handler is called, it will reset le_mode_ticks and force us out at the next loop.
-        else watch_enter_sleep_mode();
+        _movement_schedule_sleep_wake();
+        watch_enter_sleep_mode();
+    }
+
+    // outside of low energy mode, the minute alarm has to be there for the background tasks.
+    if (movement_state.timer_alarm) {
+        _movement_register_minute_alarm();
+        movement_state.timer_alarm = false;
     }
 }
 
 bool app_loop(void) {
     const watch_face_t *wf = &watch_faces[movement_state.current_face_idx];
     bool woke_up_for_buzzer = false;
+    movement_event_t event;
+
     if (movement_state.watch_face_changed) {
         if (movement_state.settings.bit.button_should_sound) {
             // low note for nonzero case, high note for return to watch_face 0
@@ -515,8 +907,7 @@ bool app_loop(void) {
         watch_clear_display();
         movement_request_tick_frequency(1);
         wf->activate(&movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
-        event.subsecond = 0;
-        event.event_type = EVENT_ACTIVATE;
+        activate_pending = true;
         movement_state.watch_face_changed = false;
     }
 
@@ -534,14 +925,17 @@ bool app_loop(void) {
     if (movement_state.needs_background_tasks_handled) _movement_handle_background_tasks();
 
     // if we have a scheduled background task, handle that here:
-    if (event.event_type == EVENT_TICK && movement_state.has_scheduled_background_task) _movement_handle_scheduled_tasks();
+    // in tickless mode, there may not be a tick, but the alarm woke us in time for the task.
+    if (movement_state.has_scheduled_background_task && (movement_state.tickless || _movement_tick_is_pending())) _movement_handle_scheduled_tasks();
 
     // if we have timed out of our low energy mode countdown, enter low energy mode.
     if (movement_state.le_mode_ticks == 0) {
+        // low energy mode relies on the once-a-minute alarm.
+        if (movement_state.tickless) _movement_disable_tickless();
         movement_state.le_mode_ticks = -1;
         watch_register_extwake_callback(BTN_ALARM, cb_alarm_btn_extwake, true);
-        event.event_type = EVENT_NONE;
-        event.subsecond = 0;
+        _movement_flush_events();
+        activate_pending = false;
 
         // _sleep_mode_app_loop takes over at this point and loops until le_mode_ticks is reset by the extwake handler,
         // or wake is requested using the movement_request_wake function.
@@ -551,7 +945,8 @@ bool app_loop(void) {
         if (movement_state.is_buzzing) {
             woke_up_for_buzzer = true;
         }
-        event.event_type = EVENT_ACTIVATE;
+        // anything that was queued while we were asleep is stale; the face gets a fresh EVENT_ACTIVATE instead.
+        _movement_flush_events();
         // this is a hack tho: waking from sleep mode, app_setup does get called, but it happens before we have reset our ticks.
         // need to figure out if there's a better heuristic for determining how we woke up.
         app_setup();
@@ -560,10 +955,19 @@ bool app_loop(void) {
     // default to being allowed to sleep by the face.
     bool can_sleep = true;
 
-    if (event.event_type) {
-        event.subsecond = movement_state.subsecond;
-        // the first trip through the loop overrides the can_sleep state
+    if (activate_pending) {
+        activate_pending = false;
+        event.event_type = EVENT_ACTIVATE;
+        event.subsecond = 0;
         can_sleep = wf->loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+    }
+
+    // deliver everything the interrupt callbacks queued up since the last trip through the loop, in order.
+    // if the face asks to move to another face, we stop here and leave the rest for the new face.
+    while (!movement_state.watch_face_changed && _movement_dequeue_event(&event)) {
+        // if any one event says we can't sleep, we can't sleep.
+        bool event_can_sleep = wf->loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+        can_sleep = can_sleep && event_can_sleep;
 
         // Keep light on if user is still interacting with the watch.
         if (movement_state.light_ticks > 0) {
@@ -574,13 +978,12 @@ bool app_loop(void) {
                     movement_illuminate_led();
             }
         }
-
-        event.event_type = EVENT_NONE;
     }
 
     // if we have timed out of our timeout countdown, give the app a hint that they can resign.
     if (movement_state.timeout_ticks == 0) {
         movement_state.timeout_ticks = -1;
+        event.event_type = EVENT_NONE;
         if (movement_state.settings.bit.to_always == false) {
             // if "timeout always" is false, give the current watch face a chance to exit gracefully...
             event.event_type = EVENT_TIMEOUT;
@@ -595,7 +998,6 @@ bool app_loop(void) {
         //          && | can sleep | cannot sleep | cannot sleep | cannot sleep
         bool can_sleep2 = wf->loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
         can_sleep = can_sleep && can_sleep2;
-        event.event_type = EVENT_NONE;
         if (movement_state.settings.bit.to_always && movement_state.current_face_idx != 0) {
             // ...but if the user has "timeout always" set, give it the boot.
             movement_move_to_face(0);
@@ -622,16 +1024,25 @@ bool app_loop(void) {
         }
     }
 
+    // if the accelerometer has filled its FIFO up to the watermark, hand out the samples.
+    if (!movement_accelerometer_task()) can_sleep = false;
+
     // if we are plugged into USB, handle the serial shell
     if (watch_is_usb_enabled()) {
         shell_task();
+        // a command running in steps gets its next one on the next trip around the loop.
+        if (shell_is_busy()) can_sleep = false;
     }
 
-    event.subsecond = 0;
+    // in tickless mode, set the alarm for whatever needs our attention next.
+    if (movement_state.tickless) _movement_schedule_tickless_wake();
 
     // if the watch face changed, we can't sleep because we need to update the display.
     if (movement_state.watch_face_changed) can_sleep = false;
 
+    // if an interrupt queued something while we were busy, go around again instead of sleeping through it.
+    if (event_queue.head != event_queue.tail) can_sleep = false;
+
     // if we woke up for the buzzer, stay awake until it's finished.
     if (woke_up_for_buzzer) {
         while(watch_is_buzzer_or_led_enabled());
@@ -669,19 +1080,19 @@ static movement_event_type_t _figure_out_button_event(bool pin_level, movement_e
 void cb_light_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_LIGHT);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_LIGHT_BUTTON_DOWN, &movement_state.light_down_timestamp);
+    _movement_queue_event(_figure_out_button_event(pin_level, EVENT_LIGHT_BUTTON_DOWN, &movement_state.light_down_timestamp));
 }
 
 void cb_mode_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_MODE);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_MODE_BUTTON_DOWN, &movement_state.mode_down_timestamp);
+    _movement_queue_event(_figure_out_button_event(pin_level, EVENT_MODE_BUTTON_DOWN, &movement_state.mode_down_timestamp));
 }
 
 void cb_alarm_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_ALARM);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_ALARM_BUTTON_DOWN, &movement_state.alarm_down_timestamp);
+    _movement_queue_event(_figure_out_button_event(pin_level, EVENT_ALARM_BUTTON_DOWN, &movement_state.alarm_down_timestamp));
 }
 
 void cb_alarm_btn_extwake(void) {
@@ -690,7 +1101,28 @@ void cb_alarm_btn_extwake(void) {
 }
 
 void cb_alarm_fired(void) {
-    movement_state.needs_background_tasks_handled = true;
+    if (!movement_state.tickless) {
+        movement_state.needs_background_tasks_handled = true;
+        return;
+    }
+
+    // in tickless mode, this alarm stands in for the tick, so work out which deadlines have come due.
+    movement_state.tickless_alarm = 0;
+    watch_date_time date_time = watch_rtc_get_date_time();
+    _movement_update_tickless_countdowns(_movement_timestamp(date_time));
+    if (date_time.unit.minute != movement_state.last_minute) {
+        movement_state.last_minute = date_time.unit.minute;
+        movement_state.needs_background_tasks_handled = true;
+    }
+    if (date_time.reg >= movement_state.next_redraw.reg) {
+        movement_state.next_redraw = _movement_top_of_next_minute(date_time);
+        movement_state.subsecond = 0;
+        _movement_queue_event(EVENT_TICK);
+    }
+}
+
+void cb_timer_alarm_fired(void) {
+    // nothing to do but wake up; the sleep loop runs whichever timers are due.
 }
 
 void cb_fast_tick(void) {
@@ -698,17 +1130,15 @@ void cb_fast_tick(void) {
     if (movement_state.light_ticks > 0) movement_state.light_ticks--;
     if (movement_state.alarm_ticks > 0) movement_state.alarm_ticks--;
     // check timestamps and auto-fire the long-press events
-    // Notice: is it possible that two or more buttons have an identical timestamp? In this case
-    // only one of these buttons would receive the long press event. Don't bother for now...
     if (movement_state.light_down_timestamp > 0)
         if (movement_state.fast_ticks - movement_state.light_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_LIGHT_LONG_PRESS;
+            _movement_queue_event(EVENT_LIGHT_LONG_PRESS);
     if (movement_state.mode_down_timestamp > 0)
         if (movement_state.fast_ticks - movement_state.mode_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_MODE_LONG_PRESS;
+            _movement_queue_event(EVENT_MODE_LONG_PRESS);
     if (movement_state.alarm_down_timestamp > 0)
         if (movement_state.fast_ticks - movement_state.alarm_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_ALARM_LONG_PRESS;
+            _movement_queue_event(EVENT_ALARM_LONG_PRESS);
     // this is just a fail-safe; fast tick should be disabled as soon as the button is up, the LED times out, and/or the alarm finishes.
     // but if for whatever reason it isn't, this forces the fast tick off after 20 seconds.
     if (movement_state.fast_ticks >= 128 * 20) {
@@ -718,7 +1148,6 @@ void cb_fast_tick(void) {
 }
 
 void cb_tick(void) {
-    event.event_type = EVENT_TICK;
     watch_date_time date_time = watch_rtc_get_date_time();
     if (date_time.unit.second != movement_state.last_second) {
         // TODO: can we consolidate these two ticks?
@@ -730,4 +1159,5 @@ void cb_tick(void) {
     } else {
         movement_state.subsecond++;
     }
+    _movement_queue_event(EVENT_TICK);
 }
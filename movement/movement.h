@@ -125,9 +125,13 @@ typedef enum {
 
 typedef struct {
     uint8_t event_type;
-    uint8_t subsecond;
+    uint8_t subsecond;      // for an EVENT_BACKGROUND_TASK triggered by a background timer, this is the timer's ID.
 } movement_event_t;
 
+#ifndef MOVEMENT_TIMERS_PER_FACE
+#define MOVEMENT_TIMERS_PER_FACE 4
+#endif
+
 extern const int16_t movement_timezone_offsets[];
 extern const char movement_valid_position_0_chars[];
 extern const char movement_valid_position_1_chars[];
@@ -210,7 +214,9 @@ typedef void (*watch_face_resign)(movement_settings_t *settings, void *context);
 
 /** @brief OPTIONAL. Request an opportunity to run a background task.
   * @details Most apps will not need this function, but if you provide it, Movement will call it once per minute in
-  *          both active and low power modes, regardless of whether your app is in the foreground. You can check the
+  *          both active and low power modes, regardless of whether your app is in the foreground. If you only need
+  *          to check hourly or at a certain time of day, call movement_set_background_cadence in your setup
+  *          function, and Movement will skip calling this function the rest of the time. You can check the
   *          current time to determine whether you require a background task. If you return true here, Movement will
   *          immediately call your loop function with an EVENT_BACKGROUND_TASK event. Note that it will not call your
   *          activate or deactivate functions, since you are not going on screen.
@@ -232,6 +238,35 @@ typedef void (*watch_face_resign)(movement_settings_t *settings, void *context);
   */
 typedef bool (*watch_face_wants_background_task)(movement_settings_t *settings, void *context);
 
+/** @brief OPTIONAL. Stream your watch face's logged data out over USB.
+  * @details If your watch face keeps a log (of sensor readings, say), register one of these with movement_set_export
+  *          in your setup function, so that the log can be copied off the watch with the shell's `dump` command.
+  *          Print it with printf as comma-separated values: a line of column names, then one line per record.
+  *          A log can be long, so the dump command calls this once each time around the app loop, and each call
+  *          prints just the next MOVEMENT_EXPORT_RECORDS_PER_CALL records or so, starting from position. The first
+  *          call gets a position of 0, and prints the column names first. datalog_read keeps the place in a datalog.
+  *          This may be called while your watch face is in the background.
+  * @param settings A pointer to the global Movement settings. @see watch_face_setup.
+  * @param context A pointer to your application's context. @see watch_face_setup.
+  * @param position 0 for the first call, then whatever the last call returned.
+  * @return the position for the next call, MOVEMENT_EXPORT_DONE once the whole log is printed, or
+  *         MOVEMENT_EXPORT_FAILED if it couldn't be read.
+  */
+typedef int32_t (*watch_face_export)(movement_settings_t *settings, void *context, int32_t position);
+
+#define MOVEMENT_EXPORT_RECORDS_PER_CALL 16
+#define MOVEMENT_EXPORT_DONE (-1)
+#define MOVEMENT_EXPORT_FAILED (-2)
+
+// How often Movement should call a watch face's wants_background_task function. Faces that provide one are
+// polled every minute unless they call movement_set_background_cadence from their setup function.
+typedef enum {
+    MOVEMENT_BACKGROUND_EVERY_MINUTE = 0,   // at the top of every minute.
+    MOVEMENT_BACKGROUND_HOURLY,             // once an hour, at the given number of minutes past the hour.
+    MOVEMENT_BACKGROUND_DAILY,              // once a day, at the given hour and minute.
+    MOVEMENT_NUM_BACKGROUND_CADENCES
+} movement_background_cadence_t;
+
 typedef struct {
     watch_face_setup setup;
     watch_face_activate activate;
@@ -268,6 +303,7 @@ typedef struct {
     bool needs_background_tasks_handled;
     bool has_scheduled_background_task;
     bool needs_wake;
+    bool timer_alarm; // in low energy mode, the RTC alarm is set for a timer instead of the top of the minute
 
     // low energy mode countdown
     int32_t le_mode_ticks;
@@ -280,6 +316,13 @@ typedef struct {
     uint8_t last_second;
     uint8_t subsecond;
 
+    // tickless mode: instead of a periodic tick, the RTC alarm wakes us at the next deadline
+    bool tickless;
+    watch_date_time next_redraw;
+    uint32_t countdown_timestamp;
+    uint32_t tickless_alarm; // when the alarm we set will fire, or 0 if it has fired
+    uint8_t last_minute;
+
     // backup register stuff
     uint8_t next_available_backup_register;
 } movement_state_t;
@@ -293,6 +336,13 @@ void movement_illuminate_led(void);
 
 void movement_request_tick_frequency(uint8_t freq);
 
+// Stops the periodic tick and asks for a single EVENT_TICK at the given date and time instead, which lets the
+// watch sleep until then. Pass a date_time of 0 to get an EVENT_TICK at the top of each minute, which is also
+// what happens if you don't request another redraw when handling the tick. Movement will still wake up for
+// button presses, background tasks and timeouts. Call movement_request_tick_frequency to go back to a periodic
+// tick; Movement does this for you when your watch face resigns. This has no effect in low energy mode.
+void movement_request_next_redraw(watch_date_time date_time);
+
 // note: watch faces can only schedule a background task when in the foreground, since
 // movement will associate the scheduled task with the currently active face.
 void movement_schedule_background_task(watch_date_time date_time);
@@ -302,15 +352,34 @@ void movement_schedule_background_task(watch_date_time date_time);
 void movement_cancel_background_task(void);
 
 // these functions should work around the limitation of the above functions, which will be deprecated.
+// they are equivalent to scheduling or cancelling timer ID 0 with the functions below.
 void movement_schedule_background_task_for_face(uint8_t watch_face_index, watch_date_time date_time);
 void movement_cancel_background_task_for_face(uint8_t watch_face_index);
 
+// Each watch face can have up to MOVEMENT_TIMERS_PER_FACE background timers pending at once, identified by an ID
+// from 0 to MOVEMENT_TIMERS_PER_FACE - 1 that you choose. When a timer comes due, your loop function will get an
+// EVENT_BACKGROUND_TASK with the timer's ID in the subsecond field. Scheduling a timer that is already pending
+// moves it to the new time. Returns false if the time is not in the future or if all timer slots are in use.
+// Timers fire in low energy mode too, without waking the watch; call movement_request_wake if yours needs it awake.
+bool movement_schedule_background_timer(uint8_t watch_face_index, uint8_t timer_id, watch_date_time date_time);
+void movement_cancel_background_timer(uint8_t watch_face_index, uint8_t timer_id);
+
 void movement_request_wake(void);
 
+// declares how often your wants_background_task function needs to be called. the hour is ignored for an hourly
+// cadence, and both hour and minute are ignored for MOVEMENT_BACKGROUND_EVERY_MINUTE.
+void movement_set_background_cadence(uint8_t watch_face_index, movement_background_cadence_t cadence, uint8_t hour, uint8_t minute);
+
+// offers your face's log to the shell's dump command. @see watch_face_export.
+void movement_set_export(uint8_t watch_face_index, watch_face_export export);
+
 void movement_play_signal(void);
 void movement_play_alarm(void);
 void movement_play_alarm_beeps(uint8_t rounds, BuzzerNote alarm_note);
 
 uint8_t movement_claim_backup_register(void);
 
+// the shell's dump command: `dump` lists the faces that have a log to export, and `dump <index>` prints one.
+int movement_cmd_dump(int argc, char *argv[]);
+
 #endif // MOVEMENT_H_
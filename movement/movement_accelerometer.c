@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <string.h>
+#include "movement_accelerometer.h"
+
+typedef struct {
+    movement_accelerometer_callback_t callback;
+    void *user_data;
+    lis2dw_data_rate_t data_rate;
+    watch_date_time start;
+    uint32_t next_sample;
+    // how many of the accelerometer's samples to skip before the next one that's ours.
+    uint8_t skip;
+} movement_accelerometer_subscriber_t;
+
+static movement_accelerometer_subscriber_t subscribers[MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS];
+// the rate the accelerometer is running at, or LIS2DW_DATA_RATE_POWERDOWN when nobody's listening.
+static lis2dw_data_rate_t running_rate = LIS2DW_DATA_RATE_POWERDOWN;
+// set by the INT1 interrupt, cleared once we've read the FIFO.
+static volatile bool fifo_ready;
+// true in low energy mode, where INT1 wakes us through the RTC instead of the EIC.
+static bool asleep;
+
+static lis2dw_reading_t fifo_readings[32];
+static lis2dw_reading_t subscriber_readings[32];
+
+static void _movement_accelerometer_interrupt(void) {
+    fifo_ready = true;
+}
+
+static lis2dw_data_rate_t _movement_accelerometer_fastest_rate(void) {
+    lis2dw_data_rate_t fastest = LIS2DW_DATA_RATE_POWERDOWN;
+    for (uint8_t i = 0; i < MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].callback != NULL && subscribers[i].data_rate > fastest) fastest = subscribers[i].data_rate;
+    }
+    return fastest;
+}
+
+static void _movement_accelerometer_power_up(lis2dw_data_rate_t rate) {
+    lis2dw_config_t config = {
+        .data_rate = rate,
+        .mode = LIS2DW_MODE_LOW_POWER,
+        .low_power_mode = MOVEMENT_ACCELEROMETER_LOW_POWER_MODE,
+        .range = MOVEMENT_ACCELEROMETER_RANGE,
+        .bandwidth = MOVEMENT_ACCELEROMETER_FILTER,
+        .filter = LIS2DW_FILTER_LOW_PASS,
+        .low_noise = MOVEMENT_ACCELEROMETER_LOW_NOISE,
+    };
+
+    lis2dw_apply_config(&config);
+    watch_register_interrupt_callback(A4, _movement_accelerometer_interrupt, INTERRUPT_TRIGGER_RISING);
+}
+
+static void _movement_accelerometer_power_down(void) {
+    if (asleep) {
+        watch_disable_extwake_interrupt(A4);
+        asleep = false;
+    } else {
+        watch_register_interrupt_callback(A4, NULL, INTERRUPT_TRIGGER_RISING);
+    }
+    lis2dw_configure_fifo_threshold_int1(0);
+    lis2dw_set_data_rate(LIS2DW_DATA_RATE_POWERDOWN);
+    watch_disable_i2c();
+    fifo_ready = false;
+}
+
+// starts everyone's count over, so that the next sample is everybody's sample 0, taken about now.
+static void _movement_accelerometer_restart_count(void) {
+    watch_date_time now = watch_rtc_get_date_time();
+    for (uint8_t i = 0; i < MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS; i++) {
+        subscribers[i].start = now;
+        subscribers[i].next_sample = 0;
+        subscribers[i].skip = 0;
+    }
+}
+
+// runs the accelerometer at the fastest rate anyone wants, starting everyone's count over if that's changed.
+static void _movement_accelerometer_update_rate(void) {
+    lis2dw_data_rate_t rate = _movement_accelerometer_fastest_rate();
+    if (rate == running_rate) return;
+
+    if (rate == LIS2DW_DATA_RATE_POWERDOWN) {
+        _movement_accelerometer_power_down();
+    } else {
+        if (running_rate == LIS2DW_DATA_RATE_POWERDOWN) _movement_accelerometer_power_up(rate);
+        else lis2dw_set_data_rate(rate);
+        // this empties the FIFO, so the next sample is everybody's sample 0.
+        lis2dw_configure_fifo_threshold_int1(MOVEMENT_ACCELEROMETER_WATERMARK);
+        _movement_accelerometer_restart_count();
+        fifo_ready = false;
+    }
+    running_rate = rate;
+}
+
+bool movement_accelerometer_subscribe(lis2dw_data_rate_t data_rate, movement_accelerometer_callback_t callback, void *user_data) {
+    if (data_rate < LIS2DW_DATA_RATE_12_5_HZ || data_rate > LIS2DW_DATA_RATE_200_HZ || callback == NULL) return false;
+
+    movement_accelerometer_subscriber_t *subscriber = NULL;
+    for (uint8_t i = 0; i < MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].callback == callback && subscribers[i].user_data == user_data) {
+            subscriber = &subscribers[i];
+            break;
+        }
+        if (subscribers[i].callback == NULL && subscriber == NULL) subscriber = &subscribers[i];
+    }
+    if (subscriber == NULL) return false;
+
+    if (running_rate == LIS2DW_DATA_RATE_POWERDOWN) {
+        watch_enable_i2c();
+        if (!lis2dw_begin()) {
+            watch_disable_i2c();
+            return false;
+        }
+    }
+
+    subscriber->callback = callback;
+    subscriber->user_data = user_data;
+    subscriber->data_rate = data_rate;
+    subscriber->start = watch_rtc_get_date_time();
+    subscriber->next_sample = 0;
+    subscriber->skip = 0;
+    _movement_accelerometer_update_rate();
+
+    return true;
+}
+
+void movement_accelerometer_unsubscribe(movement_accelerometer_callback_t callback, void *user_data) {
+    for (uint8_t i = 0; i < MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].callback == callback && subscribers[i].user_data == user_data) {
+            memset(&subscribers[i], 0, sizeof(subscribers[i]));
+        }
+    }
+    _movement_accelerometer_update_rate();
+}
+
+// hands a subscriber its share of what came out of the FIFO: every sample at the accelerometer's rate, or every
+// second one at half of it, and so on.
+static void _movement_accelerometer_deliver(movement_accelerometer_subscriber_t *subscriber, uint8_t count, bool overrun) {
+    uint8_t stride = 1 << (running_rate - subscriber->data_rate);
+    movement_accelerometer_block_t block;
+
+    block.start = subscriber->start;
+    block.first_sample = subscriber->next_sample;
+    // the rates go 12.5 Hz, 25 Hz, 50 Hz... with LIS2DW_DATA_RATE_12_5_HZ at 80 ms.
+    block.sample_period_us = 80000 >> (subscriber->data_rate - LIS2DW_DATA_RATE_12_5_HZ);
+    block.range = MOVEMENT_ACCELEROMETER_RANGE;
+    block.overrun = overrun;
+
+    if (stride == 1) {
+        block.count = count;
+        block.readings = fifo_readings;
+    } else {
+        uint8_t i = subscriber->skip;
+        block.count = 0;
+        for (; i < count; i += stride) subscriber_readings[block.count++] = fifo_readings[i];
+        subscriber->skip = i - count;
+        block.readings = subscriber_readings;
+    }
+    subscriber->next_sample += block.count;
+
+    if (block.count > 0) subscriber->callback(&block, subscriber->user_data);
+}
+
+void movement_accelerometer_sleep_task(void) {
+    if (running_rate == LIS2DW_DATA_RATE_POWERDOWN) return;
+
+    if (!asleep) {
+        // sleep turns off the EIC, so from here on INT1 wakes us through the RTC. the I2C bus is still on this time.
+        watch_register_extwake_callback(A4, _movement_accelerometer_interrupt, true);
+        asleep = true;
+    } else if (fifo_ready || watch_get_pin_level(A4)) {
+        // but after that, sleep has turned it off.
+        watch_enable_i2c();
+    } else {
+        return;
+    }
+
+    // the RTC only wakes us when INT1 goes up, so it has to be down again before we go back to sleep. if it won't
+    // go down (the bus has stopped answering, say), the minute alarm will bring us back to try again.
+    if (watch_get_pin_level(A4)) fifo_ready = true;
+    for (uint8_t i = 0; i < 4 && !movement_accelerometer_task(); i++);
+}
+
+void movement_accelerometer_wake(void) {
+    if (running_rate == LIS2DW_DATA_RATE_POWERDOWN) return;
+
+    if (asleep) {
+        watch_disable_extwake_interrupt(A4);
+        asleep = false;
+    }
+    // sleep turned off the I2C bus and the EIC, and our interrupt with it. the accelerometer kept going on its own.
+    watch_enable_i2c();
+    watch_register_interrupt_callback(A4, _movement_accelerometer_interrupt, INTERRUPT_TRIGGER_RISING);
+    // by now the FIFO has most likely filled past the watermark, and INT1 won't rise again until we've read it.
+    if (watch_get_pin_level(A4)) fifo_ready = true;
+}
+
+bool movement_accelerometer_task(void) {
+    if (!fifo_ready || running_rate == LIS2DW_DATA_RATE_POWERDOWN) return true;
+    fifo_ready = false;
+
+    bool overrun;
+    uint8_t count = lis2dw_read_fifo_burst(fifo_readings, sizeof(fifo_readings) / sizeof(lis2dw_reading_t), &overrun);
+    lis2dw_data_rate_t rate = running_rate;
+
+    // we don't know how many samples were lost, so counting on from the last block would put these at the wrong
+    // time. the FIFO only keeps the newest, though, so they start over from about now.
+    if (overrun) _movement_accelerometer_restart_count();
+
+    // if a callback changes the rate, sampling starts over, and what's left of these samples belongs to nobody.
+    for (uint8_t i = 0; i < MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS && running_rate == rate; i++) {
+        if (subscribers[i].callback != NULL) _movement_accelerometer_deliver(&subscribers[i], count, overrun);
+    }
+
+    // INT1 only interrupts on its way up. if the FIFO filled to the watermark again while we were busy, it never
+    // went down, so go around again rather than waiting for an edge that won't come.
+    if (running_rate != LIS2DW_DATA_RATE_POWERDOWN && watch_get_pin_level(A4)) fifo_ready = true;
+
+    return !fifo_ready;
+}
@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef MOVEMENT_ACCELEROMETER_H_
+#define MOVEMENT_ACCELEROMETER_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include "lis2dw.h"
+#include "watch.h"
+
+/** @brief Streams samples from the LIS2DW accelerometer on the sensor board to the faces that want them.
+  * @details The accelerometer collects samples in its FIFO and raises INT1 (on A4) when there are
+  *          MOVEMENT_ACCELEROMETER_WATERMARK of them. That wakes the watch, Movement reads them all out in one burst
+  *          and hands them to each subscriber, and then the watch goes back to sleep. There's no need for a fast
+  *          tick, and no samples go missing between reads.
+  *
+  *          Each subscriber asks for a data rate from 12.5 to 200 Hz. The accelerometer runs at the fastest rate
+  *          anyone asked for, and slower subscribers get every second (or fourth, ...) sample. Because the rates
+  *          are counted by the accelerometer's own clock, a sample's time is when its subscription (re)started, plus
+  *          its sample number times sample_period_us. Whenever the fastest rate changes, or the FIFO overruns and
+  *          samples go missing, sampling starts over: each subscriber's next block has first_sample 0 and a new
+  *          start time.
+  *
+  *          Blocks are delivered from the app loop, not from an interrupt, so a callback can do anything a face's
+  *          loop function can, including unsubscribing. Keep it quick all the same: at 200 Hz there's a new block
+  *          every 120 ms.
+  *
+  *          In low energy mode, INT1 wakes the watch through the RTC instead, since sleep turns off the EIC, and
+  *          Movement reads the FIFO out from its sleep loop without waking the rest of the watch. Samples keep
+  *          coming, and callbacks keep getting called, whether or not the watch is asleep.
+  *
+  *          The service owns the accelerometer and A4 while anyone is subscribed; don't use it alongside faces that
+  *          set the LIS2DW up themselves, like accel_interrupt_count_face.
+  */
+
+// the most subscribers at once.
+#ifndef MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS
+#define MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS 4
+#endif
+
+// how many samples wait in the FIFO before the accelerometer wakes us up to read them (1-31). higher means fewer
+// wakeups; it has to leave room for the samples that come in while we're waking up.
+#ifndef MOVEMENT_ACCELEROMETER_WATERMARK
+#define MOVEMENT_ACCELEROMETER_WATERMARK 24
+#endif
+
+// how the accelerometer is set up for everybody: ±4 g in its lowest power 14-bit mode, with low noise on.
+#ifndef MOVEMENT_ACCELEROMETER_RANGE
+#define MOVEMENT_ACCELEROMETER_RANGE LIS2DW_RANGE_4_G
+#endif
+#ifndef MOVEMENT_ACCELEROMETER_LOW_POWER_MODE
+#define MOVEMENT_ACCELEROMETER_LOW_POWER_MODE LIS2DW_LP_MODE_2
+#endif
+#ifndef MOVEMENT_ACCELEROMETER_FILTER
+#define MOVEMENT_ACCELEROMETER_FILTER LIS2DW_BANDWIDTH_FILTER_DIV2
+#endif
+#ifndef MOVEMENT_ACCELEROMETER_LOW_NOISE
+#define MOVEMENT_ACCELEROMETER_LOW_NOISE true
+#endif
+
+/// @brief A run of consecutive samples for one subscriber.
+typedef struct {
+    watch_date_time start;          // about when this subscriber's sample 0 was taken.
+    uint32_t first_sample;          // the number of readings[0], counting from 0 at start.
+    uint32_t sample_period_us;      // the time between samples at this subscriber's rate: 80000 at 12.5 Hz, 5000 at 200 Hz.
+    lis2dw_range_t range;           // the full scale the readings are relative to.
+    bool overrun;                   // the FIFO filled up before we got to it, so some samples before this block were lost,
+                                    // and the count has started over.
+    uint8_t count;                  // the number of readings, up to 32.
+    const lis2dw_reading_t *readings;
+} movement_accelerometer_block_t;
+
+/** @brief Receives samples from the accelerometer.
+  * @param block the samples; they're only valid until the callback returns.
+  * @param user_data whatever was passed to movement_accelerometer_subscribe.
+  */
+typedef void (*movement_accelerometer_callback_t)(const movement_accelerometer_block_t *block, void *user_data);
+
+/** @brief Starts sending samples to a callback, powering up the accelerometer if need be.
+  * @param data_rate LIS2DW_DATA_RATE_12_5_HZ to LIS2DW_DATA_RATE_200_HZ.
+  * @param callback called from the app loop with each block of samples.
+  * @param user_data passed to callback, and together with it identifies the subscription.
+  * @return true if subscribed; false if the rate isn't supported, there are already
+  *         MOVEMENT_ACCELEROMETER_MAX_SUBSCRIBERS, or there's no accelerometer. Subscribing again with the same
+  *         callback and user_data changes the rate.
+  */
+bool movement_accelerometer_subscribe(lis2dw_data_rate_t data_rate, movement_accelerometer_callback_t callback, void *user_data);
+
+/** @brief Stops sending samples to a callback. When the last subscriber goes, so does the accelerometer's power.
+  * @details Samples still waiting in the FIFO are not delivered; they're at most a watermark's worth.
+  */
+void movement_accelerometer_unsubscribe(movement_accelerometer_callback_t callback, void *user_data);
+
+/** @brief Reads out the FIFO in low energy mode. Movement calls this each time around its sleep loop, before it
+  *        goes back to sleep; the first time, it moves INT1 over to the RTC so that it can wake the watch.
+  */
+void movement_accelerometer_sleep_task(void);
+
+/** @brief Picks the accelerometer back up after low energy mode, which turns off the I2C bus and the external
+  *        interrupts. Movement calls this when it wakes up; it does nothing if nobody's subscribed.
+  */
+void movement_accelerometer_wake(void);
+
+/** @brief Reads out the FIFO if the accelerometer has asked for it. Movement calls this from its app loop.
+  * @return true if the watch can go back to sleep; false if there's more to read already.
+  */
+bool movement_accelerometer_task(void);
+
+#endif // MOVEMENT_ACCELEROMETER_H_
@@ -124,6 +124,7 @@
 #include "accel_interrupt_count_face.h"
 #include "metronome_face.h"
 #include "smallchess_face.h"
+#include "pedometer_face.h"
 // New includes go above this line.
 
 #endif // MOVEMENT_FACES_H_
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <string.h>
+#include "pedometer.h"
+
+// the samples come in at 1 g = 8192 (±4 g in 16 bits); we work in 1 g = 512, which is all the precision the
+// accelerometer has in its low power mode anyway, and leaves plenty of headroom.
+#define PEDOMETER_SHIFT 4
+
+// the least a step's bounce can be, in g / 512: about 0.04 g. anything smaller is jitter.
+#define PEDOMETER_MIN_THRESHOLD 20
+// a quarter second to two seconds between steps; faster than four a second is shaking, and slower than one
+// every two seconds is standing around.
+#define PEDOMETER_MIN_INTERVAL (PEDOMETER_SAMPLES_PER_SECOND / 4)
+#define PEDOMETER_MAX_INTERVAL (PEDOMETER_SAMPLES_PER_SECOND * 2)
+
+static inline int16_t _pedometer_abs(int16_t value) {
+    return value < 0 ? -value : value;
+}
+
+// the length of the vector, to within a few percent: the biggest component, plus 3/8 of the other two. it's
+// exact along an axis, and 1% high on a diagonal.
+static int16_t _pedometer_magnitude(const lis2dw_reading_t *reading) {
+    int16_t a = _pedometer_abs(reading->x >> PEDOMETER_SHIFT);
+    int16_t b = _pedometer_abs(reading->y >> PEDOMETER_SHIFT);
+    int16_t c = _pedometer_abs(reading->z >> PEDOMETER_SHIFT);
+    int16_t t;
+
+    if (b > a) { t = a; a = b; b = t; }
+    if (c > a) { t = a; a = c; c = t; }
+    return a + (((b + c) * 3) >> 3);
+}
+
+void pedometer_init(pedometer_t *pedometer) {
+    memset(pedometer, 0, sizeof(pedometer_t));
+    pedometer->threshold = PEDOMETER_MIN_THRESHOLD;
+    pedometer->since_step = 255;
+}
+
+// after a pause, we need a fresh run of steps to believe it again, and the threshold goes back to the bottom.
+static void _pedometer_stop(pedometer_t *pedometer) {
+    pedometer->pending = 0;
+    pedometer->walking = false;
+    pedometer->peak_average = 0;
+    pedometer->threshold = PEDOMETER_MIN_THRESHOLD;
+}
+
+// returns the number of steps to count for this step: none if it's one of the first few, all of them if it's
+// the one that convinces us, and one after that.
+static uint16_t _pedometer_step(pedometer_t *pedometer) {
+    if (pedometer->since_step < PEDOMETER_MIN_INTERVAL) return 0;
+    if (pedometer->since_step > PEDOMETER_MAX_INTERVAL) _pedometer_stop(pedometer);
+    pedometer->since_step = 0;
+
+    // 3/8 of the recent peaks' average: high enough to ignore the wobbles in between, and low enough that an
+    // arm swinging one way on one step and the other way on the next doesn't hide every other step.
+    pedometer->peak_average += (pedometer->peak - pedometer->peak_average) >> 2;
+    pedometer->threshold = (pedometer->peak_average * 3) >> 3;
+    if (pedometer->threshold < PEDOMETER_MIN_THRESHOLD) pedometer->threshold = PEDOMETER_MIN_THRESHOLD;
+
+    if (pedometer->walking) return 1;
+    if (++pedometer->pending < PEDOMETER_STEPS_TO_START) return 0;
+    pedometer->walking = true;
+    return pedometer->pending;
+}
+
+uint16_t pedometer_add_samples(pedometer_t *pedometer, const lis2dw_reading_t *readings, uint8_t count) {
+    uint16_t steps = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        int16_t magnitude = _pedometer_magnitude(&readings[i]);
+        if (!pedometer->started) {
+            pedometer->baseline = (int32_t)magnitude << 4;
+            pedometer->started = true;
+        }
+
+        // high pass: take away a running average over about 16 samples, which cuts off at about 0.25 Hz.
+        pedometer->baseline += magnitude - (pedometer->baseline >> 4);
+        int16_t value = magnitude - (pedometer->baseline >> 4);
+        // low pass: average the last four, which cuts off at a little over 3 Hz.
+        pedometer->window_sum += value - pedometer->window[pedometer->window_pos];
+        pedometer->window[pedometer->window_pos] = value;
+        pedometer->window_pos = (pedometer->window_pos + 1) & 3;
+        value = pedometer->window_sum >> 2;
+
+        if (pedometer->since_step < 255) pedometer->since_step++;
+        if (pedometer->walking && pedometer->since_step > PEDOMETER_MAX_INTERVAL) _pedometer_stop(pedometer);
+
+        if (!pedometer->rising) {
+            if (value > pedometer->threshold) {
+                pedometer->rising = true;
+                pedometer->peak = value;
+            }
+        } else if (value > pedometer->peak) {
+            pedometer->peak = value;
+        } else if (value < 0) {
+            pedometer->rising = false;
+            steps += _pedometer_step(pedometer);
+        }
+    }
+
+    return steps;
+}
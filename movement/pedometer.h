@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef PEDOMETER_H_
+#define PEDOMETER_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include "lis2dw.h"
+
+/** @brief Counts steps in a stream of accelerometer readings, with integer arithmetic only.
+  * @details Feed it the readings from a movement_accelerometer subscription at PEDOMETER_DATA_RATE and
+  *          MOVEMENT_ACCELEROMETER_RANGE, a block at a time. For each sample it:
+  *
+  *          1. takes the length of the acceleration vector, so it doesn't matter how the watch is turned;
+  *          2. band-passes it, subtracting a slow running average to take out gravity, and averaging the
+  *             last four samples to take out jitter. What's left is roughly 0.3 to 3 Hz: a step's bounce;
+  *          3. counts a step each time that swings up past a threshold and back down through zero, with the
+  *             threshold following the height of recent peaks so that it works for strolls and runs;
+  *          4. only believes the steps once PEDOMETER_STEPS_TO_START of them come at a walking pace, one every
+  *             quarter second to two seconds. Then it counts them all, including those first few. Waving your
+  *             arm about, typing or clapping rarely keeps up a steady rhythm for that long.
+  *
+  *          It costs a few dozen instructions per sample and about 32 bytes of state.
+  */
+
+// the rate the pedometer expects its samples at. the filters are tuned for it.
+#define PEDOMETER_DATA_RATE LIS2DW_DATA_RATE_25_HZ
+#define PEDOMETER_SAMPLES_PER_SECOND 25
+
+// how many steps in a row, at a walking pace, before we believe someone's walking.
+#ifndef PEDOMETER_STEPS_TO_START
+#define PEDOMETER_STEPS_TO_START 6
+#endif
+
+typedef struct {
+    int32_t baseline;       // the slow average of the magnitude, times 16; that's gravity, more or less.
+    int16_t window[4];      // the last four samples after subtracting the baseline
+    int16_t window_sum;
+    uint8_t window_pos;
+    int16_t threshold;      // how far the filtered signal has to rise to count as a step.
+    int16_t peak;           // the highest it's gone since it rose past the threshold.
+    int16_t peak_average;
+    uint8_t since_step;     // samples since the last step, up to 255.
+    uint8_t pending;        // steps in a row we've seen, but not counted yet.
+    bool rising;            // true from when the signal passes the threshold until it falls back through zero.
+    bool walking;           // true once we've counted the pending steps; steps count straight away until a pause.
+    bool started;
+} pedometer_t;
+
+/** @brief Gets a pedometer ready to count, or starts it over. */
+void pedometer_init(pedometer_t *pedometer);
+
+/** @brief Runs a block of samples through the pedometer.
+  * @param pedometer the pedometer
+  * @param readings count readings, oldest first, in the LIS2DW's raw units at ±4 g.
+  * @param count the number of readings
+  * @return how many steps to add to the count: the steps in these samples, plus, when walking starts, the
+  *         steps it took to be sure of it.
+  */
+uint16_t pedometer_add_samples(pedometer_t *pedometer, const lis2dw_reading_t *readings, uint8_t count);
+
+#endif // PEDOMETER_H_
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+#include "resources.h"
+
+#ifdef RESOURCE_PACK_ADDR
+#define resource_pack ((const uint8_t *)(RESOURCE_PACK_ADDR))
+#else
+#include "resource_pack.h"
+#endif
+
+#define RESOURCE_PACK_MAGIC 0x43525352 // 'RSRC'
+#define RESOURCE_PACK_VERSION 1
+
+// the layout that make_resource_pack.py writes. the pack is 4-byte aligned, so these can be read in place.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+} resource_pack_header_t;
+
+typedef struct {
+    char name[RESOURCE_NAME_SIZE];
+    uint32_t offset;
+    uint32_t size;
+    uint16_t record_size;
+    uint16_t reserved;
+} resource_pack_entry_t;
+
+static const resource_pack_header_t *_resource_pack_header(void) {
+    const resource_pack_header_t *header = (const resource_pack_header_t *)resource_pack;
+    if (header->magic != RESOURCE_PACK_MAGIC || header->version != RESOURCE_PACK_VERSION) return NULL;
+    return header;
+}
+
+static const resource_pack_entry_t *_resource_pack_entry(uint16_t index) {
+    return (const resource_pack_entry_t *)(resource_pack + sizeof(resource_pack_header_t)) + index;
+}
+
+static void _resource_fill(const resource_pack_entry_t *entry, resource_t *resource) {
+    resource->name = entry->name;
+    resource->data = resource_pack + entry->offset;
+    resource->size = entry->size;
+    resource->record_size = entry->record_size;
+}
+
+uint16_t resource_pack_count(void) {
+    const resource_pack_header_t *header = _resource_pack_header();
+    return header ? header->count : 0;
+}
+
+bool resource_get(uint16_t index, resource_t *resource) {
+    if (index >= resource_pack_count()) return false;
+    _resource_fill(_resource_pack_entry(index), resource);
+    return true;
+}
+
+bool resource_find(const char *name, resource_t *resource) {
+    // the index is sorted by name.
+    uint16_t low = 0;
+    uint16_t high = resource_pack_count();
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        const resource_pack_entry_t *entry = _resource_pack_entry(mid);
+        int comparison = strncmp(name, entry->name, RESOURCE_NAME_SIZE);
+        if (comparison == 0) {
+            _resource_fill(entry, resource);
+            return true;
+        }
+        if (comparison < 0) high = mid;
+        else low = mid + 1;
+    }
+    return false;
+}
+
+const void *resource_next_record(const resource_t *resource, const void *record) {
+    if (resource->record_size == 0) return NULL;
+    const uint8_t *next = record ? (const uint8_t *)record + resource->record_size : resource->data;
+    if (next + resource->record_size > resource->data + resource->size) return NULL;
+    return next;
+}
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef RESOURCES_H_
+#define RESOURCES_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Constant data that ships in a resource pack, rather than as tables compiled into a face.
+  * @details The pack is built from the files in movement/resources by utils/make_resource_pack.py. It sits in
+  *          flash, which the SAM L22 maps into its address space, so a resource is never copied into RAM: looking
+  *          one up gets you a pointer straight into the pack. A resource can be a plain blob, or an array of
+  *          fixed-size records (like a word list), which you can index or walk through one record at a time.
+  *
+  *          By default the pack is linked into the firmware. Define RESOURCE_PACK_ADDR to read it from that address
+  *          instead, if you'd rather program it into a dedicated region of flash (make_resource_pack.py --bin writes
+  *          the raw pack for that).
+  */
+
+#define RESOURCE_NAME_SIZE 16
+
+typedef struct {
+    const char *name;
+    const uint8_t *data;    // points into the pack; don't write to it.
+    uint32_t size;          // in bytes
+    uint16_t record_size;   // the size of each record, or 0 if the resource is a plain blob.
+} resource_t;
+
+/** @brief Looks up a resource by name.
+  * @param name the resource's name: the name of the file it was built from, without its extension.
+  * @param resource filled in with the resource, if there is one by that name.
+  * @return true if the resource was found; false if not, or if there's no valid pack.
+  */
+bool resource_find(const char *name, resource_t *resource);
+
+/** @brief Gets a resource by its position in the pack, for listing them all.
+  * @param index from 0 to resource_pack_count() - 1
+  * @param resource filled in with the resource
+  * @return true if there is a resource at that index.
+  */
+bool resource_get(uint16_t index, resource_t *resource);
+
+/// @brief Returns the number of resources in the pack, or 0 if there's no valid pack.
+uint16_t resource_pack_count(void);
+
+/// @brief Returns the number of records in a resource, or 0 if it isn't made of records.
+static inline uint32_t resource_record_count(const resource_t *resource) {
+    return resource->record_size ? resource->size / resource->record_size : 0;
+}
+
+/// @brief Returns a pointer to one of a resource's records. The index must be less than resource_record_count.
+static inline const void *resource_record(const resource_t *resource, uint32_t index) {
+    return resource->data + index * resource->record_size;
+}
+
+/** @brief Steps through a resource's records, without having to keep an index yourself.
+  * @param resource the resource to walk through
+  * @param record NULL to get the first record, or the record this returned last time.
+  * @return the next record, or NULL once there are no more.
+  */
+const void *resource_next_record(const resource_t *resource, const void *record);
+
+#endif // RESOURCES_H_
@@ -48,11 +48,49 @@ extern const size_t g_num_shell_commands;
 #define SHELL_MAX_ARGS  (16)
 #define SHELL_PROMPT  "swsh> "
 
+// how many characters shell_task takes from the USB serial each time it's called, so that a long paste is edited
+// over several trips around the app loop rather than all in one.
+#ifndef SHELL_MAX_CHARS_PER_TASK
+#define SHELL_MAX_CHARS_PER_TASK  (64)
+#endif
+
+// room for the command history, as NUL-terminated lines one after another, oldest first.
+#ifndef SHELL_HISTORY_SZ
+#define SHELL_HISTORY_SZ  (256)
+#endif
+
+// lines longer than this (like the blk lines of a file upload) are left out of the history, so that a transfer
+// doesn't push out everything typed by hand.
+#define SHELL_HISTORY_MAX_LINE  (SHELL_HISTORY_SZ / 4)
+
+#define CTRL(c)  ((c) & 0x1f)
+#define DEL  (0x7f)
+#define ESC  (0x1b)
+
+typedef enum {
+    SHELL_INPUT_NORMAL,
+    SHELL_INPUT_ESC,      // got ESC; expecting [ or O
+    SHELL_INPUT_CSI,      // got ESC [ (or ESC O); the next character says which key it was
+} shell_input_state_t;
+
 static char s_buf[SHELL_BUF_SZ] = {0};
 static size_t s_buf_len = 0;
 // Pointer to the first invalid byte after the end of input.
 static char *const s_buf_end = s_buf + SHELL_BUF_SZ;
 
+static shell_input_state_t s_input_state = SHELL_INPUT_NORMAL;
+// the last character was a carriage return, so a line feed right after it doesn't end a second, empty line.
+static bool s_after_cr = false;
+
+static char s_history[SHELL_HISTORY_SZ];
+static size_t s_history_len = 0;
+// the offset in s_history of the line being shown, or s_history_len when it's a new line.
+static size_t s_history_pos = 0;
+
+// the next step of a command that's still running, and what to pass it.
+static shell_step_t s_step = NULL;
+static void *s_step_user_data = NULL;
+
 static char *prv_skip_whitespace(char *c) {
     while (c >= s_buf && c < s_buf_end) {
         if (*c == 0) {
@@ -151,7 +189,220 @@ static int prv_handle_command() {
     return -1;
 }
 
+void shell_continue(shell_step_t step, void *user_data) {
+    s_step = step;
+    s_step_user_data = user_data;
+}
+
+bool shell_is_busy(void) {
+    return s_step != NULL;
+}
+
+// runs one step of the command that's running, and prompts for the next once it's done.
+static void prv_run_step(void) {
+    shell_step_t step = s_step;
+    s_step = NULL;
+    if (step(s_step_user_data)) {
+        // it wants another go, unless it started something else in its place.
+        if (s_step == NULL) s_step = step;
+        return;
+    }
+    if (s_step == NULL) printf(NEWLINE SHELL_PROMPT);
+}
+
+static void prv_history_add(const char *line, size_t len) {
+    if (len == 0 || len > SHELL_HISTORY_MAX_LINE) return;
+
+    // don't fill the history with the same line over and over.
+    if (s_history_len > 0) {
+        size_t last = s_history_len - 1;
+        while (last > 0 && s_history[last - 1] != '\0') last--;
+        if (strlen(&s_history[last]) == len && strncmp(&s_history[last], line, len) == 0) return;
+    }
+
+    // make room by dropping the oldest lines.
+    while (s_history_len + len + 1 > SHELL_HISTORY_SZ) {
+        size_t oldest = strlen(s_history) + 1;
+        memmove(s_history, s_history + oldest, s_history_len - oldest);
+        s_history_len -= oldest;
+    }
+
+    memcpy(&s_history[s_history_len], line, len);
+    s_history_len += len;
+    s_history[s_history_len++] = '\0';
+}
+
+// replaces the line being edited with another one, on the screen too.
+static void prv_replace_line(const char *line, size_t len) {
+    memcpy(s_buf, line, len);
+    s_buf_len = len;
+    // carriage return, prompt, the new line, and erase whatever's left of the old one.
+    printf("\r" SHELL_PROMPT "%.*s\x1b[K", (int) len, s_buf);
+}
+
+static void prv_history_up(void) {
+    if (s_history_pos == 0) {
+        putchar('\a');
+        return;
+    }
+    // back up over the terminator of the line before, then to its start.
+    s_history_pos--;
+    while (s_history_pos > 0 && s_history[s_history_pos - 1] != '\0') s_history_pos--;
+    prv_replace_line(&s_history[s_history_pos], strlen(&s_history[s_history_pos]));
+}
+
+static void prv_history_down(void) {
+    if (s_history_pos == s_history_len) {
+        putchar('\a');
+        return;
+    }
+    s_history_pos += strlen(&s_history[s_history_pos]) + 1;
+    if (s_history_pos == s_history_len) {
+        prv_replace_line("", 0);
+    } else {
+        prv_replace_line(&s_history[s_history_pos], strlen(&s_history[s_history_pos]));
+    }
+}
+
+// completes the command name being typed from g_shell_commands: all the way if only one matches, or as far as
+// they agree. when that's no further, lists the ones that match.
+static void prv_complete(void) {
+    if (memchr(s_buf, ' ', s_buf_len) != NULL) {
+        // only command names are completed.
+        putchar('\a');
+        return;
+    }
+
+    const char *first_match = NULL;
+    size_t num_matches = 0;
+    size_t common_len = 0;
+    for (size_t i = 0; i < g_num_shell_commands; i++) {
+        const char *name = g_shell_commands[i].name;
+        if (strncmp(name, s_buf, s_buf_len) != 0) continue;
+        if (num_matches++ == 0) {
+            first_match = name;
+            common_len = strlen(name);
+        } else {
+            size_t j = s_buf_len;
+            while (j < common_len && name[j] == first_match[j]) j++;
+            common_len = j;
+        }
+    }
+
+    if (num_matches == 0) {
+        putchar('\a');
+    } else if (common_len > s_buf_len || num_matches == 1) {
+        size_t len = min(common_len, SHELL_BUF_SZ - 2);
+        printf("%.*s", (int) (len - s_buf_len), &first_match[s_buf_len]);
+        memcpy(&s_buf[s_buf_len], &first_match[s_buf_len], len - s_buf_len);
+        s_buf_len = len;
+        if (num_matches == 1) {
+            putchar(' ');
+            s_buf[s_buf_len++] = ' ';
+        }
+    } else {
+        printf(NEWLINE);
+        for (size_t i = 0; i < g_num_shell_commands; i++) {
+            if (strncmp(g_shell_commands[i].name, s_buf, s_buf_len) == 0) printf("%s  ", g_shell_commands[i].name);
+        }
+        printf(NEWLINE SHELL_PROMPT "%.*s", (int) s_buf_len, s_buf);
+    }
+}
+
+static void prv_end_line(void) {
+    prv_history_add(s_buf, s_buf_len);
+    s_history_pos = s_history_len;
+
+    s_buf[s_buf_len] = '\0';
+    (void) prv_handle_command();
+    s_buf_len = 0;
+    // a command that's still running prompts when it's done.
+    if (s_step == NULL) printf(NEWLINE SHELL_PROMPT);
+}
+
+// handles one character of input. returns true if it ended a line.
+static bool prv_handle_char(int c) {
+    bool after_cr = s_after_cr;
+    s_after_cr = false;
+
+    switch (s_input_state) {
+        case SHELL_INPUT_ESC:
+            s_input_state = (c == '[' || c == 'O') ? SHELL_INPUT_CSI : SHELL_INPUT_NORMAL;
+            return false;
+        case SHELL_INPUT_CSI:
+            // keep going through the parameters of a longer sequence, like ESC [ 3 ~ for delete.
+            if (c >= 0x20 && c < 0x40) return false;
+            s_input_state = SHELL_INPUT_NORMAL;
+            if (c == 'A') prv_history_up();
+            if (c == 'B') prv_history_down();
+            // left and right, and the rest, aren't supported; the cursor stays at the end of the line.
+            return false;
+        case SHELL_INPUT_NORMAL:
+            break;
+    }
+
+    switch (c) {
+        case '\r':
+            s_after_cr = true;
+            prv_end_line();
+            return true;
+        case '\n':
+            if (after_cr) return false;
+            prv_end_line();
+            return true;
+        case '\b':
+        case DEL:
+            // We need to emit a backspace, overwrite the character on the
+            // screen with a space, and then backspace again to move the cursor.
+            if (s_buf_len > 0) {
+                printf("\b \b");
+                s_buf_len--;
+            }
+            return false;
+        case '\t':
+            prv_complete();
+            return false;
+        case ESC:
+            s_input_state = SHELL_INPUT_ESC;
+            return false;
+        case CTRL('p'):
+            prv_history_up();
+            return false;
+        case CTRL('n'):
+            prv_history_down();
+            return false;
+        case CTRL('u'):
+            prv_replace_line("", 0);
+            return false;
+        case CTRL('c'):
+            printf("^C" NEWLINE SHELL_PROMPT);
+            s_buf_len = 0;
+            s_history_pos = s_history_len;
+            return false;
+        default:
+            break;
+    }
+
+    if (!isprint(c)) return false;
+    if (s_buf_len >= (SHELL_BUF_SZ - 1)) {
+        printf(NEWLINE "Command too long, clearing.");
+        printf(NEWLINE SHELL_PROMPT);
+        s_buf_len = 0;
+        return false;
+    }
+    // Print regular characters to the screen.
+    putchar(c);
+    s_buf[s_buf_len++] = c;
+    return false;
+}
+
 void shell_task(void) {
+    if (s_step != NULL) {
+        // a command is still running. give it another go, and leave any typing waiting until it's done.
+        prv_run_step();
+        return;
+    }
+
 #if __EMSCRIPTEN__
     // This is a terrible hack; ideally this should be handled deeper in the watch library.
     // Alas, emscripten treats read() as something that should pop up an input box, so I
@@ -170,19 +421,13 @@ void shell_task(void) {
     s_buf[s_buf_len++] = '\n';
     s_buf[s_buf_len++] = '\0';
     prv_handle_command();
+    s_buf_len = 0;
     EM_ASM({
         tx = "";
     });
 #else
-    // Read one character at a time until we run out.
-    while (true) {
-        if (s_buf_len >= (SHELL_BUF_SZ - 1)) {
-            printf(NEWLINE "Command too long, clearing.");
-            printf(NEWLINE SHELL_PROMPT);
-            s_buf_len = 0;
-            break;
-        }
-
+    // take what's waiting, a few characters at a time, and stop after a command so that it runs on a trip of its own.
+    for (int i = 0; i < SHELL_MAX_CHARS_PER_TASK; i++) {
         int c = getchar();
 
         if (c < 0) {
@@ -190,32 +435,7 @@ void shell_task(void) {
             break;
         }
 
-        if (c == '\b') {
-            // Handle backspace character.
-            // We need to emit a backspace, overwrite the character on the
-            // screen with a space, and then backspace again to move the cursor.
-            if (s_buf_len > 0) {
-                printf("\b \b");
-                s_buf_len--;
-            }
-            continue;
-        } else if (c != '\n' && c != '\r') {
-            // Print regular characters to the screen.
-            putchar(c);
-        }
-
-        s_buf[s_buf_len] = c;
-
-        if (c == '\n' || c == '\r') {
-            // Newline! Handle the command.
-            s_buf[s_buf_len+1] = '\0';
-            (void) prv_handle_command();
-            s_buf_len = 0;
-            printf(NEWLINE SHELL_PROMPT);
-            break;
-        } else {
-            s_buf_len++;
-        }
+        if (prv_handle_char(c)) break;
     }
 #endif
 }
@@ -25,10 +25,34 @@
 #ifndef SHELL_H_
 #define SHELL_H_
 
+#include <stdbool.h>
+
+/** @brief One step of a command that takes a while; see shell_continue.
+ *  @param user_data whatever the command passed to shell_continue.
+ *  @return true if there's more to do, or false when the command is done.
+ */
+typedef bool (*shell_step_t)(void *user_data);
+
 /** @brief Called periodically from the app loop to handle shell commands.
- *         When a full command is complete, parses and executes its matching
- *         callback.
+ *         Takes a few characters of input at a time, with line editing,
+ *         history (up and down arrows, or Ctrl-P and Ctrl-N) and tab
+ *         completion of command names. When a full command is complete,
+ *         parses and executes its matching callback.
  */
 void shell_task(void);
 
+/** @brief Lets a command keep going after its callback returns, so that it
+ *         doesn't hold up the app loop. Call this from the callback, and
+ *         shell_task will call step once each time around the loop until it
+ *         returns false; only then does the shell prompt for the next command.
+ *         Do a bounded amount of work in each step, like a few hundred bytes
+ *         of output.
+ */
+void shell_continue(shell_step_t step, void *user_data);
+
+/** @brief Returns true while a command is running in steps; the app loop
+ *         stays awake until it's done.
+ */
+bool shell_is_busy(void);
+
 #endif
@@ -27,13 +27,19 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "filesystem.h"
+#include "file_transfer.h"
+#include "movement.h"
+#include "shell.h"
 #include "watch.h"
 
 static int help_cmd(int argc, char *argv[]);
 static int flash_cmd(int argc, char *argv[]);
+static int cat_cmd(int argc, char *argv[]);
 static int stress_cmd(int argc, char *argv[]);
+static int usbstat_cmd(int argc, char *argv[]);
 
 shell_command_t g_shell_commands[] = {
     {
@@ -69,7 +75,7 @@ shell_command_t g_shell_commands[] = {
         .help = "usage: cat <PATH>",
         .min_args = 1,
         .max_args = 1,
-        .cb = filesystem_cmd_cat,
+        .cb = cat_cmd,
     },
     {
         .name = "df",
@@ -99,6 +105,34 @@ shell_command_t g_shell_commands[] = {
         .max_args = 3,
         .cb = filesystem_cmd_echo,
     },
+    {
+        .name = "put",
+        .help = "upload a file; usage: put <FILE> <SIZE> <CRC>, then blk (see utils/shell_transfer.py)",
+        .min_args = 3,
+        .max_args = 3,
+        .cb = file_transfer_cmd_put,
+    },
+    {
+        .name = "blk",
+        .help = "usage: blk <OFFSET> <BASE64> <CRC>",
+        .min_args = 3,
+        .max_args = 3,
+        .cb = file_transfer_cmd_blk,
+    },
+    {
+        .name = "get",
+        .help = "download a file; usage: get <FILE> [OFFSET]",
+        .min_args = 1,
+        .max_args = 2,
+        .cb = file_transfer_cmd_get,
+    },
+    {
+        .name = "dump",
+        .help = "print a face's log as CSV; usage: dump [FACE_INDEX]",
+        .min_args = 0,
+        .max_args = 1,
+        .cb = movement_cmd_dump,
+    },
     {
         .name = "stress",
         .help = "test CDC write; usage: stress [LEN] [DELAY_MS]",
@@ -106,6 +140,13 @@ shell_command_t g_shell_commands[] = {
         .max_args = 2,
         .cb = stress_cmd,
     },
+    {
+        .name = "usbstat",
+        .help = "print USB serial throughput",
+        .min_args = 0,
+        .max_args = 0,
+        .cb = usbstat_cmd,
+    },
 };
 
 const size_t g_num_shell_commands = sizeof(g_shell_commands) / sizeof(shell_command_t);
@@ -133,10 +174,62 @@ static int flash_cmd(int argc, char *argv[]) {
     return 0;
 }
 
+// cat sends a few hundred bytes each time around the app loop, so a big file doesn't hold up the watch face.
+#define CAT_CMD_BYTES_PER_STEP  (256)
+static filesystem_reader_t cat_reader;
+
+static bool cat_step(void *user_data) {
+    (void) user_data;
+    char buf[64];
+    int32_t bytes_read = 0;
+
+    for (int i = 0; i < CAT_CMD_BYTES_PER_STEP / (int) sizeof(buf); i++) {
+        bytes_read = filesystem_read(&cat_reader, buf, sizeof(buf));
+        if (bytes_read > 0) fwrite(buf, 1, bytes_read, stdout);
+        if (bytes_read < (int32_t) sizeof(buf)) break;
+    }
+    if (bytes_read == (int32_t) sizeof(buf)) return true;
+
+    filesystem_close(&cat_reader);
+    printf("\r\n");
+    return false;
+}
+
+static int cat_cmd(int argc, char *argv[]) {
+    (void) argc;
+
+    if (!filesystem_file_exists(argv[1]) || !filesystem_open(&cat_reader, argv[1])) {
+        printf("cat: %s: No such file\r\n", argv[1]);
+        return 0;
+    }
+    shell_continue(cat_step, NULL);
+
+    return 0;
+}
+
 #define STRESS_CMD_MAX_LEN  (512)
-static int stress_cmd(int argc, char *argv[]) {
-    char test_str[STRESS_CMD_MAX_LEN+1] = {0};
+static struct {
+    char test_str[STRESS_CMD_MAX_LEN+1];
+    int i;
+    int max_len;
+    int delay;
+} stress_state;
+
+// one line each time around the app loop.
+static bool stress_step(void *user_data) {
+    (void) user_data;
+    int i = stress_state.i++;
+
+    snprintf(&stress_state.test_str[i], 2, "%u", (i+1)%10);
+    printf("%u:\t%s\r\n", (i+1), stress_state.test_str);
+    if (stress_state.delay > 0) {
+        delay_ms(stress_state.delay);
+    }
 
+    return stress_state.i < stress_state.max_len;
+}
+
+static int stress_cmd(int argc, char *argv[]) {
     int max_len = 512;
     int delay = 0;
 
@@ -153,13 +246,24 @@ static int stress_cmd(int argc, char *argv[]) {
         delay = atoi(argv[2]);
     }
 
-    for (int i = 0; i < max_len; i++) {
-        snprintf(&test_str[i], 2, "%u", (i+1)%10);
-        printf("%u:\t%s\r\n", (i+1), test_str);
-        if (delay > 0) {
-            delay_ms(delay);
-        }
-    }
+    memset(&stress_state, 0, sizeof(stress_state));
+    stress_state.max_len = max_len;
+    stress_state.delay = delay;
+    shell_continue(stress_step, NULL);
+
+    return 0;
+}
+
+static int usbstat_cmd(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+    watch_cdc_stats_t stats;
+
+    watch_cdc_get_stats(&stats);
+    printf("sent: %lu bytes\r\n", (unsigned long)stats.bytes_sent);
+    printf("dropped: %lu bytes\r\n", (unsigned long)stats.bytes_dropped);
+    printf("last second: %lu bytes/s\r\n", (unsigned long)stats.bytes_per_second);
+    printf("peak: %lu bytes/s\r\n", (unsigned long)stats.peak_bytes_per_second);
 
     return 0;
 }
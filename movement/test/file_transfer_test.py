@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+Round-trips files through the shell's put and get commands on the host build, with utils/shell_transfer.py on the
+other end: a clean upload and download, a garbled block, and an upload that's interrupted and picked up again.
+Run it from movement/make, after building with `make HOST=1 COLOR=GREEN`; `make HOST=1 COLOR=GREEN test` does both.
+
+The files are 4 KB rather than anything bigger, because the whole filesystem is only 8 KB.
+"""
+
+import base64
+import os
+import sys
+import zlib
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../../utils"))
+from shell_transfer import BLOCK_SIZE, ProcessLink, Transfer  # noqa: E402
+
+SIZE = 4096
+
+
+def check(condition, message):
+    if not condition:
+        print(f"{__file__}: {message}")
+        sys.exit(1)
+
+
+def main():
+    link = ProcessLink("build-host/watch -u")
+    transfer = Transfer(link)
+    data = os.urandom(SIZE)
+
+    try:
+        # there and back again.
+        transfer.put(data, "data.bin")
+        check(transfer.get("data.bin") == data, "downloaded file doesn't match the upload")
+        check(transfer.command("get data.bin.part")[0] == "err", "upload left its .part file behind")
+        link.write_line("rm data.bin")
+
+        # a garbled block is turned away, and the watch says where to carry on from.
+        word, args = transfer.command(f"put data.bin {SIZE} {zlib.crc32(data):08x}")
+        check((word, args) == ("ok", ["0"]), f"put replied {word} {args}")
+        block = data[:BLOCK_SIZE]
+        word, args = transfer.command(f"blk 0 {base64.b64encode(block).decode()} {zlib.crc32(block) ^ 1:08x}")
+        check((word, args) == ("err", ["crc", "0"]), f"garbled block got {word} {args}")
+
+        # send a few blocks and then "lose" the connection; putting the same file again picks up where it left off.
+        for offset in range(0, BLOCK_SIZE * 5, BLOCK_SIZE):
+            block = data[offset:offset + BLOCK_SIZE]
+            word, args = transfer.command(f"blk {offset} {base64.b64encode(block).decode()} {zlib.crc32(block):08x}")
+            check(word == "ok", f"block at {offset} got {word} {args}")
+        offsets = []
+        Transfer(link).put(data, "data.bin", lambda done, total: offsets.append(done))
+        check(offsets[0] == BLOCK_SIZE * 5, f"upload resumed from {offsets[0]}")
+        check(transfer.get("data.bin") == data, "resumed upload doesn't match")
+    finally:
+        link.close()
+
+    print(f"round-tripped {SIZE} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks that filesystem_get_free_space's cached answer matches a full count of the blocks in use, through a few
+// hundred random writes, appends and removals. it includes filesystem.c to get at the uncached count.
+// build and run it with `make HOST=1 COLOR=GREEN test` in movement/make.
+
+#include <stdlib.h>
+#include "filesystem.c"
+
+#define NUM_OPERATIONS 500
+#define NUM_FILES 6
+
+int main(void) {
+    static char contents[1024];
+    char filename[16];
+
+    if (!filesystem_init()) {
+        printf("couldn't mount the filesystem\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(contents); i++) contents[i] = 'a' + i % 26;
+    srand(1);
+
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        sprintf(filename, "file%d.txt", rand() % NUM_FILES);
+        switch (rand() % 3) {
+            case 0:
+                filesystem_write_file(filename, contents, rand() % sizeof(contents));
+                break;
+            case 1:
+                filesystem_append_file(filename, contents, 1 + rand() % 64);
+                break;
+            case 2:
+                if (filesystem_file_exists(filename)) filesystem_rm(filename);
+                break;
+        }
+
+        int32_t cached = filesystem_get_free_space();
+        int32_t counted = _filesystem_count_free_space();
+        if (cached != counted) {
+            printf("after %d operations, the cached free space was %ld bytes, but there were %ld\n", i + 1, (long)cached, (long)counted);
+            return 1;
+        }
+
+        // and asking again shouldn't need to touch the flash.
+        watch_host_get_storage_stats(true);
+        filesystem_get_free_space();
+        if (watch_host_get_storage_stats(true).reads) {
+            printf("after %d operations, asking for the free space twice read the flash twice\n", i + 1);
+            return 1;
+        }
+    }
+
+    printf("free space matched after %d operations\n", NUM_OPERATIONS);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks that kvstore keeps its values across a reload, compacts its file, skips damaged records, and doesn't write
+// values that haven't changed. build and run it with `make HOST=1 COLOR=GREEN test` in movement/make.
+
+#include <stdio.h>
+#include "filesystem.h"
+#include "kvstore.h"
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        return 1; \
+    } \
+} while (0)
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+} alarm_settings_t;
+
+int main(void) {
+    uint32_t u;
+    int32_t i;
+    float f;
+    alarm_settings_t alarm = { 7, 30, true };
+    alarm_settings_t loaded = { 0 };
+
+    CHECK(filesystem_init());
+    CHECK(kvstore_init());
+
+    // values come back as they went in, and only as the type they went in as.
+    CHECK(!kvstore_get_uint32("missing", &u));
+    CHECK(kvstore_set_uint32("count", 42));
+    CHECK(kvstore_set_int32("offset", -5));
+    CHECK(kvstore_set_float("temp", 21.5));
+    CHECK(kvstore_set_blob("alarm", &alarm, sizeof(alarm)));
+    CHECK(kvstore_get_uint32("count", &u) && u == 42);
+    CHECK(kvstore_get_int32("offset", &i) && i == -5);
+    CHECK(kvstore_get_float("temp", &f) && f == 21.5);
+    CHECK(!kvstore_get_int32("count", &i));
+    CHECK(!kvstore_get_blob("alarm", &loaded, sizeof(loaded) - 1));
+    CHECK(kvstore_get_blob("alarm", &loaded, sizeof(loaded)) && loaded.minute == 30);
+    CHECK(!kvstore_set_uint32("much_too_long", 1));
+    CHECK(!kvstore_set_blob("big", &alarm, KVSTORE_VALUE_SIZE + 1));
+
+    // setting a value to what it already is doesn't write anything.
+    int32_t size = filesystem_get_file_size("kvstore.bin");
+    CHECK(kvstore_set_uint32("count", 42));
+    CHECK(filesystem_get_file_size("kvstore.bin") == size);
+
+    // deleted keys stay deleted, and everything survives a reload.
+    CHECK(kvstore_delete("offset"));
+    CHECK(!kvstore_get_int32("offset", &i));
+    CHECK(kvstore_init());
+    CHECK(kvstore_get_uint32("count", &u) && u == 42);
+    CHECK(!kvstore_get_int32("offset", &i));
+    CHECK(kvstore_get_blob("alarm", &loaded, sizeof(loaded)) && loaded.hour == 7);
+
+    // the file never holds more than KVSTORE_MAX_KEYS stale records.
+    for (uint32_t n = 0; n < 500; n++) {
+        CHECK(kvstore_set_uint32("count", n));
+        CHECK(filesystem_get_file_size("kvstore.bin") <= (int32_t)(32 * (3 + KVSTORE_MAX_KEYS)));
+    }
+    CHECK(kvstore_init());
+    CHECK(kvstore_get_uint32("count", &u) && u == 499);
+
+    // the store fills up, but a key that's already in it can still change.
+    char key[KVSTORE_KEY_SIZE + 1];
+    for (uint32_t n = 0; n < KVSTORE_MAX_KEYS - 3; n++) {
+        sprintf(key, "key%lu", (unsigned long)n);
+        CHECK(kvstore_set_uint32(key, n));
+    }
+    CHECK(!kvstore_set_uint32("onemore", 1));
+    CHECK(kvstore_set_uint32("count", 1));
+
+    // a damaged record is skipped, a partial one at the end is dropped, and the rest are fine.
+    char garbage[40] = "not a record";
+    CHECK(filesystem_append_file("kvstore.bin", garbage, sizeof(garbage)));
+    CHECK(!kvstore_init());
+    CHECK(kvstore_get_uint32("count", &u) && u == 1);
+    CHECK(kvstore_get_uint32("key0", &u) && u == 0);
+    CHECK(filesystem_get_file_size("kvstore.bin") % 32 == 0);
+    CHECK(kvstore_init());
+
+    // once the flash is full, a change that can't be written doesn't stick in the cache either.
+    char filler[256] = { 0 };
+    for (int32_t chunk = sizeof(filler); chunk >= 16; chunk /= 2) {
+        while (filesystem_append_file("filler", filler, chunk));
+    }
+    CHECK(!kvstore_set_uint32("count", 2));
+    CHECK(!kvstore_delete("key0"));
+    CHECK(kvstore_get_uint32("count", &u) && u == 1);
+    CHECK(kvstore_get_uint32("key0", &u) && u == 0);
+    CHECK(filesystem_rm("filler"));
+    CHECK(kvstore_set_uint32("count", 2));
+    CHECK(kvstore_init());
+    CHECK(kvstore_get_uint32("count", &u) && u == 2);
+    CHECK(kvstore_get_uint32("key0", &u) && u == 0);
+
+    printf("kvstore passed\n");
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks the accelerometer service against the mock LIS2DW from the watch library's tests: that it sets up the
+// FIFO watermark, reads a block out in one burst when INT1 goes up, shares the samples out between subscribers at
+// different rates, keeps reading in low energy mode, and powers down after the last one leaves. build and run it with
+// `make HOST=1 COLOR=GREEN test` in movement/make.
+
+#include <stdio.h>
+#include <string.h>
+#include "movement_accelerometer.h"
+#include "lis2dw_mock.h"
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        return 1; \
+    } \
+} while (0)
+
+// just enough of the watch library for the service, besides the host's I2C bus: A4 wired to INT1, and a clock.
+static ext_irq_cb_t int1_callback;
+
+void watch_register_interrupt_callback(const uint8_t pin, ext_irq_cb_t callback, watch_interrupt_trigger trigger) {
+    (void)trigger;
+    if (pin == A4) int1_callback = callback;
+}
+
+// in low energy mode, INT1 wakes the watch through the RTC.
+static ext_irq_cb_t extwake_callback;
+
+void watch_register_extwake_callback(uint8_t pin, ext_irq_cb_t callback, bool level) {
+    (void)level;
+    if (pin == A4) extwake_callback = callback;
+}
+
+void watch_disable_extwake_interrupt(uint8_t pin) {
+    if (pin == A4) extwake_callback = NULL;
+}
+
+bool watch_get_pin_level(const uint8_t pin) {
+    return pin == A4 && lis2dw_mock_int1();
+}
+
+watch_date_time watch_rtc_get_date_time(void) {
+    watch_date_time date_time = {0};
+    return date_time;
+}
+
+// what a subscriber got: how many blocks, and the block it got last, with its first reading.
+typedef struct {
+    uint8_t blocks;
+    movement_accelerometer_block_t last;
+    lis2dw_reading_t readings[32];
+    // samples to add to the FIFO from inside the callback, as though they came in while we were busy.
+    uint8_t add_while_busy;
+} subscriber_t;
+
+static void _receive(const movement_accelerometer_block_t *block, void *user_data) {
+    subscriber_t *subscriber = (subscriber_t *)user_data;
+    subscriber->blocks++;
+    subscriber->last = *block;
+    memcpy(subscriber->readings, block->readings, block->count * sizeof(lis2dw_reading_t));
+    subscriber->last.readings = subscriber->readings;
+    if (subscriber->add_while_busy) {
+        lis2dw_mock_add_samples(subscriber->add_while_busy, 1000);
+        subscriber->add_while_busy = 0;
+    }
+}
+
+// like lis2dw_mock_check_samples, but for every stride'th sample from first.
+static bool _check_every(const subscriber_t *subscriber, uint8_t count, int16_t first, uint8_t stride) {
+    if (subscriber->last.count != count) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!lis2dw_mock_check_samples(&subscriber->readings[i], 1, first + i * stride)) return false;
+    }
+    return true;
+}
+
+// whether the service has the I2C bus turned on: if it's off, even WHO_AM_I doesn't answer.
+static bool _i2c_enabled(void) {
+    return watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_WHO_AM_I) == LIS2DW_WHO_AM_I_VAL;
+}
+
+// fills the FIFO up to the watermark and raises INT1, like the accelerometer would.
+static void _fill_and_interrupt(uint8_t count, int16_t first) {
+    lis2dw_mock_add_samples(count, first);
+    if (lis2dw_mock_int1() && int1_callback != NULL) int1_callback();
+}
+
+int main(void) {
+    subscriber_t fast = {0}, slow = {0};
+
+    lis2dw_mock_reset();
+
+    // nothing is subscribed, so there's nothing to do.
+    CHECK(movement_accelerometer_task());
+    CHECK(!movement_accelerometer_subscribe(LIS2DW_DATA_RATE_HP_400_HZ, _receive, &fast));
+    CHECK(!_i2c_enabled());
+
+    // the first subscriber powers it up with the watermark on INT1.
+    CHECK(movement_accelerometer_subscribe(LIS2DW_DATA_RATE_25_HZ, _receive, &fast));
+    CHECK(_i2c_enabled());
+    CHECK(int1_callback != NULL);
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_25_HZ);
+    CHECK((lis2dw_mock_register(LIS2DW_REG_CTRL1) >> 4) == LIS2DW_DATA_RATE_25_HZ);
+    CHECK(((lis2dw_mock_register(LIS2DW_REG_CTRL6) >> 4) & 0b11) == MOVEMENT_ACCELEROMETER_RANGE);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_FIFO_CTRL) == (LIS2DW_FIFO_CTRL_MODE_COLLECT_CONTINUOUS | MOVEMENT_ACCELEROMETER_WATERMARK));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL4_INT1) & LIS2DW_CTRL4_INT1_FTH);
+
+    // below the watermark, INT1 stays down and the task has nothing to do.
+    _fill_and_interrupt(MOVEMENT_ACCELEROMETER_WATERMARK - 1, 0);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.blocks == 0);
+
+    // at the watermark, the whole FIFO comes out in one burst: the status, and then the samples.
+    lis2dw_mock_transactions = 0;
+    _fill_and_interrupt(1, MOVEMENT_ACCELEROMETER_WATERMARK - 1);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.blocks == 1);
+    CHECK(fast.last.first_sample == 0);
+    CHECK(fast.last.sample_period_us == 40000);
+    CHECK(!fast.last.overrun);
+    CHECK(_check_every(&fast, MOVEMENT_ACCELEROMETER_WATERMARK, 0, 1));
+    CHECK(lis2dw_mock_transactions == 2);
+    CHECK(lis2dw_mock_fifo_count() == 0);
+
+    // a slower subscriber doesn't change the rate, or start the faster one over; it gets every other sample.
+    CHECK(movement_accelerometer_subscribe(LIS2DW_DATA_RATE_12_5_HZ, _receive, &slow));
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_25_HZ);
+    _fill_and_interrupt(25, 24);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.last.first_sample == 24);
+    CHECK(_check_every(&fast, 25, 24, 1));
+    CHECK(slow.last.first_sample == 0);
+    CHECK(slow.last.sample_period_us == 80000);
+    CHECK(_check_every(&slow, 13, 24, 2));
+
+    // an odd number of samples last time means the slow one skips the first of these.
+    _fill_and_interrupt(24, 49);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.last.first_sample == 49);
+    CHECK(slow.last.first_sample == 13);
+    CHECK(_check_every(&slow, 12, 50, 2));
+
+    // samples that reach the watermark again while we're busy keep INT1 up, so there's no new edge: the task says
+    // not to sleep, and reads them next time around without being asked.
+    fast.add_while_busy = MOVEMENT_ACCELEROMETER_WATERMARK;
+    _fill_and_interrupt(24, 73);
+    CHECK(!movement_accelerometer_task());
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.blocks == 5);
+    CHECK(fast.last.first_sample == 97);
+    CHECK(_check_every(&fast, MOVEMENT_ACCELEROMETER_WATERMARK, 1000, 1));
+
+    // if we don't get to the FIFO in time, the block says so, and since we don't know how many samples went
+    // missing, the count starts over.
+    _fill_and_interrupt(40, 0);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.last.overrun);
+    CHECK(fast.last.count == 32);
+    CHECK(fast.last.first_sample == 0);
+    CHECK(slow.last.first_sample == 0);
+
+    // sleep turns off the bus and the EIC, so in low energy mode, INT1 wakes the watch through the RTC instead.
+    movement_accelerometer_sleep_task();
+    CHECK(extwake_callback != NULL);
+    watch_disable_i2c();
+    watch_register_interrupt_callback(A4, NULL, INTERRUPT_TRIGGER_NONE);
+
+    // at the watermark, the sleep loop turns the bus back on and reads the FIFO out, and nothing goes missing.
+    lis2dw_mock_add_samples(MOVEMENT_ACCELEROMETER_WATERMARK, 200);
+    extwake_callback();
+    movement_accelerometer_sleep_task();
+    CHECK(fast.blocks == 7);
+    CHECK(!fast.last.overrun);
+    CHECK(fast.last.first_sample == 32);
+    CHECK(_check_every(&fast, MOVEMENT_ACCELEROMETER_WATERMARK, 200, 1));
+    CHECK(lis2dw_mock_fifo_count() == 0);
+
+    // waking up for anything else leaves the bus off.
+    watch_disable_i2c();
+    movement_accelerometer_sleep_task();
+    CHECK(!_i2c_enabled());
+
+    // leaving low energy mode gets the bus and the EIC back. if INT1 went up in the meantime, there won't be another
+    // edge, so the FIFO is read without waiting for one.
+    lis2dw_mock_add_samples(40, 300);
+    movement_accelerometer_wake();
+    CHECK(extwake_callback == NULL);
+    CHECK(_i2c_enabled());
+    CHECK(int1_callback != NULL);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.blocks == 8);
+    CHECK(fast.last.overrun);
+    CHECK(fast.last.count == 32);
+    CHECK(fast.last.first_sample == 0);
+
+    // a faster subscriber speeds everything up, and starts everybody over.
+    CHECK(movement_accelerometer_subscribe(LIS2DW_DATA_RATE_50_HZ, _receive, &fast));
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_50_HZ);
+    _fill_and_interrupt(24, 0);
+    CHECK(movement_accelerometer_task());
+    CHECK(fast.last.first_sample == 0);
+    CHECK(fast.last.sample_period_us == 20000);
+    CHECK(slow.last.first_sample == 0);
+    CHECK(_check_every(&slow, 6, 0, 4));
+
+    // when the fast one leaves, the slow one has it to itself at its own rate; when it goes too, so does the power.
+    movement_accelerometer_unsubscribe(_receive, &fast);
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_12_5_HZ);
+    movement_accelerometer_unsubscribe(_receive, &slow);
+    CHECK((lis2dw_mock_register(LIS2DW_REG_CTRL1) >> 4) == LIS2DW_DATA_RATE_POWERDOWN);
+    CHECK(!(lis2dw_mock_register(LIS2DW_REG_CTRL4_INT1) & LIS2DW_CTRL4_INT1_FTH));
+    CHECK(int1_callback == NULL);
+    CHECK(!_i2c_enabled());
+    CHECK(movement_accelerometer_task());
+
+    printf("movement_accelerometer passed\n");
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks the pedometer's count against traces with a known number of steps, and times it. with no arguments it
+// makes up its own: walking and running at different paces with a little variation from step to step, arm
+// swing and noise, stops and starts, and some fidgeting that shouldn't count at all. to check it against real
+// recordings, pass CSV files as made by utils/motion_express_utilities/process_motion_dump.py, each with the
+// number of steps you counted while recording it:
+//
+//   build-host/pedometer_test output/walking.csv=212 output/stairs-up.csv=64
+//
+// build and run it with `make HOST=1 COLOR=GREEN test` in movement/make.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pedometer.h"
+
+#define MAX_SAMPLES (PEDOMETER_SAMPLES_PER_SECOND * 600)
+// the FIFO watermark the samples come in blocks of.
+#define BLOCK_SIZE 24
+// 1 g at ±4 g.
+#define ONE_G 8192.0
+
+static lis2dw_reading_t samples[MAX_SAMPLES];
+static uint32_t num_samples;
+static uint32_t true_steps;
+static double total_ns;
+static uint32_t total_samples;
+
+// the same noise every run.
+static uint32_t seed = 1;
+static double _random(double low, double high) {
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static int16_t _raw(double g) {
+    double raw = round(g * ONE_G);
+    if (raw > INT16_MAX) return INT16_MAX;
+    if (raw < INT16_MIN) return INT16_MIN;
+    return (int16_t)raw;
+}
+
+// the watch, tilted a bit on the wrist, with gravity mostly along z.
+static const double gravity[3] = { 0.26, -0.34, 0.90 };
+
+static void _add_sample(double bounce, double swing, double noise) {
+    if (num_samples == MAX_SAMPLES) return;
+    samples[num_samples].x = _raw(gravity[0] * (1 + bounce) + swing + _random(-noise, noise));
+    samples[num_samples].y = _raw(gravity[1] * (1 + bounce) + _random(-noise, noise));
+    samples[num_samples].z = _raw(gravity[2] * (1 + bounce) + _random(-noise, noise));
+    num_samples++;
+}
+
+static void _still(double seconds) {
+    for (uint32_t i = 0; i < seconds * PEDOMETER_SAMPLES_PER_SECOND; i++) _add_sample(0, 0, 0.01);
+}
+
+// steps at cadence steps a second, each a bounce of about amplitude g with a harmonic, each step up to 8% longer
+// or shorter than the last, and the arm swinging back and forth once every two steps.
+static void _walk(double seconds, double cadence, double amplitude) {
+    double phase = 0, period = 1 / cadence;
+    uint32_t step = 0;
+    for (uint32_t i = 0; i < seconds * PEDOMETER_SAMPLES_PER_SECOND; i++) {
+        double bounce = amplitude * (sin(2 * M_PI * phase) + 0.3 * sin(4 * M_PI * phase + 1));
+        double swing = 0.15 * sin(M_PI * (step % 2 + phase));
+        _add_sample(bounce, swing, 0.03);
+        phase += 1.0 / PEDOMETER_SAMPLES_PER_SECOND / period;
+        if (phase >= 1) {
+            phase -= 1;
+            step++;
+            period = (1 / cadence) * _random(0.92, 1.08);
+        }
+    }
+    true_steps += step;
+}
+
+// typing, gesturing, scratching your nose: a couple of sharp jolts, then nothing for a few seconds.
+static void _fidget(double seconds) {
+    uint32_t end = num_samples + seconds * PEDOMETER_SAMPLES_PER_SECOND;
+    while (num_samples < end) {
+        uint8_t jolts = 2 + _random(0, 2);
+        for (uint8_t j = 0; j < jolts; j++) {
+            double size = _random(0.3, 0.6);
+            for (uint8_t k = 0; k < 4; k++) _add_sample(size * (k < 2 ? k + 1 : 4 - k) / 2, size / 2, 0.02);
+            _still(0.2);
+        }
+        _still(_random(2.5, 5));
+    }
+}
+
+// runs the trace through the pedometer in FIFO-sized blocks, and checks that it came to within tolerance (a
+// fraction) of the true count.
+static int _count(const char *name, double tolerance) {
+    pedometer_t pedometer;
+    uint32_t steps = 0;
+    struct timespec start, end;
+
+    pedometer_init(&pedometer);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < num_samples; i += BLOCK_SIZE) {
+        uint8_t count = num_samples - i < BLOCK_SIZE ? num_samples - i : BLOCK_SIZE;
+        steps += pedometer_add_samples(&pedometer, &samples[i], count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    total_ns += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    total_samples += num_samples;
+
+    double error = fabs((double)steps - true_steps);
+    printf("%-28s %5lu steps, counted %5lu\n", name, (unsigned long)true_steps, (unsigned long)steps);
+    if (error > 2 && error > true_steps * tolerance) {
+        printf("%s: %s is off by more than %.0f%%\n", __FILE__, name, tolerance * 100);
+        return 1;
+    }
+
+    num_samples = 0;
+    true_steps = 0;
+    return 0;
+}
+
+// loads a CSV of timestamp (ms) and x, y and z in m/s², taking the latest reading at each 25 Hz tick.
+static bool _load(const char *path) {
+    FILE *file = fopen(path, "r");
+    char line[128];
+    double start = -1, time, x, y, z;
+    lis2dw_reading_t reading = {0};
+
+    if (file == NULL) return false;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "%lf,%lf,%lf,%lf", &time, &x, &y, &z) != 4) continue;
+        if (start < 0) start = time;
+        while (num_samples < MAX_SAMPLES && start + num_samples * 1000.0 / PEDOMETER_SAMPLES_PER_SECOND < time) {
+            samples[num_samples++] = reading;
+        }
+        reading.x = _raw(x / 9.80665);
+        reading.y = _raw(y / 9.80665);
+        reading.z = _raw(z / 9.80665);
+    }
+    if (start >= 0 && num_samples < MAX_SAMPLES) samples[num_samples++] = reading;
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            char *steps = strrchr(argv[i], '=');
+            if (steps == NULL) {
+                printf("usage: %s recording.csv=steps ...\n", argv[0]);
+                return 1;
+            }
+            *steps = 0;
+            if (!_load(argv[i])) {
+                printf("can't read %s\n", argv[i]);
+                return 1;
+            }
+            true_steps = atoi(steps + 1);
+            if (_count(argv[i], 0.1)) return 1;
+        }
+    } else {
+        _still(60);
+        if (_count("standing still", 0)) return 1;
+        _walk(120, 1.8, 0.2);
+        if (_count("walking", 0.05)) return 1;
+        _walk(120, 1.4, 0.1);
+        if (_count("strolling", 0.05)) return 1;
+        _walk(60, 2.8, 0.8);
+        if (_count("running", 0.05)) return 1;
+        _walk(30, 1.8, 0.2);
+        _still(10);
+        _walk(30, 1.8, 0.2);
+        _still(3);
+        _walk(30, 1.7, 0.15);
+        if (_count("walking, with stops", 0.05)) return 1;
+        _fidget(120);
+        if (_count("fidgeting", 0)) return 1;
+        _walk(60, 1.8, 0.2);
+        _fidget(60);
+        _walk(60, 2.0, 0.25);
+        if (_count("walking, then fidgeting", 0.05)) return 1;
+    }
+
+    printf("%.0f ns per sample on this computer\n", total_ns / total_samples);
+    printf("pedometer passed\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+// checks that the resource pack built from movement/resources can be searched, listed and walked through, and that
+// its records match the files they were built from. build and run it with `make HOST=1 COLOR=GREEN test` in
+// movement/make.
+
+#include <stdio.h>
+#include <string.h>
+#include "resources.h"
+
+// the Makefile sets this when it leaves wordle_possible out of the pack.
+#ifndef WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES
+#define WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES 0
+#endif
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        return 1; \
+    } \
+} while (0)
+
+// compares a resource's records with the lines of the text file it was built from.
+static int _check_records(const char *name, const char *path) {
+    resource_t resource;
+    char line[32];
+    uint32_t index = 0;
+    const char *record = NULL;
+
+    CHECK(resource_find(name, &resource));
+    CHECK(strcmp(resource.name, name) == 0);
+    CHECK(resource.record_size == 5);
+    CHECK(resource.size == resource_record_count(&resource) * resource.record_size);
+
+    FILE *file = fopen(path, "r");
+    CHECK(file != NULL);
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (line[0] == 0) continue;
+        record = resource_next_record(&resource, record);
+        CHECK(record != NULL);
+        CHECK(record == resource_record(&resource, index));
+        CHECK(strncmp(record, line, resource.record_size) == 0);
+        index++;
+    }
+    fclose(file);
+
+    CHECK(index == resource_record_count(&resource));
+    CHECK(resource_next_record(&resource, record) == NULL);
+
+    return 0;
+}
+
+int main(void) {
+    resource_t first, second;
+
+    CHECK(resource_pack_count() == (WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES ? 1 : 2));
+
+    // the index is sorted, which is what lets resource_find do a binary search.
+    for (uint16_t i = 1; i < resource_pack_count(); i++) {
+        CHECK(resource_get(i - 1, &first));
+        CHECK(resource_get(i, &second));
+        CHECK(strcmp(first.name, second.name) < 0);
+    }
+    CHECK(!resource_get(resource_pack_count(), &first));
+
+    // lookups hand back pointers into the pack itself, so finding a resource twice gets the same data.
+    CHECK(resource_find("wordle_valid", &first));
+    CHECK(resource_find("wordle_valid", &second));
+    CHECK(first.data == second.data);
+    CHECK(((uintptr_t)first.data & 3) == 0);
+
+    CHECK(!resource_find("wordle", &first));
+    CHECK(!resource_find("wordle_valid_too", &first));
+    CHECK(!resource_find("", &first));
+
+    if (_check_records("wordle_valid", "../resources/wordle_valid.txt")) return 1;
+#if !WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES
+    if (_check_records("wordle_possible", "../resources/wordle_possible.txt")) return 1;
+#endif
+
+    printf("resource pack: %d resources\n", resource_pack_count());
+
+    return 0;
+}
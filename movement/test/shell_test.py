@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Types at the shell on the host build: tab completion, history, line endings, and a cat long enough to take several
+trips around the app loop. Run it from movement/make, after building with `make HOST=1 COLOR=GREEN`;
+`make HOST=1 COLOR=GREEN test` does both.
+"""
+
+import base64
+import subprocess
+import sys
+import zlib
+
+BLOCK_SIZE = 144  # FILE_TRANSFER_BLOCK_SIZE
+UP = "\x1b[A"
+DOWN = "\x1b[B"
+
+
+def check(condition, message):
+    if not condition:
+        print(f"{__file__}: {message}")
+        sys.exit(1)
+
+
+def type_keys(keys):
+    """Runs the watch for a couple of seconds with keys as its USB input, and returns everything it printed."""
+    result = subprocess.run(["build-host/watch", "-u", "-s", "2"], input=keys.encode("ascii"), capture_output=True,
+                            timeout=30)
+    return result.stdout.decode("ascii", "replace")
+
+
+def upload(name, data):
+    """The lines that put a file on the watch, the same as utils/shell_transfer.py would send them."""
+    lines = [f"put {name} {len(data)} {zlib.crc32(data):08x}"]
+    for offset in range(0, len(data), BLOCK_SIZE):
+        block = data[offset:offset + BLOCK_SIZE]
+        lines.append(f"blk {offset} {base64.b64encode(block).decode()} {zlib.crc32(block):08x}")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    # a unique prefix completes all the way, with a space after it.
+    output = type_keys("usb\t\n")
+    check("usbstat \r\n" in output, f"usb didn't complete: {output!r}")
+    check("bytes/s" in output, "the completed command didn't run")
+
+    # a shared prefix lists what it could be, then carries on with the line as it was.
+    output = type_keys("d\t\x15\n")
+    check("df  dump  \r\nswsh> d" in output, f"d didn't list its completions: {output!r}")
+
+    # up goes back through the history, down comes forward again, and Ctrl-P is another up.
+    output = type_keys("echo one > a.txt\ncat a.txt\necho two > a.txt\n" + UP + UP + DOWN + "\n\x10\x10\n")
+    check(output.count("one\n") == 1, f"history ran the wrong lines: {output!r}")
+    check(output.count("two\n") == 1, f"Ctrl-P didn't go back to cat: {output!r}")
+
+    # a CR LF ends one line, not two.
+    output = type_keys("df\r\n")
+    check(output.count("swsh> ") == 1, f"CR LF prompted {output.count('swsh> ')} times: {output!r}")
+
+    # a file bigger than a step comes out whole, and the prompt only comes back once it's all out.
+    text = b"".join(b"line %03d of a file that cat sends over several steps\n" % i for i in range(40))
+    output = type_keys(upload("long.txt", text) + "cat long.txt\n")
+    check("done" in output, f"upload failed: {output!r}")
+    printed = output.split("cat long.txt\r\n", 1)[1]
+    check(printed.startswith(text.decode()), "cat didn't print the whole file")
+    check(printed[len(text):] == "\r\n\r\nswsh> ", f"cat ended with {printed[len(text):]!r}")
+
+    print("shell passed")
+
+
+if __name__ == "__main__":
+    main()
@@ -218,13 +218,13 @@ static void clock_stop_tick_tock_animation(void) {
 
 void clock_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(clock_state_t));
         clock_state_t *state = (clock_state_t *) *context_ptr;
         state->time_signal_enabled = false;
         state->watch_face_index = watch_face_index;
+        movement_set_background_cadence(watch_face_index, MOVEMENT_BACKGROUND_HOURLY, 0, 0);
     }
 }
 
@@ -87,6 +87,11 @@ void close_enough_clock_face_activate(movement_settings_t *settings, void *conte
     // this ensures that none of the five_minute_periods will match, so we always rerender when the face activates
     state->prev_five_minute_period = -1;
     state->prev_min_checked = -1;
+
+    // nothing here changes more than once a minute, so skip the 1 Hz tick and redraw at the top of each minute.
+    watch_date_time next_redraw;
+    next_redraw.reg = 0;
+    movement_request_next_redraw(next_redraw);
 }
 
 bool close_enough_clock_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
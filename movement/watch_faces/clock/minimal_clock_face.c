@@ -56,6 +56,11 @@ void minimal_clock_face_activate(movement_settings_t *settings, void *context) {
     (void) context;
     // Handle any tasks related to your watch face coming on screen.
     watch_set_colon();
+
+    // This face only changes once a minute, so skip the 1 Hz tick and redraw at the top of each minute instead.
+    watch_date_time next_redraw;
+    next_redraw.reg = 0;
+    movement_request_next_redraw(next_redraw);
 }
 
 bool minimal_clock_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
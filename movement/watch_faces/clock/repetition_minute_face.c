@@ -53,13 +53,13 @@ static void _update_alarm_indicator(bool settings_alarm_enabled, repetition_minu
 
 void repetition_minute_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(repetition_minute_state_t));
         repetition_minute_state_t *state = (repetition_minute_state_t *)*context_ptr;
         state->signal_enabled = false;
         state->watch_face_index = watch_face_index;
+        movement_set_background_cadence(watch_face_index, MOVEMENT_BACKGROUND_HOURLY, 0, 0);
     }
 }
 
@@ -52,6 +52,7 @@ void simple_clock_bin_led_face_setup(movement_settings_t *settings, uint8_t watc
         memset(*context_ptr, 0, sizeof(simple_clock_bin_led_state_t));
         simple_clock_bin_led_state_t *state = (simple_clock_bin_led_state_t *)*context_ptr;
         state->watch_face_index = watch_face_index;
+        movement_set_background_cadence(watch_face_index, MOVEMENT_BACKGROUND_HOURLY, 0, 0);
     }
 }
 
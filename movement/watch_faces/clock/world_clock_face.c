@@ -30,15 +30,18 @@
 
 void world_clock_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(world_clock_state_t));
         memset(*context_ptr, 0, sizeof(world_clock_state_t));
+        world_clock_state_t *state = (world_clock_state_t *)*context_ptr;
+        // you can have more than one world clock, so each one keeps its settings under its own key.
+        sprintf(state->settings_key, "wclk%d", watch_face_index);
+        // these used to live in a backup register. keep claiming it, so the faces after this one keep theirs, and
+        // carry its settings over the first time there's nothing under the key.
         uint8_t backup_register = movement_claim_backup_register();
-        if (backup_register) {
-            world_clock_state_t *state = (world_clock_state_t *)*context_ptr;
+        if (!kvstore_get_uint32(state->settings_key, &state->settings.reg) && backup_register) {
             state->settings.reg = watch_get_backup_data(backup_register);
-            state->backup_register = backup_register;
+            kvstore_set_uint32(state->settings_key, state->settings.reg);
         }
     }
 }
@@ -132,7 +135,7 @@ static bool world_clock_face_do_display_mode(movement_event_t event, movement_se
 static bool _world_clock_face_do_settings_mode(movement_event_t event, movement_settings_t *settings, world_clock_state_t *state) {
     switch (event.event_type) {
         case EVENT_MODE_BUTTON_UP:
-            if (state->backup_register) watch_store_backup_data(state->settings.reg, state->backup_register);
+            kvstore_set_uint32(state->settings_key, state->settings.reg);
             movement_move_to_next_face();
             return false;
         case EVENT_LIGHT_BUTTON_DOWN:
@@ -140,7 +143,7 @@ static bool _world_clock_face_do_settings_mode(movement_event_t event, movement_
             if (state->current_screen > 3) {
                 movement_request_tick_frequency(1);
                 state->current_screen = 0;
-                if (state->backup_register) watch_store_backup_data(state->settings.reg, state->backup_register);
+                kvstore_set_uint32(state->settings_key, state->settings.reg);
                 event.event_type = EVENT_ACTIVATE;
                 return world_clock_face_do_display_mode(event, settings, state);
             }
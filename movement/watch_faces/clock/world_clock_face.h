@@ -47,6 +47,7 @@
  */
 
 #include "movement.h"
+#include "kvstore.h"
 
 typedef union {
     struct {
@@ -59,7 +60,7 @@ typedef union {
 
 typedef struct {
     world_clock_settings_t settings;
-    uint8_t backup_register;
+    char settings_key[KVSTORE_KEY_SIZE + 1];
     uint8_t current_screen;
     uint32_t previous_date_time;
 } world_clock_state_t;
@@ -27,6 +27,7 @@
  * -- Additional power-saving optimizations
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "activity_face.h"
@@ -174,12 +175,12 @@ static uint8_t _activity_get_next_byte(uint8_t *next_byte);
 
 void activity_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr) {
     (void)settings;
-    (void)watch_face_index;
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(activity_state_t));
         memset(*context_ptr, 0, sizeof(activity_state_t));
         // This happens only at boot
         _activity_clear_buffers();
+        movement_set_export(watch_face_index, activity_face_export);
     }
     // Do any pin or peripheral setup here; this will be called whenever the watch wakes from deep sleep.
 }
@@ -728,3 +729,25 @@ void activity_face_resign(movement_settings_t *settings, void *context) {
     // Rather do this defensively here.
     movement_request_tick_frequency(1);
 }
+
+int32_t activity_face_export(movement_settings_t *settings, void *context, int32_t position) {
+    (void)settings;
+    (void)context;
+
+    if (position == 0) printf("start,activity,total_seconds,paused_seconds\r\n");
+    int32_t end = position + MOVEMENT_EXPORT_RECORDS_PER_CALL;
+    if (end > activity_log_count) end = activity_log_count;
+    for (int32_t i = position; i < end; ++i) {
+        const activity_item_t *itm = &activity_log_buffer[i];
+        // names are padded for the display; trim them for the CSV.
+        const char *name = activity_names[itm->activity_type];
+        int len = sizeof(activity_names[0]);
+        while (*name == ' ') { ++name; --len; }
+        while (len > 0 && (name[len - 1] == ' ' || name[len - 1] == '\0')) --len;
+        printf("%04d-%02d-%02d %02d:%02d:%02d,%.*s,%d,%d\r\n",
+               itm->start_time.unit.year + WATCH_RTC_REFERENCE_YEAR, itm->start_time.unit.month, itm->start_time.unit.day,
+               itm->start_time.unit.hour, itm->start_time.unit.minute, itm->start_time.unit.second,
+               len, name, itm->total_sec, itm->pause_sec);
+    }
+    return end < activity_log_count ? end : MOVEMENT_EXPORT_DONE;
+}
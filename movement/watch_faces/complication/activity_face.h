@@ -64,6 +64,8 @@
  * 
  * The log is stored in regular memory. It will be lost when you remove the battery, so make
  * sure you chirp it out before taking the watch apart.
+ *
+ * With the watch plugged in, the shell's `dump` command prints the log as CSV instead.
  * 
  * See the top of activity_face.c for some customization options. What you most likely want to do
  * is reduce the list of activities shown on the first screen to the ones you are regularly doing.
@@ -75,6 +77,7 @@ void activity_face_setup(movement_settings_t *settings, uint8_t watch_face_index
 void activity_face_activate(movement_settings_t *settings, void *context);
 bool activity_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void activity_face_resign(movement_settings_t *settings, void *context);
+int32_t activity_face_export(movement_settings_t *settings, void *context, int32_t position);
 
 #define activity_face ((const watch_face_t){ \
     activity_face_setup, \
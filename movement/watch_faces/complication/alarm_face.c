@@ -291,6 +291,7 @@ bool alarm_face_loop(movement_event_t event, movement_settings_t *settings, void
                     // revert change of enabled flag and show it briefly
                     state->alarm[state->alarm_idx].enabled ^= 1;
                     _alarm_set_signal(state);
+                    watch_display_commit();
                     delay_ms(275);
                     state->alarm_idx = 0;
                 }
@@ -103,6 +103,10 @@
 #include "watch.h"
 #include "watch_utility.h"
 
+#if DEADLINE_FACE_DATES > MOVEMENT_TIMERS_PER_FACE
+#error "deadline_face needs one background timer per deadline"
+#endif
+
 #define SETTINGS_NUM (5)
 const char settings_titles[SETTINGS_NUM][3] = { "YR", "MO", "DA", "HR", "M1" };
 
@@ -236,8 +240,21 @@ static void _background_alarm_play(movement_settings_t *settings, deadline_state
 /* Schedule background alarm */
 static void _background_alarm_schedule(movement_settings_t *settings, deadline_state_t *state)
 {
-    /* We simply re-use the scheduling in the background task */
-    deadline_face_wants_background_task(settings, state);
+    if (!state->alarm_enabled)
+        return;
+
+    /* Set up one background timer per deadline, using the deadline's index as timer ID */
+    watch_date_time now = watch_rtc_get_date_time();
+    uint32_t now_ts = watch_utility_date_time_to_unix_time(now, _get_tz_offset(settings));
+
+    for (uint8_t i = 0; i < DEADLINE_FACE_DATES; i++) {
+        if (state->deadlines[i] <= now_ts) {
+            movement_cancel_background_timer(state->face_idx, i);
+            continue;
+        }
+        watch_date_time next = watch_utility_date_time_from_unix_time(state->deadlines[i], _get_tz_offset(settings));
+        movement_schedule_background_timer(state->face_idx, i, next);
+    }
 }
 
 /* Cancel background alarm */
@@ -245,7 +262,8 @@ static void _background_alarm_cancel(movement_settings_t *settings, deadline_sta
 {
     (void) settings;
 
-    movement_cancel_background_task_for_face(state->face_idx);
+    for (uint8_t i = 0; i < DEADLINE_FACE_DATES; i++)
+        movement_cancel_background_timer(state->face_idx, i);
 }
 
 /* Reset deadline to tomorrow */
@@ -619,31 +637,3 @@ void deadline_face_resign(movement_settings_t *settings, void *context)
     (void) settings;
     (void) context;
 }
-
-/* Want background task */
-bool deadline_face_wants_background_task(movement_settings_t *settings, void *context)
-{
-    deadline_state_t *state = (deadline_state_t *) context;
-
-    if (!state->alarm_enabled)
-        return false;
-
-    /* Determine closest deadline */
-    watch_date_time now = watch_rtc_get_date_time();
-    uint32_t now_ts = watch_utility_date_time_to_unix_time(now, _get_tz_offset(settings));
-    uint32_t next_ts = state->deadlines[_closest_deadline(settings, state)];
-
-    /* No active deadline */
-    if (next_ts < now_ts)
-        return false;
-
-    /* No deadline within next 60 seconds */
-    if (next_ts >= now_ts + 60)
-        return false;
-
-    /* Deadline within next minute. Let's set up an alarm */
-    watch_date_time next = watch_utility_date_time_from_unix_time(next_ts, _get_tz_offset(settings));
-    movement_request_wake();
-    movement_schedule_background_task_for_face(state->face_idx, next);
-    return false;
-}
@@ -52,14 +52,13 @@ void deadline_face_setup(movement_settings_t *settings, uint8_t watch_face_index
 void deadline_face_activate(movement_settings_t *settings, void *context);
 bool deadline_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void deadline_face_resign(movement_settings_t *settings, void *context);
-bool deadline_face_wants_background_task(movement_settings_t *settings, void *context);
 
 #define deadline_face ((const watch_face_t){ \
     deadline_face_setup, \
     deadline_face_activate, \
     deadline_face_loop, \
     deadline_face_resign, \
-    deadline_face_wants_background_task \
+    NULL \
 })
 
 #endif                          // DEADLINE_FACE_H_
@@ -44,7 +44,7 @@
 #if __EMSCRIPTEN__
 #include <emscripten.h>
 #include <emscripten/html5.h>
-#else
+#elif !WATCH_HOST
 #include "../../../watch-library/hardware/include/saml22j18a.h"
 #include "../../../watch-library/hardware/include/component/tc.h"
 #include "../../../watch-library/hardware/hri/hri_tc_l22.h"
@@ -77,6 +77,31 @@ static inline void _dual_timer_cb_start() {
     _em_interval_id = emscripten_set_interval(em_dual_timer_cb_handler, (double)(1000/128), (void *)NULL);
 }
 
+#elif WATCH_HOST
+
+static int8_t _host_timer_id = -1;
+
+static void _dual_timer_host_cb_handler(void *userData) {
+    // stands in for the TC2 interrupt, which also wakes the watch 128 times a second
+    (void) userData;
+    _ticks++;
+    resume_main_loop();
+}
+
+static void _dual_timer_cb_initialize() { }
+
+static inline void _dual_timer_cb_stop() {
+    main_loop_clear_timer(_host_timer_id);
+    _host_timer_id = -1;
+    _is_running = false;
+}
+
+static inline void _dual_timer_cb_start() {
+    uint32_t period = MAIN_LOOP_TICKS_PER_SECOND / 128;
+    _host_timer_id = main_loop_set_timer(_dual_timer_host_cb_handler, NULL, main_loop_get_ticks() + period, period);
+    _is_running = true;
+}
+
 #else
 
 static inline void _dual_timer_cb_start() {
@@ -112,6 +112,7 @@ static void _simon_display_note(SimonNote note, simon_state_t *state) {
 
 static void _simon_play_note(SimonNote note, simon_state_t *state, bool skip_rest) {
     _simon_display_note(note, state);
+    watch_display_commit();
     switch (note) {
         case SIMON_LED_NOTE:
             if (!state->lightOff) watch_set_led_yellow();
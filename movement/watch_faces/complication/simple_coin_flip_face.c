@@ -22,7 +22,7 @@
  * SOFTWARE.
  */
 
-#if __EMSCRIPTEN__
+#if __EMSCRIPTEN__ || WATCH_HOST
 #include <time.h>
 #else
 #include "saml22j18a.h"
@@ -87,11 +87,11 @@ static void _smallchess_make_ai_move(smallchess_face_state_t *state) {
     watch_start_character_blink('C', 100);
     SCL_gameGetRepetiotionMove(state->game, &rep_from, &rep_to);
 
-#ifndef __EMSCRIPTEN__
+#if !(__EMSCRIPTEN__ || WATCH_HOST)
     hri_oscctrl_write_OSC16MCTRL_FSEL_bf(OSCCTRL, OSCCTRL_OSC16MCTRL_FSEL_16_Val);
 #endif
     SCL_getAIMove(state->game, 3, 0, 0, SCL_boardEvaluateStatic, NULL, 0, rep_from, rep_to, &state->ai_from_square, &state->ai_to_square, &ai_prom);
-#ifndef __EMSCRIPTEN__
+#if !(__EMSCRIPTEN__ || WATCH_HOST)
     hri_oscctrl_write_OSC16MCTRL_FSEL_bf(OSCCTRL, OSCCTRL_OSC16MCTRL_FSEL_4_Val);
 #endif
 
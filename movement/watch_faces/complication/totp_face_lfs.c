@@ -131,14 +131,15 @@ static void totp_face_lfs_read_file(char *filename) {
     // For 'format' of file, see comment at top.
     const size_t uri_start_len = strlen(TOTP_URI_START);
 
-    if (!filesystem_file_exists(filename)) {
+    filesystem_reader_t reader;
+    if (!filesystem_open(&reader, filename)) {
         printf("TOTP file error: %s\n", filename);
         return;
     }
 
     char line[256];
-    int32_t offset = 0, old_offset = 0;
-    while (old_offset = offset, filesystem_read_line(filename, line, &offset, 255) && strlen(line)) {
+    int32_t old_offset = 0;
+    while (old_offset = reader.offset, filesystem_next_line(&reader, line, sizeof(line)) && strlen(line)) {
         if (num_totp_records == MAX_TOTP_RECORDS) {
             printf("TOTP max records: %d\n", MAX_TOTP_RECORDS);
             break;
@@ -187,6 +188,8 @@ static void totp_face_lfs_read_file(char *filename) {
             printf("TOTP missing secret: %s\n", line);
         }
     }
+
+    filesystem_close(&reader);
 }
 
 void totp_face_lfs_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
@@ -207,9 +210,7 @@ static uint8_t *totp_face_lfs_get_file_secret(struct totp_record *record) {
     char buffer[BASE32_LEN(MAX_TOTP_SECRET_SIZE) + 1];
     int32_t file_secret_offset = record->file_secret_offset;
 
-    /* TODO filesystem_read_line is quite inefficient. Consider writing a new function,
-     * and keeping the file open?
-     */
+    /* Just the one line, so it's not worth keeping a reader open for this. */
     if (!filesystem_read_line(TOTP_FILE, buffer, &file_secret_offset, record->file_secret_length + 1)) {
         /* Shouldn't happen at this point. Return current_secret, which is misleading but will not cause a crash. */
         printf("TOTP can't read expected secret from totp_uris.txt (failed readline)\n");
@@ -26,6 +26,24 @@
 #include <string.h>
 #include "wordle_face.h"
 #include "watch_utility.h"
+#include "resources.h"
+
+// the word lists, read in place from the resource pack. words aren't terminated, so print them with %.*s.
+static resource_t _valid_words;
+#define WORDLE_NUM_WORDS resource_record_count(&_valid_words)
+#if !WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES
+static resource_t _possible_words;
+#define WORDLE_NUM_POSSIBLE_WORDS resource_record_count(&_possible_words)
+#endif
+
+static const char *_word(const resource_t *words, uint32_t index) {
+    return resource_record(words, index);
+}
+
+// leaves the list empty if it's missing from the pack, or isn't a list of words this long.
+static void _find_words(const char *name, resource_t *words) {
+    if (!resource_find(name, words) || words->record_size != WORDLE_LENGTH) memset(words, 0, sizeof(resource_t));
+}
 
 static uint32_t get_random(uint32_t max) {
     #if __EMSCRIPTEN__
@@ -113,7 +131,7 @@ static uint32_t check_word_in_dict(uint8_t *word_elements) {
     for (uint16_t i = 0; i < WORDLE_NUM_WORDS; i++) {
         is_exact_match = true;
         for (size_t j = 0; j < WORDLE_LENGTH; j++) {
-            if (_valid_letters[word_elements[j]] != _valid_words[i][j]) {
+            if (_valid_letters[word_elements[j]] != _word(&_valid_words, i)[j]) {
                 is_exact_match = false;
                 break;  
             }
@@ -123,7 +141,7 @@ static uint32_t check_word_in_dict(uint8_t *word_elements) {
     for (uint16_t i = 0; i < WORDLE_NUM_POSSIBLE_WORDS; i++) {
         is_exact_match = true;
         for (size_t j = 0; j < WORDLE_LENGTH; j++) {
-            if (_valid_letters[word_elements[j]] != _possible_words[i][j]) {
+            if (_valid_letters[word_elements[j]] != _word(&_possible_words, i)[j]) {
                 is_exact_match = false;
                 break;  
             }
@@ -139,7 +157,7 @@ static bool check_word(wordle_state_t *state) {
     bool is_exact_match = true;
     bool answer_already_accounted[WORDLE_LENGTH] = { false };
     for (size_t i = 0; i < WORDLE_LENGTH; i++) {
-        if (_valid_letters[state->word_elements[i]] == _valid_words[state->curr_answer][i]) {
+        if (_valid_letters[state->word_elements[i]] == _word(&_valid_words, state->curr_answer)[i]) {
             state->word_elements_result[i] = WORDLE_LETTER_CORRECT;
             answer_already_accounted[i] = true;
         }
@@ -154,7 +172,7 @@ static bool check_word(wordle_state_t *state) {
         if (state->word_elements_result[i] != WORDLE_LETTER_WRONG) continue;
         for (size_t j = 0; j < WORDLE_LENGTH; j++) {
             if (answer_already_accounted[j]) continue;
-            if (_valid_letters[state->word_elements[i]] == _valid_words[state->curr_answer][j]) {
+            if (_valid_letters[state->word_elements[i]] == _word(&_valid_words, state->curr_answer)[j]) {
                 state->word_elements_result[i] = WORDLE_LETTER_WRONG_LOC;
                 answer_already_accounted[j] = true;
                 break;
@@ -238,7 +256,7 @@ static void reset_board(wordle_state_t *state) {
     display_playing(state);
     watch_display_string(" -", 4);
 #if __EMSCRIPTEN__
-    printf("ANSWER: %s\r\n", _valid_words[state->curr_answer]);
+    printf("ANSWER: %.*s\r\n", WORDLE_LENGTH, _word(&_valid_words, state->curr_answer));
 #endif
 }
 
@@ -302,7 +320,7 @@ static uint32_t get_day_unix_time(void) {
 
 static void display_lose(wordle_state_t *state, uint8_t subsecond) {
     char buf[WORDLE_LENGTH + 6];
-    sprintf(buf," L   %s", subsecond % 2 ? _valid_words[state->curr_answer] : "     ");
+    sprintf(buf," L   %.*s", WORDLE_LENGTH, subsecond % 2 ? _word(&_valid_words, state->curr_answer) : "     ");
     watch_display_string(buf, 0);
 }
 
@@ -461,12 +479,12 @@ static void get_result(wordle_state_t *state) {
 static void insert_random_guess(wordle_state_t *state) {
     uint16_t random_guess;
     do {  // Don't allow the guess to be the same as the answer
-        random_guess = get_random(_num_random_guess_words);
+        random_guess = get_random(_num_random_guess_words ? _num_random_guess_words : WORDLE_NUM_WORDS);
     } while (random_guess == state->curr_answer); 
     for (size_t i = 0; i < WORDLE_LENGTH; i++) {
         for (size_t j = 0; j < WORDLE_NUM_VALID_LETTERS; j++)
         {
-            if (_valid_words[random_guess][i] == _valid_letters[j])
+            if (_word(&_valid_words, random_guess)[i] == _valid_letters[j])
                 state->word_elements[i] = j;     
         }
     } 
@@ -479,6 +497,12 @@ static void insert_random_guess(wordle_state_t *state) {
 void wordle_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
     (void) watch_face_index;
+    if (_valid_words.data == NULL) {
+        _find_words("wordle_valid", &_valid_words);
+#if !WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES
+        _find_words("wordle_possible", &_possible_words);
+#endif
+    }
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(wordle_state_t));
         memset(*context_ptr, 0, sizeof(wordle_state_t));
@@ -493,6 +517,11 @@ void wordle_face_setup(movement_settings_t *settings, uint8_t watch_face_index,
 void wordle_face_activate(movement_settings_t *settings, void *context) {
     (void) settings;
     wordle_state_t *state = (wordle_state_t *)context;
+    if (WORDLE_NUM_WORDS == 0) {
+        // no word list, so there's no answer to pick.
+        watch_display_string("WO  nodict", 0);
+        return;
+    }
 #if WORDLE_USE_DAILY_STREAK != 0
     uint32_t now = get_day_unix_time();
     uint32_t one_day = 60 *60 * 24;
@@ -513,6 +542,7 @@ void wordle_face_activate(movement_settings_t *settings, void *context) {
 
 bool wordle_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
     wordle_state_t *state = (wordle_state_t *)context;
+    if (WORDLE_NUM_WORDS == 0) return movement_default_loop_handler(event, settings);
 
     switch (event.event_type) {
         case EVENT_TICK:
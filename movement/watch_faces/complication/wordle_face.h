@@ -76,7 +76,11 @@
  *      Starting a new game instead of continuing is not allowed in this state.
 */
 #define WORDLE_USE_DAILY_STREAK 1
-#define WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES false  // This allows non-words to be entered and repeat guesses to be made. It saves ~11.5KB of ROM.
+#ifndef WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES
+// This allows non-words to be entered and repeat guesses to be made. It saves ~11.5KB of ROM.
+// Build with `make WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES=1` so wordle_possible is left out of the resource pack too.
+#define WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES false
+#endif
 /*  WORDLE_USE_RANDOM_GUESS
  *  0 = Don't allow quickly choosing a random quess
  *  1 = Allow using a random guess of any value that can be an answer
@@ -86,8 +90,6 @@
 #define WORDLE_USE_RANDOM_GUESS 2
 #include "wordle_face_dict.h"
 
-#define WORDLE_NUM_WORDS (sizeof(_valid_words) / sizeof(_valid_words[0]))
-#define WORDLE_NUM_POSSIBLE_WORDS (sizeof(_possible_words) / sizeof(_possible_words[0]))
 #define WORDLE_NUM_VALID_LETTERS (sizeof(_valid_letters) / sizeof(_valid_letters[0]))
 
 typedef enum {
@@ -27,8 +27,8 @@
 #include "frequency_correction_face.h"
 
 // NOTE: since this face deals directly with the SAM L22's SUPC and RTC registers,
-// it won't build for the simulator or really do anything. so let's not.
-#ifndef __EMSCRIPTEN__
+// it won't build for the simulator or the host backend, or really do anything. so let's not.
+#if !(__EMSCRIPTEN__ || WATCH_HOST)
 
 // Waveform output. Comes out on pin A1 of the 9-pin connector. Output is enabled
 // when the watch face is activated and disabled when deactivated.
@@ -27,13 +27,16 @@
 #include "accelerometer_data_acquisition_face.h"
 #include "watch_utility.h"
 #include "lis2dw.h"
+#include "movement_accelerometer.h"
 #include "spiflash.h"
 
-#define ACCELEROMETER_RANGE LIS2DW_RANGE_4_G
-#define ACCELEROMETER_LPMODE LIS2DW_LP_MODE_2
-#define ACCELEROMETER_FILTER LIS2DW_BANDWIDTH_FILTER_DIV2
-#define ACCELEROMETER_LOW_NOISE true
+// Movement's accelerometer service sets the accelerometer up; these are recorded in the log.
+#define ACCELEROMETER_RANGE MOVEMENT_ACCELEROMETER_RANGE
+#define ACCELEROMETER_LPMODE MOVEMENT_ACCELEROMETER_LOW_POWER_MODE
+#define ACCELEROMETER_FILTER MOVEMENT_ACCELEROMETER_FILTER
 #define SECONDS_TO_RECORD 15
+#define SAMPLES_PER_SECOND 25
+#define SAMPLES_TO_RECORD (SECONDS_TO_RECORD * SAMPLES_PER_SECOND)
 
 static const char activity_types[][3] = {
     "TE",   // Testing
@@ -56,14 +59,14 @@ static const char activity_types[][3] = {
 static void update(accelerometer_data_acquisition_state_t *state);
 static void update_settings(accelerometer_data_acquisition_state_t *state);
 static void advance_current_setting(accelerometer_data_acquisition_state_t *state);
-static void start_reading(accelerometer_data_acquisition_state_t *state, movement_settings_t *settings);
-static void continue_reading(accelerometer_data_acquisition_state_t *state);
+static bool start_reading(accelerometer_data_acquisition_state_t *state, movement_settings_t *settings);
+static void receive_samples(const movement_accelerometer_block_t *block, void *user_data);
 static void finish_reading(accelerometer_data_acquisition_state_t *state);
 static bool wait_for_flash_ready(void);
 static int16_t get_next_available_page(void);
 static void write_buffer_to_page(uint8_t *buf, uint16_t page);
 static void write_page(accelerometer_data_acquisition_state_t *state);
-static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw_reading_t reading, uint8_t centiseconds);
+static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw_reading_t reading, uint16_t centiseconds);
 
 void accelerometer_data_acquisition_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
@@ -126,12 +129,18 @@ bool accelerometer_data_acquisition_face_loop(movement_event_t event, movement_s
                         state->countdown_ticks--;
                         printf("countdown: %d\n", state->countdown_ticks);
                         if (state->countdown_ticks == 0) {
-                            // at zero, begin reading
+                            // at zero, begin reading. the last samples come in with the FIFO's watermark, up to a
+                            // second after the last tick, so give them a couple of ticks more before giving up.
                             state->mode = ACCELEROMETER_DATA_ACQUISITION_MODE_SENSING;
-                            state->reading_ticks = SECONDS_TO_RECORD + 1;
+                            state->reading_ticks = SECONDS_TO_RECORD + 2;
                             // also beep if the user asked for it
                             if (state->beep_with_countdown) watch_buzzer_play_note(BUZZER_NOTE_C6, 75);
-                            start_reading(state, settings);
+                            if (!start_reading(state, settings)) {
+                                // no accelerometer, or no room for us on it; don't keep trying.
+                                state->mode = ACCELEROMETER_DATA_ACQUISITION_MODE_IDLE;
+                                state->reading_ticks = 0;
+                                state->repeat_ticks = 0;
+                            }
                         } else if (state->countdown_ticks < 3) {
                             // beep for last two ticks before reading
                             if (state->beep_with_countdown) watch_buzzer_play_note(BUZZER_NOTE_C5, 75);
@@ -140,17 +149,17 @@ bool accelerometer_data_acquisition_face_loop(movement_event_t event, movement_s
                     update(state);
                     break;
                 case ACCELEROMETER_DATA_ACQUISITION_MODE_SENSING:
-                    if (state->reading_ticks > 0) {
+                    // the samples come in from receive_samples; we're done when the last one is in, which can be a
+                    // little after the last tick, or when we've waited as long as we're going to.
+                    if (state->samples_logged >= SAMPLES_TO_RECORD || state->reading_ticks <= 1) {
+                        state->reading_ticks = 0;
+                        finish_reading(state);
+                        state->mode = ACCELEROMETER_DATA_ACQUISITION_MODE_IDLE;
+                        watch_buzzer_play_note(BUZZER_NOTE_C4, 125);
+                        watch_buzzer_play_note(BUZZER_NOTE_REST, 50);
+                        watch_buzzer_play_note(BUZZER_NOTE_C4, 125);
+                    } else {
                         state->reading_ticks--;
-                        if (state->reading_ticks > 0) {
-                            continue_reading(state);
-                        } else {
-                            finish_reading(state);
-                            state->mode = ACCELEROMETER_DATA_ACQUISITION_MODE_IDLE;
-                            watch_buzzer_play_note(BUZZER_NOTE_C4, 125);
-                            watch_buzzer_play_note(BUZZER_NOTE_REST, 50);
-                            watch_buzzer_play_note(BUZZER_NOTE_C4, 125);
-                        }
                     }
                     update(state);
                     break;
@@ -413,7 +422,7 @@ static void write_page(accelerometer_data_acquisition_state_t *state) {
     memset(state->records, 0xFF, sizeof(state->records));
 }
 
-static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw_reading_t reading, uint8_t centiseconds) {
+static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw_reading_t reading, uint16_t centiseconds) {
     accelerometer_data_acquisition_record_t record;
     record.data.x.record_type = ACCELEROMETER_DATA_ACQUISITION_DATA;
     record.data.y.lpmode = ACCELEROMETER_LPMODE;
@@ -421,7 +430,7 @@ static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw
     record.data.x.accel = (reading.x >> 2) + 8192;
     record.data.y.accel = (reading.y >> 2) + 8192;
     record.data.z.accel = (reading.z >> 2) + 8192;
-    record.data.counter = 100 * (SECONDS_TO_RECORD - state->reading_ticks + 1) + centiseconds;
+    record.data.counter = centiseconds;
     printf("logged data point for %d\n", record.data.counter);
     state->records[state->pos++] = record;
     if (state->pos >= 32) {
@@ -429,16 +438,10 @@ static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw
     }
 }
 
-static void start_reading(accelerometer_data_acquisition_state_t *state, movement_settings_t *settings) {
+static bool start_reading(accelerometer_data_acquisition_state_t *state, movement_settings_t *settings) {
     printf("Start reading\n");
-    watch_enable_i2c();
-    lis2dw_begin();
-    lis2dw_set_data_rate(LIS2DW_DATA_RATE_25_HZ);
-    lis2dw_set_range(ACCELEROMETER_RANGE);
-    lis2dw_set_low_power_mode(ACCELEROMETER_LPMODE);
-    lis2dw_set_bandwidth_filtering(ACCELEROMETER_FILTER);
-    if (ACCELEROMETER_LOW_NOISE) lis2dw_set_low_noise_mode(true);
-    lis2dw_enable_fifo();
+    state->samples_logged = 0;
+    if (!movement_accelerometer_subscribe(LIS2DW_DATA_RATE_25_HZ, receive_samples, state)) return false;
 
     accelerometer_data_acquisition_record_t record;
     watch_date_time date_time = watch_rtc_get_date_time();
@@ -451,21 +454,19 @@ static void start_reading(accelerometer_data_acquisition_state_t *state, movemen
     record.header.timestamp = state->starting_timestamp;
 
     state->records[state->pos++] = record;
-    lis2dw_fifo_t fifo;
-    lis2dw_read_fifo(&fifo); // dump the fifo, this starts a fresh round of data in continue_reading
+
+    return true;
 }
 
-static void continue_reading(accelerometer_data_acquisition_state_t *state) {
+static void receive_samples(const movement_accelerometer_block_t *block, void *user_data) {
+    accelerometer_data_acquisition_state_t *state = (accelerometer_data_acquisition_state_t *)user_data;
     printf("Continue reading\n");
-    lis2dw_fifo_t fifo;
-    lis2dw_read_fifo(&fifo);
-
-    fifo.count = min(fifo.count, 25); // hacky, but we need a consistent data rate; if we got a 26th data point, chuck it.
-    uint8_t offset = 4 * (25 - fifo.count); // also hacky: we're sometimes short at the start. align to beginning of next second.
-    // TODO: use the threshold interrupt for this, will mean we get consistent 25 Hz data as the accelerometer sees it.
 
-    for(int i = 0; i < fifo.count; i++) {
-        log_data_point(state, fifo.readings[i], i * 4 + offset);
+    // the accelerometer wakes us whenever its FIFO fills up, and counts out the samples at exactly 25 Hz by its own
+    // clock, so each one is 4 centiseconds after the last, with no gaps and no extras.
+    for(int i = 0; i < block->count && state->samples_logged < SAMPLES_TO_RECORD; i++) {
+        log_data_point(state, block->readings[i], state->samples_logged * (100 / SAMPLES_PER_SECOND));
+        state->samples_logged++;
     }
 }
 
@@ -474,8 +475,7 @@ static void finish_reading(accelerometer_data_acquisition_state_t *state) {
     if (state->pos != 0) {
         write_page(state);
     }
-    lis2dw_set_data_rate(LIS2DW_DATA_RATE_POWERDOWN);
-    watch_disable_i2c();
+    movement_accelerometer_unsubscribe(receive_samples, state);
 
     state->repeat_ticks = state->repeat_interval;
 }
@@ -0,0 +1,219 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pedometer_face.h"
+#include "movement_accelerometer.h"
+
+static inline uint32_t _pedometer_face_hour(watch_date_time date_time) {
+    date_time.unit.minute = 0;
+    date_time.unit.second = 0;
+    return date_time.reg;
+}
+
+static inline uint32_t _pedometer_face_day(watch_date_time date_time) {
+    date_time.unit.hour = 0;
+    return _pedometer_face_hour(date_time);
+}
+
+// closes out the minute we were counting if it's over, and the hour and day along with it. empty minutes and
+// hours aren't logged at all.
+static void _pedometer_face_roll_over(pedometer_state_t *state, watch_date_time now) {
+    now.unit.second = 0;
+    if (now.reg == state->minute.reg) return;
+
+    if (state->minute_steps) {
+        if (!datalog_append(&state->minute_log, state->minute.reg, &state->minute_steps)) state->log_failed = true;
+        state->hour_steps += state->minute_steps;
+        state->minute_steps = 0;
+    }
+    if (_pedometer_face_hour(now) != _pedometer_face_hour(state->minute)) {
+        bool logged = true;
+        if (state->hour_steps) {
+            logged = datalog_append(&state->hour_log, _pedometer_face_hour(state->minute), &state->hour_steps);
+        }
+        state->hour_steps = 0;
+        // the minute log only writes every so many minutes; don't leave more than an hour of them in RAM.
+        logged = datalog_flush(&state->minute_log) && logged;
+        // the hour log was written as it was appended to, so this only tries again if that failed.
+        logged = datalog_flush(&state->hour_log) && logged;
+        state->log_failed = !logged;
+    }
+    if (_pedometer_face_day(now) != _pedometer_face_day(state->minute)) state->today_steps = 0;
+
+    state->minute = now;
+}
+
+static void _pedometer_face_receive(const movement_accelerometer_block_t *block, void *user_data) {
+    pedometer_state_t *state = (pedometer_state_t *)user_data;
+    // samples went missing before these, so don't join them up with the ones we had.
+    if (block->overrun) pedometer_init(&state->pedometer);
+    uint16_t steps = pedometer_add_samples(&state->pedometer, block->readings, block->count);
+
+    // the samples are at most a couple of seconds old, so they go in the minute it is now.
+    _pedometer_face_roll_over(state, watch_rtc_get_date_time());
+    state->minute_steps += steps;
+    state->today_steps += steps;
+}
+
+static bool _pedometer_face_add_record(uint32_t timestamp, const void *payload, void *user_data) {
+    (void) timestamp;
+    uint16_t steps;
+    memcpy(&steps, payload, sizeof(steps));
+    *(uint32_t *)user_data += steps;
+    return true;
+}
+
+// after a reset, picks up today's and this hour's counts from the logs, less whatever hadn't been written yet.
+static void _pedometer_face_restore(pedometer_state_t *state) {
+    uint32_t hour_steps = 0, today_steps = 0;
+    watch_date_time now = watch_rtc_get_date_time();
+    uint32_t hour = _pedometer_face_hour(now);
+
+    now.unit.second = 0;
+    state->minute = now;
+    datalog_read_range(&state->minute_log, hour, UINT32_MAX, _pedometer_face_add_record, &hour_steps);
+    datalog_read_range(&state->hour_log, _pedometer_face_day(now), hour, _pedometer_face_add_record, &today_steps);
+    state->hour_steps = hour_steps;
+    state->today_steps = today_steps + hour_steps;
+}
+
+static void _pedometer_face_update_display(pedometer_state_t *state) {
+    char buf[14];
+    watch_date_time date_time;
+    uint16_t steps;
+    int32_t pos = datalog_count(&state->hour_log) + 1 - state->display_index;
+
+    if (!state->counting) {
+        sprintf(buf, "ST  no acc");
+    } else if (state->display_index == 0) {
+        sprintf(buf, "ST%s%6lu", state->log_failed ? "Er" : "  ", (unsigned long)(state->today_steps % 1000000));
+    } else if (state->display_index == 1) {
+        sprintf(buf, "ST%2d%6u", state->minute.unit.hour, state->hour_steps + state->minute_steps);
+    } else if (pos >= 0 && datalog_get(&state->hour_log, pos, &date_time.reg, &steps)) {
+        sprintf(buf, "ST%2d%6u", date_time.unit.hour, steps);
+    } else {
+        state->display_index = 0;
+        _pedometer_face_update_display(state);
+        return;
+    }
+    watch_display_string(buf, 0);
+}
+
+void pedometer_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
+    (void) settings;
+    if (*context_ptr == NULL) {
+        *context_ptr = malloc(sizeof(pedometer_state_t));
+        memset(*context_ptr, 0, sizeof(pedometer_state_t));
+        pedometer_state_t *state = (pedometer_state_t *)*context_ptr;
+        // the filesystem is only 32 blocks of 256 bytes, shared with every other face, so the logs have to be
+        // small. a record is 6 bytes; three segments of 80 minutes (488 bytes, two blocks each) keep at least the
+        // last 160 minutes that had steps in them. writing fifteen at a time (or every hour, whichever comes first)
+        // loses at most that many if the watch resets.
+        state->minute_log.name = "stepmin";
+        state->minute_log.payload_size = sizeof(uint16_t);
+        state->minute_log.num_segments = 3;
+        state->minute_log.records_per_segment = 80;
+        state->minute_log.flush_every = 15;
+        state->log_failed = !datalog_open(&state->minute_log);
+        // and three segments of 40 hours (248 bytes, a block each) keep at least the last 80 hours with steps.
+        // all told, that's nine blocks. an hour is written as soon as it's over.
+        state->hour_log.name = "stephr";
+        state->hour_log.payload_size = sizeof(uint16_t);
+        state->hour_log.num_segments = 3;
+        state->hour_log.records_per_segment = 40;
+        state->hour_log.flush_every = 1;
+        if (!datalog_open(&state->hour_log)) state->log_failed = true;
+        _pedometer_face_restore(state);
+
+        // this is a background face: it counts from the moment the watch starts, not from when it's shown.
+        pedometer_init(&state->pedometer);
+        state->counting = movement_accelerometer_subscribe(PEDOMETER_DATA_RATE, _pedometer_face_receive, state);
+        movement_set_export(watch_face_index, pedometer_face_export);
+    }
+}
+
+void pedometer_face_activate(movement_settings_t *settings, void *context) {
+    (void) settings;
+    pedometer_state_t *state = (pedometer_state_t *)context;
+    state->display_index = 0;
+    // the sensor board might not have been there at setup.
+    if (!state->counting) {
+        state->counting = movement_accelerometer_subscribe(PEDOMETER_DATA_RATE, _pedometer_face_receive, state);
+    }
+}
+
+bool pedometer_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
+    pedometer_state_t *state = (pedometer_state_t *)context;
+    switch (event.event_type) {
+        case EVENT_TIMEOUT:
+            movement_move_to_face(0);
+            break;
+        case EVENT_ALARM_BUTTON_DOWN:
+            state->display_index++;
+            // fall through
+        case EVENT_ACTIVATE:
+        case EVENT_TICK:
+            // catch up on the hour and the day, even if there haven't been any samples since it changed.
+            if (state->counting) _pedometer_face_roll_over(state, watch_rtc_get_date_time());
+            _pedometer_face_update_display(state);
+            break;
+        default:
+            movement_default_loop_handler(event, settings);
+            break;
+    }
+
+    return true;
+}
+
+void pedometer_face_resign(movement_settings_t *settings, void *context) {
+    (void) settings;
+    (void) context;
+    // we keep counting when another face is showing.
+}
+
+static bool _pedometer_face_export_record(uint32_t timestamp, const void *payload, void *user_data) {
+    (void) user_data;
+    watch_date_time date_time;
+    uint16_t steps;
+    date_time.reg = timestamp;
+    memcpy(&steps, payload, sizeof(steps));
+    printf("%04d-%02d-%02d %02d:%02d,%u\r\n",
+           date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day,
+           date_time.unit.hour, date_time.unit.minute, steps);
+    return true;
+}
+
+int32_t pedometer_face_export(movement_settings_t *settings, void *context, int32_t position) {
+    (void) settings;
+    pedometer_state_t *state = (pedometer_state_t *)context;
+    if (position == 0) printf("minute,steps\r\n");
+    int32_t count = datalog_read(&state->minute_log, position, MOVEMENT_EXPORT_RECORDS_PER_CALL, _pedometer_face_export_record, NULL);
+    if (count < 0) return MOVEMENT_EXPORT_FAILED;
+    if (count < MOVEMENT_EXPORT_RECORDS_PER_CALL) return MOVEMENT_EXPORT_DONE;
+    return position + count;
+}
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef PEDOMETER_FACE_H_
+#define PEDOMETER_FACE_H_
+
+/*
+ * PEDOMETER
+ *
+ * Counts your steps with the accelerometer on the Sensor Watch Motion board, all day, whichever face is
+ * showing. The steps are counted on the watch from the accelerometer's samples (see pedometer.h), and kept
+ * on the filesystem a minute and an hour at a time, so they survive a reset.
+ *
+ * The main display shows the letters “ST” and the number of steps so far today, which goes back to 0 at
+ * midnight.
+ *
+ * A short press of the “Alarm” button goes back an hour at a time: the top right shows the hour (in 24 hour
+ * time) and the main line the steps you took in it. The first is the hour you're in now, then the last hours
+ * you took any steps in, back to the oldest one in the log. Another press from there goes back to today.
+ *
+ * If there's no accelerometer, the main line says “no acc”. If the logs can't be written (the filesystem is
+ * full, say), the top right of today's count says “Er” until they can again; the count itself carries on.
+ *
+ * With the watch plugged in to USB, the shell's `dump` command prints the minute by minute log as CSV: the
+ * start of each minute you took any steps in, and how many. The filesystem is small, so it keeps only the
+ * last 160 to 240 such minutes, and the hourly log the last 80 to 120 such hours.
+ *
+ * Keeping the accelerometer sampling all day costs some battery; in its low power mode at 25 Hz, it's a few
+ * microamps, and Movement wakes up about once a second to read it out. That goes on in low energy mode
+ * too, without waking the display.
+ */
+
+#include "movement.h"
+#include "watch.h"
+#include "datalog.h"
+#include "pedometer.h"
+
+typedef struct {
+    pedometer_t pedometer;
+    datalog_t minute_log;       // the steps in each minute with any, as a uint16_t, timestamped with the minute
+    datalog_t hour_log;         // the same for each hour
+    watch_date_time minute;     // the minute we're counting, with the seconds zeroed
+    uint16_t minute_steps;      // steps so far this minute
+    uint16_t hour_steps;        // steps so far this hour, not counting this minute's
+    uint32_t today_steps;       // steps so far today, counting this minute's
+    uint8_t display_index;      // 0 shows today; 1 this hour, 2 the newest in the hour log, and so on
+    bool counting;              // true if we've subscribed to the accelerometer
+    bool log_failed;            // true if the last write to the logs failed
+} pedometer_state_t;
+
+void pedometer_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
+void pedometer_face_activate(movement_settings_t *settings, void *context);
+bool pedometer_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
+void pedometer_face_resign(movement_settings_t *settings, void *context);
+int32_t pedometer_face_export(movement_settings_t *settings, void *context, int32_t position);
+
+#define pedometer_face ((const watch_face_t){ \
+    pedometer_face_setup, \
+    pedometer_face_activate, \
+    pedometer_face_loop, \
+    pedometer_face_resign, \
+    NULL, \
+})
+
+#endif // PEDOMETER_FACE_H_
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "thermistor_logging_face.h"
@@ -31,17 +32,16 @@
 static void _thermistor_logging_face_log_data(thermistor_logger_state_t *logger_state) {
     thermistor_driver_enable();
     watch_date_time date_time = watch_rtc_get_date_time();
-    size_t pos = logger_state->data_points % THERMISTOR_LOGGING_NUM_DATA_POINTS;
-
-    logger_state->data[pos].timestamp.reg = date_time.reg;
-    logger_state->data[pos].temperature_c = thermistor_driver_get_temperature();
-    logger_state->data_points++;
-
+    float temperature_c = thermistor_driver_get_temperature();
     thermistor_driver_disable();
+
+    datalog_append(&logger_state->log, date_time.reg, &temperature_c);
 }
 
 static void _thermistor_logging_face_update_display(thermistor_logger_state_t *logger_state, bool in_fahrenheit, bool clock_mode_24h, bool clock_24h_leading_zero) {
-    int8_t pos = (logger_state->data_points - 1 - logger_state->display_index) % THERMISTOR_LOGGING_NUM_DATA_POINTS;
+    int32_t pos = datalog_count(&logger_state->log) - 1 - logger_state->display_index;
+    watch_date_time date_time;
+    float temperature_c;
     char buf[14];
     bool set_leading_zero = false;
 
@@ -49,10 +49,9 @@ static void _thermistor_logging_face_update_display(thermistor_logger_state_t *l
     watch_clear_indicator(WATCH_INDICATOR_PM);
     watch_clear_colon();
 
-    if (pos < 0) {
+    if (pos < 0 || !datalog_get(&logger_state->log, pos, &date_time.reg, &temperature_c)) {
         sprintf(buf, "TL%2dno dat", logger_state->display_index);
     } else if (logger_state->ts_ticks) {
-        watch_date_time date_time = logger_state->data[pos].timestamp;
         watch_set_colon();
         if (!clock_mode_24h) {
             if (date_time.unit.hour > 11) watch_set_indicator(WATCH_INDICATOR_PM);
@@ -66,9 +65,9 @@ static void _thermistor_logging_face_update_display(thermistor_logger_state_t *l
         sprintf(buf, "AT%2d%2d%02d%02d", date_time.unit.day, date_time.unit.hour, date_time.unit.minute, date_time.unit.second);
     } else {
         if (in_fahrenheit) {
-            sprintf(buf, "TL%2d%4.1f#F", logger_state->display_index, logger_state->data[pos].temperature_c * 1.8 + 32.0);
+            sprintf(buf, "TL%2d%4.1f#F", logger_state->display_index, temperature_c * 1.8 + 32.0);
         } else {
-            sprintf(buf, "TL%2d%4.1f#C", logger_state->display_index, logger_state->data[pos].temperature_c);
+            sprintf(buf, "TL%2d%4.1f#C", logger_state->display_index, temperature_c);
         }
     }
 
@@ -79,10 +78,21 @@ static void _thermistor_logging_face_update_display(thermistor_logger_state_t *l
 
 void thermistor_logging_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
         *context_ptr = malloc(sizeof(thermistor_logger_state_t));
         memset(*context_ptr, 0, sizeof(thermistor_logger_state_t));
+        thermistor_logger_state_t *logger_state = (thermistor_logger_state_t *)*context_ptr;
+        // three segments of 50 always leave at least 100 readings to browse. writing four at a time means
+        // the flash is written every four hours, at the cost of losing up to three readings if the watch resets.
+        logger_state->log.name = "templog";
+        logger_state->log.payload_size = sizeof(float);
+        logger_state->log.num_segments = 3;
+        logger_state->log.records_per_segment = 50;
+        logger_state->log.flush_every = 4;
+        datalog_open(&logger_state->log);
+        // we only log at the top of the hour, so there's no need to be asked every minute.
+        movement_set_background_cadence(watch_face_index, MOVEMENT_BACKGROUND_HOURLY, 0, 0);
+        movement_set_export(watch_face_index, thermistor_logging_face_export);
     }
 }
 
@@ -132,13 +142,37 @@ bool thermistor_logging_face_loop(movement_event_t event, movement_settings_t *s
 
 void thermistor_logging_face_resign(movement_settings_t *settings, void *context) {
     (void) settings;
-    (void) context;
+    thermistor_logger_state_t *logger_state = (thermistor_logger_state_t *)context;
+    datalog_flush(&logger_state->log);
 }
 
 bool thermistor_logging_face_wants_background_task(movement_settings_t *settings, void *context) {
     (void) settings;
     (void) context;
-    // this will get called at the top of each minute, so all we check is if we're at the top of the hour as well.
-    // if we are, we ask for a background task.
+    // we asked for an hourly cadence in setup, so this should only be called at the top of the hour;
+    // still, double check before asking for a background task.
     return watch_rtc_get_date_time().unit.minute == 0;
 }
+
+static bool _thermistor_logging_face_export_record(uint32_t timestamp, const void *payload, void *user_data) {
+    (void) user_data;
+    watch_date_time date_time;
+    float temperature_c;
+    date_time.reg = timestamp;
+    memcpy(&temperature_c, payload, sizeof(temperature_c));
+    printf("%04d-%02d-%02d %02d:%02d:%02d,%.1f\r\n",
+           date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day,
+           date_time.unit.hour, date_time.unit.minute, date_time.unit.second, temperature_c);
+    return true;
+}
+
+int32_t thermistor_logging_face_export(movement_settings_t *settings, void *context, int32_t position) {
+    (void) settings;
+    thermistor_logger_state_t *logger_state = (thermistor_logger_state_t *)context;
+    if (position == 0) printf("time,celsius\r\n");
+    // the log, oldest first, straight from its segment files, a few records at a time.
+    int32_t count = datalog_read(&logger_state->log, position, MOVEMENT_EXPORT_RECORDS_PER_CALL, _thermistor_logging_face_export_record, NULL);
+    if (count < 0) return MOVEMENT_EXPORT_FAILED;
+    if (count < MOVEMENT_EXPORT_RECORDS_PER_CALL) return MOVEMENT_EXPORT_DONE;
+    return position + count;
+}
@@ -29,7 +29,8 @@
  * THERMISTOR LOGGING (aka Temperature Log)
  *
  * This watch face automatically logs the temperature once an hour, and
- * maintains a 36-hour log of readings. This watch face is admittedly rather
+ * keeps the log on the filesystem, so it survives a reset. You can browse
+ * the last 100 hours of readings. This watch face is admittedly rather
  * complex, and bears some explanation.
  *
  * The main display shows the letters “TL” in the top left, indicating the
@@ -40,7 +41,7 @@
  *
  * A short press of the “Alarm” button advances to the next oldest reading;
  * you will see the number at the top right advance from 0 to 1 to 2, all
- * the way to 35, the oldest reading available.
+ * the way to 99, the oldest reading available.
  *
  * A short press of the “Light” button will briefly display the timestamp
  * of the reading. The letters at the top left will display the word “At”,
@@ -51,23 +52,22 @@
  *
  * If you need to illuminate the LED to read the data point, long press the
  * Light button and release it.
+ *
+ * With the watch plugged in to USB, the shell's `dump` command prints the
+ * whole log as CSV: the time of each reading, and the temperature in °C.
  */
 
 #include "movement.h"
 #include "watch.h"
+#include "datalog.h"
 
-#define THERMISTOR_LOGGING_NUM_DATA_POINTS (36)
-
-typedef struct {
-    watch_date_time timestamp;
-    float temperature_c;
-} thermistor_logger_data_point_t;
+// the number of readings you can browse; the display has room for a two-digit index.
+#define THERMISTOR_LOGGING_NUM_DATA_POINTS (100)
 
 typedef struct {
     uint8_t display_index;  // the index we are displaying on screen
     uint8_t ts_ticks;       // when the user taps the LIGHT button, we show the timestamp for a few ticks.
-    int32_t data_points;    // the absolute number of data points logged
-    thermistor_logger_data_point_t data[THERMISTOR_LOGGING_NUM_DATA_POINTS];
+    datalog_t log;          // readings as floats in degrees Celsius, timestamped with a watch_date_time's reg
 } thermistor_logger_state_t;
 
 void thermistor_logging_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
@@ -75,6 +75,7 @@ void thermistor_logging_face_activate(movement_settings_t *settings, void *conte
 bool thermistor_logging_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void thermistor_logging_face_resign(movement_settings_t *settings, void *context);
 bool thermistor_logging_face_wants_background_task(movement_settings_t *settings, void *context);
+int32_t thermistor_logging_face_export(movement_settings_t *settings, void *context, int32_t position);
 
 #define thermistor_logging_face ((const watch_face_t){ \
     thermistor_logging_face_setup, \
@@ -103,6 +103,7 @@ static void finetune_adjust_subseconds(int delta) {
     finetune_update_display();
 
     // Then delay clock
+    watch_display_commit();
     watch_rtc_enable(false);
     delay_ms(delta);
     if (delta > 500) {
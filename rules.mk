@@ -8,18 +8,24 @@ SUBMODULES = tinyusb
 
 COBRA = cobra -f
 
-ifndef EMSCRIPTEN
+ifdef HOST
+all: $(BUILD)/$(BIN)
+else ifndef EMSCRIPTEN
 all: $(BUILD)/$(BIN).elf $(BUILD)/$(BIN).hex $(BUILD)/$(BIN).bin $(BUILD)/$(BIN).uf2 size
 else
 all: $(BUILD)/$(BIN).html
 endif
 
+$(BUILD)/$(BIN): $(OBJS)
+	@echo LD $@
+	@$(CC) $(LDFLAGS) $(OBJS) $(LIBS) -o $@
+
 $(BUILD)/$(BIN).html: $(OBJS)
 	@echo HTML $@
 	@$(CC) $(LDFLAGS) $(OBJS) $(LIBS) -o $@ \
 		-s ASYNCIFY=1 \
 		-s EXPORTED_RUNTIME_METHODS=lengthBytesUTF8,printErr \
-		-s EXPORTED_FUNCTIONS=_main \
+		-s EXPORTED_FUNCTIONS=_main,_main_loop_set_speed \
 		--shell-file=$(TOP)/watch-library/simulator/shell.html
 
 $(BUILD)/$(BIN).elf: $(OBJS)
@@ -45,6 +51,43 @@ $(SUBMODULES):
 install:
 	@$(UF2) -D $(BUILD)/$(BIN).uf2
 
+# the glyph table that watch_display_character draws from is generated from the character set and segment map.
+$(BUILD)/watch_glyphs.h: $(TOP)/watch-library/shared/watch/watch_private_display.h $(TOP)/utils/make_glyph_table.py | directory
+	@echo GEN $@
+	@python3 $(TOP)/utils/make_glyph_table.py $< > $@
+
+$(BUILD)/watch_private_display.o: $(BUILD)/watch_glyphs.h
+
+ifdef HOST
+# benchmarks for the host build; `make HOST=1 bench` builds and runs them.
+BENCHES += $(BUILD)/display_bench $(BUILD)/lis2dw_bench
+
+bench: $(BENCHES)
+	@for bench in $(BENCHES); do echo $$bench; $$bench || exit 1; done
+
+# tests for the host build; `make HOST=1 test` builds and runs them, and stops at the first failure.
+TESTS += $(BUILD)/watch_i2c_test $(BUILD)/lis2dw_test
+
+test: $(TESTS)
+	@for test in $(TESTS); do echo $$test; $$test || exit 1; done
+
+$(BUILD)/display_bench: $(TOP)/watch-library/host/bench/display_bench.c $(BUILD)/watch_private_display.o
+	@echo LD $@
+	@$(CC) $(CFLAGS) $^ $(LIBS) -o $@
+
+$(BUILD)/lis2dw_bench: $(TOP)/watch-library/host/bench/lis2dw_bench.c $(BUILD)/lis2dw.o $(BUILD)/watch_i2c.o $(BUILD)/main_loop.o
+	@echo LD $@
+	@$(CC) $(CFLAGS) $^ $(LIBS) -o $@
+
+$(BUILD)/watch_i2c_test: $(TOP)/watch-library/host/test/watch_i2c_test.c $(BUILD)/watch_i2c.o $(BUILD)/main_loop.o
+	@echo LD $@
+	@$(CC) $(CFLAGS) $^ $(LIBS) -o $@
+
+$(BUILD)/lis2dw_test: $(TOP)/watch-library/host/test/lis2dw_test.c $(TOP)/watch-library/host/test/lis2dw_mock.c $(BUILD)/lis2dw.o $(BUILD)/watch_i2c.o $(BUILD)/main_loop.o
+	@echo LD $@
+	@$(CC) $(CFLAGS) $^ $(LIBS) -o $@
+endif
+
 $(BUILD)/%.o: | $(SUBMODULES) directory
 	@echo CC $@
 	@$(CC) $(CFLAGS) $(filter %/$(subst .o,.c,$(notdir $@)), $(SRCS)) -c -o $@
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Generates the glyph table that watch_display_character draws from.
+
+For every position on the display and every printable character, this works out which segments
+should be lit, including all of the position-specific substitutions that make characters legible
+on the F-91W's odd segment layout. The output is a C header with two tables:
+
+  Glyph_Masks[position][com]: the segments that belong to each position, one word per COM line.
+  Glyph_Table[position][character - 0x20][com]: the state of those segments for each character.
+
+Drawing a character is then one lookup and a masked write of three words.
+
+Usage: make_glyph_table.py path/to/watch_private_display.h > watch_glyphs.h
+"""
+
+import re
+import sys
+
+NUM_POSITIONS = 10
+NUM_COMS = 3
+
+
+def parse_tables(header):
+    character_set = re.search(r"Character_Set\[\]\s*=\s*\{(.*?)\};", header, re.S).group(1)
+    segment_map = re.search(r"Segment_Map\[\]\s*=\s*\{(.*?)\};", header, re.S).group(1)
+    character_set = [int(value, 2) for value in re.findall(r"0b([01]{8})", character_set)]
+    segment_map = [int(value, 16) for value in re.findall(r"0x([0-9a-fA-F]+)", segment_map)]
+    assert len(character_set) == 0x7F - 0x20, "Character_Set should cover ' ' through '~'"
+    assert len(segment_map) == NUM_POSITIONS, "Segment_Map should have one entry per position"
+    return character_set, segment_map
+
+
+def substitute(character, position):
+    """Swaps in a character that displays better in this position."""
+    # special cases for positions 4 and 6
+    if position in (4, 6):
+        character = {
+            '7': '&',  # "lowercase" 7
+            'A': 'a',  # A needs to be lowercase
+            'o': 'O',  # O needs to be uppercase
+            'L': '!',  # L needs to be in top half
+            'M': 'n', 'm': 'n', 'N': 'n',  # M and uppercase N need to be lowercase n
+            'c': 'C',  # C needs to be uppercase
+            'J': 'j',  # same
+            't': '+', 'T': '+',  # t in those locations looks like E otherwise
+            'y': '4', 'Y': '4',  # y in those locations looks like g otherwise
+            'v': 'u', 'V': 'u', 'U': 'u', 'W': 'u', 'w': 'u',  # bottom segment duplicated, so show in top half
+        }.get(character, character)
+    else:
+        character = {
+            'u': 'v',  # we can use the bottom segment; move to lower half
+            'j': 'J',  # same but just display a normal J
+        }.get(character, character)
+    if position > 1:
+        if character == 'T':
+            character = 't'  # uppercase T only works in positions 0 and 1
+    if position == 1:
+        character = {
+            'a': 'A',  # A needs to be uppercase
+            'o': 'O',  # O needs to be uppercase
+            'i': 'l',  # I needs to be uppercase (use an l, it looks the same)
+            'n': 'N',  # N needs to be uppercase
+            'r': 'R',  # R needs to be uppercase
+            'd': 'D',  # D needs to be uppercase
+            'v': 'U', 'V': 'U', 'u': 'U',  # side segments shared, make uppercase
+            'b': 'B',  # B needs to be uppercase
+            'c': 'C',  # C needs to be uppercase
+        }.get(character, character)
+    else:
+        if character == 'R':
+            character = 'r'  # R needs to be lowercase almost everywhere
+    if position != 0:
+        if character == 'I':
+            character = 'l'  # uppercase I only works in position 0
+    return character
+
+
+def render(character, position, character_set, segment_map):
+    """Returns (mask, value): the segments this position owns, and which of them this character lights."""
+    mask = [0] * NUM_COMS
+    value = [0] * NUM_COMS
+
+    def write(com, seg, on):
+        mask[com] |= 1 << seg
+        if on:
+            value[com] |= 1 << seg
+        else:
+            value[com] &= ~(1 << seg)
+
+    character = substitute(character, position)
+
+    if position == 0:
+        write(0, 15, False)  # clear funky ninth segment
+
+    segmap = segment_map[position]
+    segdata = character_set[ord(character) - 0x20]
+    # segments are written in order, so where two of them share a pixel, the later one wins.
+    for _ in range(8):
+        com = (segmap & 0xFF) >> 6
+        if com <= 2:  # COM3 means no segment exists; skip it.
+            write(com, segmap & 0x3F, segdata & 1)
+        segmap >>= 8
+        segdata >>= 1
+
+    if character == 'T' and position == 1:
+        write(1, 12, True)  # add descender
+    elif position == 0 and character in 'BD@':
+        write(0, 15, True)  # add funky ninth segment
+    elif position == 1 and character in 'BD@':
+        write(0, 12, True)  # add funky ninth segment
+
+    return mask, value
+
+
+def words(values):
+    return "{ " + ", ".join("0x%06x" % word for word in values) + " }"
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip().splitlines()[-1])
+
+    with open(sys.argv[1]) as f:
+        character_set, segment_map = parse_tables(f.read())
+
+    characters = [chr(c) for c in range(0x20, 0x7F)]
+    out = sys.stdout
+    out.write("// generated by utils/make_glyph_table.py from watch_private_display.h; do not edit.\n\n")
+    out.write("static const uint32_t Glyph_Masks[%d][%d] = {\n" % (NUM_POSITIONS, NUM_COMS))
+    for position in range(NUM_POSITIONS):
+        mask, _ = render(' ', position, character_set, segment_map)
+        # the masked write relies on every character writing the same segments in a given position.
+        assert all(render(c, position, character_set, segment_map)[0] == mask for c in characters)
+        out.write("    %s, // position %d\n" % (words(mask), position))
+    out.write("};\n\n")
+
+    out.write("static const uint32_t Glyph_Table[%d][%d][%d] = {\n" % (NUM_POSITIONS, len(characters), NUM_COMS))
+    for position in range(NUM_POSITIONS):
+        out.write("    { // position %d\n" % position)
+        for character in characters:
+            _, value = render(character, position, character_set, segment_map)
+            name = {' ': "space", '\\': "backslash"}.get(character, character)
+            out.write("        %s, // %s\n" % (words(value), name))
+        out.write("    },\n")
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Packs constant data files into a resource pack that Movement reads in place from flash.
+
+A pack is a header, an index sorted by name, and the resources themselves, all little-endian and
+4-byte aligned:
+
+  header:  uint32 magic ('RSRC'), uint16 version, uint16 count
+  index:   count entries of char name[16], uint32 offset, uint32 size, uint16 record_size, uint16 reserved
+  data:    each resource at its offset from the start of the pack
+
+A resource is either a raw file, or a text file with one fixed-size record per line (for word lists
+and the like). Records are padded with NULs out to the record size but are not terminated, so a
+five-letter word costs five bytes.
+
+Usage: make_resource_pack.py [--bin pack.bin] path[:record_size] ... > resource_pack.h
+
+The header defines the pack as a byte array for resources.c to link in. --bin also writes the raw
+pack, for programming into a dedicated flash region instead.
+"""
+
+import os
+import struct
+import sys
+
+MAGIC = 0x43525352  # 'RSRC'
+VERSION = 1
+NAME_SIZE = 16
+HEADER = struct.Struct("<IHH")
+ENTRY = struct.Struct(f"<{NAME_SIZE}sIIHH")
+
+
+def load(spec):
+    path, _, record_size = spec.partition(":")
+    name = os.path.splitext(os.path.basename(path))[0]
+    assert len(name) < NAME_SIZE, f"{name}: resource names are at most {NAME_SIZE - 1} characters"
+    if not record_size:
+        with open(path, "rb") as f:
+            return name, f.read(), 0
+    record_size = int(record_size)
+    data = bytearray()
+    with open(path) as f:
+        for line in f:
+            record = line.strip().encode("ascii")
+            if not record:
+                continue
+            assert len(record) <= record_size, f"{path}: {record} is longer than {record_size} bytes"
+            data += record.ljust(record_size, b"\0")
+    return name, bytes(data), record_size
+
+
+def pack(resources):
+    resources = sorted(resources)
+    offset = HEADER.size + ENTRY.size * len(resources)
+    index = bytearray(HEADER.pack(MAGIC, VERSION, len(resources)))
+    data = bytearray()
+    for name, contents, record_size in resources:
+        index += ENTRY.pack(name.encode("ascii"), offset + len(data), len(contents), record_size, 0)
+        data += contents
+        data += bytes(-len(data) % 4)
+    return bytes(index + data)
+
+
+def main(args):
+    bin_path = None
+    if args and args[0] == "--bin":
+        bin_path = args[1]
+        args = args[2:]
+    blob = pack([load(spec) for spec in args])
+    if bin_path:
+        with open(bin_path, "wb") as f:
+            f.write(blob)
+
+    print("// generated by utils/make_resource_pack.py; do not edit.")
+    print("#include <stdint.h>")
+    print("")
+    print(f"static const uint8_t resource_pack[{len(blob)}] __attribute__((aligned(4))) = {{")
+    for i in range(0, len(blob), 16):
+        print("    " + " ".join(f"0x{byte:02x}," for byte in blob[i:i + 16]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Copies files to and from a watch's filesystem over the USB serial shell.
+
+Files travel in base64 blocks, each checked with a CRC-32, using the put, blk and get commands (see
+movement/file_transfer.h). A block that comes through garbled is sent again, and if the link drops partway
+through an upload, running the same upload again carries on from where the watch got to.
+
+Usage:
+  shell_transfer.py [--port /dev/ttyACM0 | --exec COMMAND] put LOCAL [REMOTE]
+  shell_transfer.py [--port /dev/ttyACM0 | --exec COMMAND] get REMOTE [LOCAL]
+
+--port needs pyserial. --exec talks to a program's standard input and output instead, like the host build
+of the firmware: --exec "build-host/watch -u".
+"""
+
+import argparse
+import base64
+import os
+import re
+import shlex
+import subprocess
+import sys
+import zlib
+
+BLOCK_SIZE = 144  # FILE_TRANSFER_BLOCK_SIZE
+RETRIES = 5
+REPLY = re.compile(r"^(ok|done|err|file|blk)\b(.*)$")
+
+
+class TransferError(Exception):
+    pass
+
+
+class SerialLink:
+    def __init__(self, port, timeout=2):
+        import serial
+        self.serial = serial.Serial(port, 115200, timeout=timeout)
+
+    def write_line(self, line):
+        self.serial.write((line + "\r\n").encode("ascii"))
+
+    def read_line(self):
+        line = self.serial.readline()
+        if not line:
+            raise TimeoutError()
+        return line.decode("ascii", "replace")
+
+    def close(self):
+        self.serial.close()
+
+
+class ProcessLink:
+    def __init__(self, command):
+        self.process = subprocess.Popen(shlex.split(command), stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        stderr=subprocess.DEVNULL)
+
+    def write_line(self, line):
+        self.process.stdin.write((line + "\n").encode("ascii"))
+        self.process.stdin.flush()
+
+    def read_line(self):
+        line = self.process.stdout.readline()
+        if not line:
+            raise TransferError("the shell went away")
+        return line.decode("ascii", "replace")
+
+    def close(self):
+        self.process.kill()
+        self.process.wait()
+
+
+class Transfer:
+    def __init__(self, link):
+        self.link = link
+
+    def command(self, line):
+        """Sends a command and returns its reply as (word, arguments), skipping the shell's echo and prompts."""
+        for _ in range(RETRIES):
+            self.link.write_line(line)
+            try:
+                while True:
+                    reply = REPLY.match(self.link.read_line().strip())
+                    if reply:
+                        return reply.group(1), reply.group(2).split()
+            except TimeoutError:
+                continue
+        raise TransferError(f"no reply to {line.split()[0]}")
+
+    def put(self, data, remote, progress=None):
+        crc = zlib.crc32(data)
+        word, args = self.command(f"put {remote} {len(data)} {crc:08x}")
+        last_offset, failures = -1, 0
+        while word != "done":
+            if word not in ("ok", "err") or (word == "err" and len(args) < 2):
+                raise TransferError(f"upload failed: {word} {' '.join(args)}")
+            # after an error, the watch says where it's got to; carry on from there.
+            offset = int(args[-1])
+            failures = failures + 1 if offset <= last_offset else 0
+            if failures > RETRIES:
+                raise TransferError(f"upload stuck at {offset}")
+            last_offset = offset
+            if progress:
+                progress(offset, len(data))
+            block = data[offset:offset + BLOCK_SIZE]
+            word, args = self.command(f"blk {offset} {base64.b64encode(block).decode()} {zlib.crc32(block):08x}")
+
+    def get(self, remote, progress=None):
+        word, args = self.command(f"get {remote}")
+        if word != "file":
+            raise TransferError(f"can't get {remote}: {' '.join(args)}")
+        size, crc = int(args[0]), int(args[1], 16)
+        data = bytearray()
+        while len(data) < size:
+            for _ in range(RETRIES):
+                word, args = self.command(f"get {remote} {len(data)}")
+                if word != "blk" or int(args[0]) != len(data):
+                    continue
+                block = base64.b64decode(args[1])
+                if zlib.crc32(block) == int(args[2], 16):
+                    break
+            else:
+                raise TransferError(f"couldn't read {remote} at {len(data)}")
+            data += block
+            if progress:
+                progress(len(data), size)
+        if zlib.crc32(data) != crc:
+            raise TransferError(f"{remote} doesn't match its CRC")
+        return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Copies files to and from a watch over the USB serial shell.")
+    link = parser.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="the watch's serial port")
+    link.add_argument("--exec", help="a command to talk to instead, like the host build: build-host/watch -u")
+    parser.add_argument("direction", choices=["put", "get"])
+    parser.add_argument("source")
+    parser.add_argument("destination", nargs="?")
+    args = parser.parse_args()
+
+    link = SerialLink(args.port) if args.port else ProcessLink(args.exec)
+
+    def progress(done, total):
+        print(f"\r{done}/{total} bytes", end="", file=sys.stderr)
+
+    try:
+        transfer = Transfer(link)
+        if args.direction == "put":
+            with open(args.source, "rb") as f:
+                transfer.put(f.read(), args.destination or os.path.basename(args.source), progress)
+        else:
+            data = transfer.get(args.source, progress)
+            with open(args.destination or os.path.basename(args.source), "wb") as f:
+                f.write(data)
+        print("", file=sys.stderr)
+    except TransferError as error:
+        print(f"\n{error}", file=sys.stderr)
+        return 1
+    finally:
+        link.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,4 +1,4 @@
-import random, itertools, time, numpy
+import random, itertools, time, numpy, os
 
 source_link = "https://matthewminer.name/projects/calculators/wordle-words-left/"
 valid_list = [
@@ -1153,9 +1153,15 @@ def clean_chars(string):
     return string
 
 
-def print_valid_words(letters=alphabet):
+def write_word_list(path, words):
+    with open(path, "w") as f:
+        for word in words:
+            f.write(f"{clean_chars(word)}\n")
+
+
+def print_valid_words(letters=alphabet, resources_dir=os.path.join(os.path.dirname(__file__), "../../movement/resources")):
     '''
-    Prints the array of valid words that the wordle_face.c can use
+    Writes the word lists that wordle_face.c reads from the resource pack, and prints the wordle_face_dict.h that goes with them
     '''
     print("#ifndef WORDLE_FACE_DICT_H_")
     print("#define WORDLE_FACE_DICT_H_")
@@ -1168,7 +1174,6 @@ def print_valid_words(letters=alphabet):
     print("#define WORDLE_USE_RANDOM_GUESS 2")
     print("#endif\n")
     
-    items_per_row = 9
     top_words_percent = 3
     valid_words = list_of_valid_words(letters, valid_list)
     valid_words = capitalize_all_and_remove_duplicates(valid_words)
@@ -1186,40 +1191,24 @@ def print_valid_words(letters=alphabet):
         print(f"'{clean_chars(letter)}', ", end='')
     print(f"'{letters[-1]}'" + "};")
     print("")
-    print(f"// From: {source_link}")
-    print(f"// Number of words found: {len(valid_words)}")
-    print("static const char _valid_words[][WORDLE_LENGTH + 1] = {")
-    i = 0
-    while i < len(valid_words):
-        print("    ", end='')
-        for _ in range(min(items_per_row, len(valid_words)-i)):
-            print(f'"{clean_chars(valid_words[i])}", ', end='')
-            i+=1
-        print('')
     possible_words = list_of_valid_words(letters, possible_list)
     possible_words = [word for word in possible_words if word not in valid_list]
     possible_words = capitalize_all_and_remove_duplicates(possible_words)
-    print("};")
-    print("\n// These are words that'll never be used, but still need to be in the dictionary for guesses.")
-    print(f"// Number of words found: {len(possible_words)}")
-    print("static const char _possible_words[][WORDLE_LENGTH + 1] = {")
+    write_word_list(os.path.join(resources_dir, "wordle_valid.txt"), valid_words)
+    write_word_list(os.path.join(resources_dir, "wordle_possible.txt"), possible_words)
+    print("// The word lists themselves live in the resource pack, built from movement/resources/wordle_valid.txt")
+    print(f"// ({len(valid_words)} words, from {source_link}). Each word is WORDLE_LENGTH bytes, with no terminator.")
     print("#if !WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES")
-    i = 0
-    while i < len(possible_words):
-        print("    ", end='')
-        for j in range(min(items_per_row, len(possible_words)-i)):
-            print(f'"{clean_chars(possible_words[i])}", ', end='')
-            i+=1
-        print('')
-    print("#endif")
-    print("};\n")
+    print(f"// movement/resources/wordle_possible.txt has {len(possible_words)} words that'll never be used, but still need to be in the")
+    print("// dictionary for guesses. Build with `make WORDLE_ALLOW_NON_WORD_AND_REPEAT_GUESSES=1` to leave it out of the pack.")
+    print("#endif\n")
     
     print("#if (WORDLE_USE_RANDOM_GUESS == 3)")
     print(f"static const uint16_t _num_random_guess_words = {num_best_words};  // The valid_words array begins with this many words that are considered the top {top_words_percent}% best options.")
     print("#elif (WORDLE_USE_RANDOM_GUESS == 2)")
     print(f"static const uint16_t _num_random_guess_words = {num_uniq};  // The valid_words array begins with this many words where each letter is different.")
     print("#elif (WORDLE_USE_RANDOM_GUESS == 1)")
-    print("static const uint16_t _num_random_guess_words = _num_words;")
+    print("static const uint16_t _num_random_guess_words = 0;  // Any word in the valid_words list.")
     print("#endif")
     print("\n#endif // WORDLE_FACE_DICT_H_")
 
@@ -52,7 +52,7 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 
-#ifndef __EMSCRIPTEN__
+#if !defined(__EMSCRIPTEN__) && !defined(WATCH_HOST)
 #ifndef _UNIT_TEST_
 #include "parts.h"
 #endif
@@ -79,7 +79,10 @@ int main(void) {
     while (1) {
         bool usb_enabled = hri_usbdevice_get_CTRLA_ENABLE_bit(USB);
         bool can_sleep = app_loop();
+        watch_display_commit();
         if (can_sleep && !usb_enabled) {
+            // let any write or erase finish before the clocks stop for standby.
+            watch_storage_sync();
             app_prepare_for_standby();
             sleep(4);
             app_wake_from_standby();
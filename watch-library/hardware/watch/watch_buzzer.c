@@ -170,6 +170,8 @@ inline void watch_set_buzzer_off(void) {
 }
 
 void watch_buzzer_play_note(BuzzerNote note, uint16_t duration_ms) {
+    // we're about to block, so show whatever was drawn to go with this note.
+    watch_display_commit();
     if (note == BUZZER_NOTE_REST) {
         watch_set_buzzer_off();
     } else {
@@ -152,6 +152,9 @@ static void _watch_disable_all_peripherals_except_slcd(void) {
 }
 
 void watch_enter_sleep_mode(void) {
+    // whatever is on screen now is what we'll show while we sleep.
+    watch_display_commit();
+
     // disable all other peripherals
     _watch_disable_all_peripherals_except_slcd();
 
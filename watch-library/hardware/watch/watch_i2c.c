@@ -22,29 +22,174 @@
  * SOFTWARE.
  */
 
+
 #include "watch_i2c.h"
 
-struct io_descriptor *I2C_0_io;
+// transactions waiting for the bus, oldest first. the one at the head is on the bus now.
+static watch_i2c_transaction_t *queue_head;
+static watch_i2c_transaction_t *queue_tail;
+// how far the transaction at the head has got: the next byte to send or receive, and which half it's in.
+static uint16_t position;
+static bool reading;
+
+#define WATCH_I2C_CMD_STOP 3
+
+static void _watch_i2c_send_address(watch_i2c_transaction_t *transaction, bool read) {
+    reading = read;
+    position = 0;
+    // smart mode acknowledges each byte as we read it out of DATA; the last one gets a NACK instead.
+    hri_sercomi2cm_clear_CTRLB_ACKACT_bit(SERCOM1);
+    hri_sercomi2cm_set_CTRLB_SMEN_bit(SERCOM1);
+    hri_sercomi2cm_write_ADDR_reg(SERCOM1, ((transaction->addr & 0x7F) << 1) | (read ? 1 : 0) |
+                                           (hri_sercomi2cm_read_ADDR_reg(SERCOM1) & SERCOM_I2CM_ADDR_HS));
+}
+
+static void _watch_i2c_start(void) {
+    watch_i2c_transaction_t *transaction = queue_head;
+    if (transaction == NULL) return;
+    _watch_i2c_send_address(transaction, transaction->write_length == 0);
+}
+
+// takes the transaction off the queue, gets the next one going, and then tells whoever's waiting.
+static void _watch_i2c_finish(watch_i2c_status_t status) {
+    watch_i2c_transaction_t *transaction = queue_head;
+
+    queue_head = transaction->next;
+    if (queue_head == NULL) queue_tail = NULL;
+    transaction->next = NULL;
+    _watch_i2c_start();
+
+    transaction->status = status;
+    if (transaction->callback != NULL) transaction->callback(transaction);
+}
+
+void SERCOM1_Handler(void) {
+    uint8_t flags = hri_sercomi2cm_read_INTFLAG_reg(SERCOM1);
+    uint16_t status = hri_sercomi2cm_read_STATUS_reg(SERCOM1);
+    watch_i2c_transaction_t *transaction = queue_head;
+
+    if (transaction == NULL) {
+        hri_sercomi2cm_clear_INTFLAG_reg(SERCOM1, SERCOM_I2CM_INTFLAG_MB | SERCOM_I2CM_INTFLAG_SB | SERCOM_I2CM_INTFLAG_ERROR);
+        return;
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_ERROR) {
+        hri_sercomi2cm_clear_INTFLAG_reg(SERCOM1, SERCOM_I2CM_INTFLAG_ERROR);
+        if (!(flags & (SERCOM_I2CM_INTFLAG_MB | SERCOM_I2CM_INTFLAG_SB))) return;
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_MB) {
+        // the address went out, or a byte of the write half did.
+        if (status & (SERCOM_I2CM_STATUS_ARBLOST | SERCOM_I2CM_STATUS_BUSERR)) {
+            // we've already lost the bus, so there's no stop to send.
+            hri_sercomi2cm_clear_INTFLAG_reg(SERCOM1, SERCOM_I2CM_INTFLAG_MB);
+            _watch_i2c_finish(WATCH_I2C_ERROR);
+        } else if (status & SERCOM_I2CM_STATUS_RXNACK) {
+            hri_sercomi2cm_set_CTRLB_CMD_bf(SERCOM1, WATCH_I2C_CMD_STOP);
+            _watch_i2c_finish(WATCH_I2C_NACK);
+        } else if (position < transaction->write_length) {
+            hri_sercomi2cm_write_DATA_reg(SERCOM1, transaction->write_buf[position++]);
+        } else if (transaction->read_length > 0) {
+            // a repeated start, straight into the read half.
+            _watch_i2c_send_address(transaction, true);
+        } else {
+            hri_sercomi2cm_set_CTRLB_CMD_bf(SERCOM1, WATCH_I2C_CMD_STOP);
+            _watch_i2c_finish(WATCH_I2C_DONE);
+        }
+    } else if (flags & SERCOM_I2CM_INTFLAG_SB) {
+        // a byte of the read half came in.
+        if (position + 1 == transaction->read_length) {
+            // NACK the last one and stop, before reading DATA, so that reading it doesn't ask for another.
+            hri_sercomi2cm_clear_CTRLB_SMEN_bit(SERCOM1);
+            hri_sercomi2cm_set_CTRLB_ACKACT_bit(SERCOM1);
+            hri_sercomi2cm_set_CTRLB_CMD_bf(SERCOM1, WATCH_I2C_CMD_STOP);
+            transaction->read_buf[position++] = hri_sercomi2cm_read_DATA_reg(SERCOM1);
+            _watch_i2c_finish(WATCH_I2C_DONE);
+        } else {
+            transaction->read_buf[position++] = hri_sercomi2cm_read_DATA_reg(SERCOM1);
+        }
+    }
+}
 
 void watch_enable_i2c(void) {
     I2C_0_init();
-    i2c_m_sync_get_io_descriptor(&I2C_0, &I2C_0_io);
     i2c_m_sync_enable(&I2C_0);
+    hri_sercomi2cm_set_INTEN_reg(SERCOM1, SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR);
+    NVIC_ClearPendingIRQ(SERCOM1_IRQn);
+    NVIC_EnableIRQ(SERCOM1_IRQn);
 }
 
 void watch_disable_i2c(void) {
+    while (queue_head != NULL) watch_i2c_wait(queue_head);
+    NVIC_DisableIRQ(SERCOM1_IRQn);
+    hri_sercomi2cm_clear_INTEN_reg(SERCOM1, SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR);
     i2c_m_sync_disable(&I2C_0);
 	hri_mclk_clear_APBCMASK_SERCOM1_bit(MCLK);
 }
 
+void watch_i2c_submit(watch_i2c_transaction_t *transaction) {
+    transaction->status = WATCH_I2C_PENDING;
+    transaction->next = NULL;
+    if (!hri_sercomi2cm_get_CTRLA_ENABLE_bit(SERCOM1)) {
+        transaction->status = WATCH_I2C_ERROR;
+        if (transaction->callback != NULL) transaction->callback(transaction);
+        return;
+    }
+
+    __disable_irq();
+    if (queue_tail == NULL) {
+        queue_head = queue_tail = transaction;
+        _watch_i2c_start();
+    } else {
+        queue_tail->next = transaction;
+        queue_tail = transaction;
+    }
+    __enable_irq();
+}
+
+bool watch_i2c_wait(watch_i2c_transaction_t *transaction) {
+    while (transaction->status == WATCH_I2C_PENDING) {
+        if (__get_IPSR() != 0) {
+            // we're in an interrupt handler, so the I2C interrupt can't get in; do its job for it.
+            if (hri_sercomi2cm_read_INTFLAG_reg(SERCOM1) & (SERCOM_I2CM_INTFLAG_MB | SERCOM_I2CM_INTFLAG_SB | SERCOM_I2CM_INTFLAG_ERROR)) {
+                SERCOM1_Handler();
+            }
+            continue;
+        }
+        // the same dance as watch_storage_sync: mask interrupts so the last one can't slip in between the check
+        // and the sleep. it still wakes us, and runs once we unmask.
+        __disable_irq();
+        if (transaction->status == WATCH_I2C_PENDING) sleep(2);
+        __enable_irq();
+    }
+
+    return transaction->status == WATCH_I2C_DONE;
+}
+
+bool watch_i2c_busy(void) {
+    return queue_head != NULL;
+}
+
+bool watch_i2c_write_read(int16_t addr, const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length) {
+    watch_i2c_transaction_t transaction = {
+        .addr = addr,
+        .write_buf = write_buf,
+        .write_length = write_length,
+        .read_buf = read_buf,
+        .read_length = read_length,
+    };
+
+    if (write_length == 0 && read_length == 0) return true;
+    watch_i2c_submit(&transaction);
+    return watch_i2c_wait(&transaction);
+}
+
 void watch_i2c_send(int16_t addr, uint8_t *buf, uint16_t length) {
-    i2c_m_sync_set_periphaddr(&I2C_0, addr, I2C_M_SEVEN);
-    io_write(I2C_0_io, buf, length);
+    watch_i2c_write_read(addr, buf, length, NULL, 0);
 }
 
 void watch_i2c_receive(int16_t addr, uint8_t *buf, uint16_t length) {
-    i2c_m_sync_set_periphaddr(&I2C_0, addr, I2C_M_SEVEN);
-    io_read(I2C_0_io, buf, length);
+    watch_i2c_write_read(addr, NULL, 0, buf, length);
 }
 
 void watch_i2c_write8(int16_t addr, uint8_t reg, uint8_t data) {
@@ -56,19 +201,17 @@ void watch_i2c_write8(int16_t addr, uint8_t reg, uint8_t data) {
 }
 
 uint8_t watch_i2c_read8(int16_t addr, uint8_t reg) {
-    uint8_t data;
+    uint8_t data = 0;
 
-    watch_i2c_send(addr, (uint8_t *)&reg, 1);
-    watch_i2c_receive(addr, (uint8_t *)&data, 1);
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 1);
 
     return data;
 }
 
 uint16_t watch_i2c_read16(int16_t addr, uint8_t reg) {
-    uint16_t data;
+    uint16_t data = 0;
 
-    watch_i2c_send(addr, (uint8_t *)&reg, 1);
-    watch_i2c_receive(addr, (uint8_t *)&data, 2);
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 2);
 
     return data;
 }
@@ -77,17 +220,15 @@ uint32_t watch_i2c_read24(int16_t addr, uint8_t reg) {
     uint32_t data;
     data = 0;
 
-    watch_i2c_send(addr, (uint8_t *)&reg, 1);
-    watch_i2c_receive(addr, (uint8_t *)&data, 3);
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 3);
 
     return data << 8;
 }
 
 uint32_t watch_i2c_read32(int16_t addr, uint8_t reg) {
-    uint32_t data;
+    uint32_t data = 0;
 
-    watch_i2c_send(addr, (uint8_t *)&reg, 1);
-    watch_i2c_receive(addr, (uint8_t *)&data, 4);
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 4);
 
     return data;
 }
@@ -26,25 +26,46 @@
 #include "watch_private_cdc.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "watch_utility.h"
 #include "tusb.h"
 
+// cdc_task runs from TC1's overflow interrupt: 7812.5 Hz / 21.
+#define CDC_TASKS_PER_SECOND  (372)
+// How long _write waits for a terminal that's stopped reading before it drops the rest: about 100 ms.
+#define CDC_WRITE_TIMEOUT_TASKS  (CDC_TASKS_PER_SECOND / 10)
+
+/*
+ * Writes go into one of two buffers while cdc_task hands the other one to TinyUSB, as much at a time as its FIFO
+ * will take. When the buffer being filled is full and the other one has been sent, they swap.
+ */
+
+// Size of each of the two write buffers.
+#define CDC_WRITE_BUF_SZ  (512)
+static char s_write_buf[2][CDC_WRITE_BUF_SZ] = {0};
+static size_t s_write_buf_len[2] = {0};
+// The buffer that _write fills; cdc_task sends the other.
+static uint8_t s_write_buf_filling = 0;
+// How much of the buffer being sent has been handed to TinyUSB so far.
+static size_t s_write_buf_sent = 0;
+
+// Counts cdc_task runs, and notes the last one that got anything out. If a write timed out, s_write_stalled stays
+// set until something goes out again, so that later writes drop straight away instead of waiting all over again.
+static volatile uint32_t s_task_count = 0;
+static volatile uint32_t s_last_sent_task = 0;
+static volatile bool s_write_stalled = false;
+
+static watch_cdc_stats_t s_stats = {0};
+static uint32_t s_bytes_this_second = 0;
+static uint16_t s_tasks_this_second = 0;
+
 /*
  * Implement a circular buffer for the USB CDC Serial read buffer.
  * The size of the buffer must be a power of two for this circular buffer
  * implementation to work.
  */
 
-// Size of the circular buffer. Must be a power of two.
-#define CDC_WRITE_BUF_SZ  (1024)
-// Macro function to perform modular arithmetic on an index.
-// eg. (63 + 2) & (64 - 1) -> 1
-#define CDC_WRITE_BUF_IDX(x)  ((x) & (CDC_WRITE_BUF_SZ - 1))
-static char s_write_buf[CDC_WRITE_BUF_SZ] = {0};
-static size_t s_write_buf_pos = 0;
-static size_t s_write_buf_len = 0;
-
 #define CDC_READ_BUF_SZ  (256)
 #define CDC_READ_BUF_IDX(x)  ((x) & (CDC_READ_BUF_SZ - 1))
 static char s_read_buf[CDC_READ_BUF_SZ] = {0};
@@ -69,21 +90,38 @@ int _write(int file, char *ptr, int len) {
     }
 
     int bytes_written = 0;
+    uint32_t progress_task = s_task_count;
+
+    while (bytes_written < len) {
+        prv_critical_section_enter();
+        size_t *buf_len = &s_write_buf_len[s_write_buf_filling];
+        size_t count = min((size_t)(len - bytes_written), CDC_WRITE_BUF_SZ - *buf_len);
+        memcpy(&s_write_buf[s_write_buf_filling][*buf_len], ptr + bytes_written, count);
+        *buf_len += count;
+        bytes_written += count;
+        prv_critical_section_exit();
 
-    prv_critical_section_enter();
-
-    for (int i = 0; i < len; i++) {
-        s_write_buf[s_write_buf_pos] = ptr[i];
-        s_write_buf_pos = CDC_WRITE_BUF_IDX(s_write_buf_pos + 1);
-        if (s_write_buf_len < CDC_WRITE_BUF_SZ) {
-            s_write_buf_len++;
+        if (bytes_written < len) {
+            // The buffer is full; cdc_task swaps in the other one once it's been sent. If there's a terminal on
+            // the other end, wait for that, so that a long dump goes out as fast as USB will take it. If there
+            // isn't, or if we're in an interrupt and cdc_task can't run, drop the rest, like a serial port with
+            // nothing plugged in. The same goes for a terminal that's open but hasn't read anything for a while:
+            // better to lose its output than to freeze the watch waiting for it.
+            if ((int32_t)(s_last_sent_task - progress_task) > 0) {
+                progress_task = s_last_sent_task;
+            }
+            if (s_task_count - progress_task > CDC_WRITE_TIMEOUT_TASKS) {
+                s_write_stalled = true;
+            }
+            if (!tud_cdc_connected() || __get_IPSR() != 0 || s_write_stalled) {
+                s_stats.bytes_dropped += len - bytes_written;
+                break;
+            }
+            __WFI();
         }
-        bytes_written++;
     }
 
-    prv_critical_section_exit();
-
-    return bytes_written;
+    return len;
 }
 
 int _read(int file, char *ptr, int len) {
@@ -133,28 +171,52 @@ static void prv_handle_reads(void) {
 }
 
 static void prv_handle_writes(void) {
-    if (s_write_buf_len > 0) {
-        const size_t start_pos =
-            CDC_WRITE_BUF_IDX(s_write_buf_pos - s_write_buf_len);
-        for (size_t i = 0; i < (size_t) s_write_buf_len; i++) {
-            const size_t idx = CDC_WRITE_BUF_IDX(start_pos + i);
-            if (tud_cdc_available() > 0) {
-                // If we receive data while doing a large write, we need to
-                // fully service it before continuing to write, or the
-                // stack will crash.
-                prv_handle_reads();
-            }
-            if (tud_cdc_write_available()) {
-                tud_cdc_write(&s_write_buf[idx], 1);
-            }
-            s_write_buf[idx] = 0;
-            s_write_buf_len--;
+    uint8_t sending = !s_write_buf_filling;
+
+    if (s_write_buf_sent == s_write_buf_len[sending]) {
+        // Done with this buffer. If there's anything in the other one, start sending that.
+        if (s_write_buf_len[s_write_buf_filling] == 0) {
+            return;
         }
-        tud_cdc_write_flush();
+        s_write_buf_len[sending] = 0;
+        s_write_buf_sent = 0;
+        s_write_buf_filling = sending;
+        sending = !sending;
+    }
+
+    uint32_t count = tud_cdc_write(&s_write_buf[sending][s_write_buf_sent],
+                                   s_write_buf_len[sending] - s_write_buf_sent);
+    if (count > 0) {
+        s_last_sent_task = s_task_count;
+        s_write_stalled = false;
+    }
+    s_write_buf_sent += count;
+    s_bytes_this_second += count;
+    s_stats.bytes_sent += count;
+    tud_cdc_write_flush();
+}
+
+static void prv_update_stats(void) {
+    if (++s_tasks_this_second < CDC_TASKS_PER_SECOND) {
+        return;
     }
+    s_stats.bytes_per_second = s_bytes_this_second;
+    if (s_bytes_this_second > s_stats.peak_bytes_per_second) {
+        s_stats.peak_bytes_per_second = s_bytes_this_second;
+    }
+    s_bytes_this_second = 0;
+    s_tasks_this_second = 0;
+}
+
+void watch_cdc_get_stats(watch_cdc_stats_t *stats) {
+    prv_critical_section_enter();
+    *stats = s_stats;
+    prv_critical_section_exit();
 }
 
 void cdc_task(void) {
+    s_task_count++;
     prv_handle_reads();
     prv_handle_writes();
+    prv_update_stats();
 }
@@ -112,8 +112,12 @@ void watch_rtc_disable_all_periodic_callbacks(void) {
 }
 
 void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time alarm_time, watch_rtc_alarm_match mask) {
+    // ALARM0 and MASK0 are write-synchronized; a write while the last one is still syncing gets dropped.
+    _sync_rtc();
     RTC->MODE2.Mode2Alarm[0].ALARM.reg = alarm_time.reg;
+    _sync_rtc();
     RTC->MODE2.Mode2Alarm[0].MASK.reg = mask;
+    _sync_rtc();
     RTC->MODE2.INTENSET.reg = RTC_MODE2_INTENSET_ALARM0;
     alarm_callback = callback;
     NVIC_ClearPendingIRQ(RTC_IRQn);
@@ -33,23 +33,42 @@ static void _sync_slcd(void) {
     while (SLCD->SYNCBUSY.reg);
 }
 
+// the display's segment registers (SDATAL0-2; our segments all fit in the low words), as drawn and as last written.
+static uint32_t _segments[3];
+static uint32_t _committed_segments[3];
+
 void watch_enable_display(void) {
     SEGMENT_LCD_0_init();
     slcd_sync_enable(&SEGMENT_LCD_0);
+    // initializing the SLCD clears its segment registers.
+    for (int i = 0; i < 3; i++) _segments[i] = _committed_segments[i] = 0;
 }
 
 inline void watch_set_pixel(uint8_t com, uint8_t seg) {
-    slcd_sync_seg_on(&SEGMENT_LCD_0, SLCD_SEGID(com, seg));
+    _segments[com] |= 1 << seg;
 }
 
 inline void watch_clear_pixel(uint8_t com, uint8_t seg) {
-    slcd_sync_seg_off(&SEGMENT_LCD_0, SLCD_SEGID(com, seg));
+    _segments[com] &= ~(1 << seg);
 }
 
 void watch_clear_display(void) {
-    SLCD->SDATAL0.reg = 0;
-    SLCD->SDATAL1.reg = 0;
-    SLCD->SDATAL2.reg = 0;
+    for (int i = 0; i < 3; i++) _segments[i] = 0;
+}
+
+void _watch_display_write_segments(const uint32_t mask[3], const uint32_t value[3]) {
+    _segments[0] = (_segments[0] & ~mask[0]) | value[0];
+    _segments[1] = (_segments[1] & ~mask[1]) | value[1];
+    _segments[2] = (_segments[2] & ~mask[2]) | value[2];
+}
+
+void watch_display_commit(void) {
+    // deep sleep and backup mode turn the SLCD off, and its registers can't be written without a clock.
+    if (!hri_mclk_get_APBCMASK_SLCD_bit(MCLK)) return;
+
+    if (_segments[0] != _committed_segments[0]) SLCD->SDATAL0.reg = _committed_segments[0] = _segments[0];
+    if (_segments[1] != _committed_segments[1]) SLCD->SDATAL1.reg = _committed_segments[1] = _segments[1];
+    if (_segments[2] != _committed_segments[2]) SLCD->SDATAL2.reg = _committed_segments[2] = _segments[2];
 }
 
 void watch_start_character_blink(char character, uint32_t duration) {
@@ -65,6 +84,7 @@ void watch_start_character_blink(char character, uint32_t duration) {
 
     watch_display_character(character, 7);
     watch_clear_pixel(2, 10); // clear segment B of position 7 since it can't blink
+    watch_display_commit();
 
     SLCD->CTRLD.bit.BLINK = 0;
     SLCD->CTRLA.bit.ENABLE = 0;
@@ -86,6 +106,7 @@ void watch_stop_blink(void) {
 
 void watch_start_tick_animation(uint32_t duration) {
     watch_display_character(' ', 8);
+    watch_display_commit();
     const uint32_t segs[] = { SLCD_SEGID(0, 2)};
     slcd_sync_start_animation(&SEGMENT_LCD_0, segs, 1, duration);
 }
@@ -98,4 +119,5 @@ void watch_stop_tick_animation(void) {
     const uint32_t segs[] = { SLCD_SEGID(0, 2)};
     slcd_sync_stop_animation(&SEGMENT_LCD_0, segs, 1);
     watch_display_character(' ', 8);
+    watch_display_commit();
 }
@@ -7,6 +7,15 @@
 #define RWWEE_ADDR_END (NVMCTRL_RWW_EEPROM_ADDR + NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
 #define NVM_MEMORY ((volatile uint16_t *)FLASH_ADDR)
 
+static ext_irq_cb_t storage_callback;
+
+// the NVM controller raises its READY interrupt once a command finishes. we only arm it when someone's waiting:
+// watch_storage_sync, or a completion callback.
+static void _watch_storage_arm_interrupt(void) {
+    NVIC_EnableIRQ(NVMCTRL_IRQn);
+    hri_nvmctrl_set_INTEN_READY_bit(NVMCTRL);
+}
+
 static bool _is_valid_address(uint32_t addr, uint32_t size) {
     if ((addr < NVMCTRL_RWW_EEPROM_ADDR) || (addr > (NVMCTRL_RWW_EEPROM_ADDR + NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES))) {
         return false;
@@ -68,6 +77,7 @@ bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, u
     }
     hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
     hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEWP | NVMCTRL_CTRLA_CMDEX_KEY);
+    if (storage_callback != NULL) _watch_storage_arm_interrupt();
 
     return true;
 }
@@ -79,16 +89,38 @@ bool watch_storage_erase(uint32_t row) {
     watch_storage_sync();
     hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
     hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEER | NVMCTRL_CTRLA_CMDEX_KEY);
+    if (storage_callback != NULL) _watch_storage_arm_interrupt();
 
     return true;
 }
 
 bool watch_storage_sync(void) {
-    while (!hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL)) {
-        // wait for flash to become ready
+    while (watch_storage_busy()) {
+        // a row erase takes milliseconds; sleep through it instead of spinning. interrupts are masked so that the
+        // READY interrupt can't slip in between the check and the sleep; it still wakes us, and runs once we unmask.
+        __disable_irq();
+        if (watch_storage_busy()) {
+            _watch_storage_arm_interrupt();
+            sleep(2);
+        }
+        __enable_irq();
     }
 
     hri_nvmctrl_clear_STATUS_reg(NVMCTRL, NVMCTRL_STATUS_MASK);
 
     return true;
 }
+
+bool watch_storage_busy(void) {
+    return !hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL);
+}
+
+void watch_storage_register_callback(ext_irq_cb_t callback) {
+    storage_callback = callback;
+}
+
+void NVMCTRL_Handler(void) {
+    // READY stays set until the next command, so disarm until then.
+    hri_nvmctrl_clear_INTEN_READY_bit(NVMCTRL);
+    if (storage_callback != NULL) storage_callback();
+}
@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// compares watch_display_string, which draws from the generated glyph table, with the character-by-character
+// substitutions and segment map decoding it replaced. first it checks that both draw exactly the same segments
+// for every character in every position, then it times a typical clock face redraw with each.
+// build and run it with `make HOST=1 COLOR=GREEN bench`.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "watch_slcd.h"
+#include "watch_private_display.h"
+
+#define ITERATIONS 1000000
+
+static uint32_t segments[3];
+
+void watch_set_pixel(uint8_t com, uint8_t seg) {
+    segments[com] |= 1ul << seg;
+}
+
+void watch_clear_pixel(uint8_t com, uint8_t seg) {
+    segments[com] &= ~(1ul << seg);
+}
+
+void _watch_display_write_segments(const uint32_t mask[3], const uint32_t value[3]) {
+    for (uint8_t com = 0; com < 3; com++) segments[com] = (segments[com] & ~mask[com]) | value[com];
+}
+
+// this is watch_display_character as it was before the glyph table.
+static void reference_display_character(uint8_t character, uint8_t position) {
+    // special cases for positions 4 and 6
+    if (position == 4 || position == 6) {
+        if (character == '7') character = '&'; // "lowercase" 7
+        else if (character == 'A') character = 'a'; // A needs to be lowercase
+        else if (character == 'o') character = 'O'; // O needs to be uppercase
+        else if (character == 'L') character = '!'; // L needs to be in top half
+        else if (character == 'M' || character == 'm' || character == 'N') character = 'n'; // M and uppercase N need to be lowercase n
+        else if (character == 'c') character = 'C'; // C needs to be uppercase
+        else if (character == 'J') character = 'j'; // same
+        else if (character == 't' || character == 'T') character = '+'; // t in those locations looks like E otherwise
+        else if (character == 'y' || character == 'Y') character = '4'; // y in those locations looks like g otherwise
+        else if (character == 'v' || character == 'V' || character == 'U' || character == 'W' || character == 'w') character = 'u'; // bottom segment duplicated, so show in top half
+    } else {
+        if (character == 'u') character = 'v'; // we can use the bottom segment; move to lower half
+        else if (character == 'j') character = 'J'; // same but just display a normal J
+    }
+    if (position > 1) {
+        if (character == 'T') character = 't'; // uppercase T only works in positions 0 and 1
+    }
+    if (position == 1) {
+        if (character == 'a') character = 'A'; // A needs to be uppercase
+        else if (character == 'o') character = 'O'; // O needs to be uppercase
+        else if (character == 'i') character = 'l'; // I needs to be uppercase (use an l, it looks the same)
+        else if (character == 'n') character = 'N'; // N needs to be uppercase
+        else if (character == 'r') character = 'R'; // R needs to be uppercase
+        else if (character == 'd') character = 'D'; // D needs to be uppercase
+        else if (character == 'v' || character == 'V' || character == 'u') character = 'U'; // side segments shared, make uppercase
+        else if (character == 'b') character = 'B'; // B needs to be uppercase
+        else if (character == 'c') character = 'C'; // C needs to be uppercase
+    } else {
+        if (character == 'R') character = 'r'; // R needs to be lowercase almost everywhere
+    }
+    if (position == 0) {
+        watch_clear_pixel(0, 15); // clear funky ninth segment
+    } else {
+        if (character == 'I') character = 'l'; // uppercase I only works in position 0
+    }
+
+    uint64_t segmap = Segment_Map[position];
+    uint64_t segdata = Character_Set[character - 0x20];
+
+    for (int i = 0; i < 8; i++) {
+        uint8_t com = (segmap & 0xFF) >> 6;
+        if (com > 2) {
+            // COM3 means no segment exists; skip it.
+            segmap = segmap >> 8;
+            segdata = segdata >> 1;
+            continue;
+        }
+        uint8_t seg = segmap & 0x3F;
+
+        if (segdata & 1)
+          watch_set_pixel(com, seg);
+        else
+          watch_clear_pixel(com, seg);
+
+        segmap = segmap >> 8;
+        segdata = segdata >> 1;
+    }
+
+    if (character == 'T' && position == 1) watch_set_pixel(1, 12); // add descender
+    else if (position == 0 && (character == 'B' || character == 'D' || character == '@')) watch_set_pixel(0, 15); // add funky ninth segment
+    else if (position == 1 && (character == 'B' || character == 'D' || character == '@')) watch_set_pixel(0, 12); // add funky ninth segment
+}
+
+static void reference_display_string(char *string, uint8_t position) {
+    size_t i = 0;
+    while(string[i] != 0) {
+        reference_display_character(string[i], position + i);
+        i++;
+        if (position + i >= Num_Chars) break;
+    }
+}
+
+static bool check_glyphs(void) {
+    bool ok = true;
+
+    for (uint8_t position = 0; position < Num_Chars; position++) {
+        for (uint8_t character = 0x20; character < 0x7F; character++) {
+            // start from opposite backgrounds, so a segment that one of them forgets to write shows up.
+            uint32_t expected[3], actual[3];
+            for (uint8_t background = 0; background < 2; background++) {
+                memset(segments, background ? 0xFF : 0x00, sizeof(segments));
+                reference_display_character(character, position);
+                memcpy(expected, segments, sizeof(segments));
+                memset(segments, background ? 0xFF : 0x00, sizeof(segments));
+                watch_display_character(character, position);
+                memcpy(actual, segments, sizeof(segments));
+                if (memcmp(expected, actual, sizeof(segments))) {
+                    printf("mismatch: '%c' in position %d\n", character, position);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    return ok;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void bench(const char *name, void (*display_string)(char *, uint8_t), char strings[][11], size_t num_strings) {
+    double start_ns = now_ns();
+    uint64_t start_cycles = now_cycles();
+
+    for (uint32_t i = 0; i < ITERATIONS; i++) display_string(strings[i % num_strings], 0);
+
+    uint64_t cycles = now_cycles() - start_cycles;
+    double ns = now_ns() - start_ns;
+    printf("%-13s %7.1f ns/call", name, ns / ITERATIONS);
+    if (cycles) printf(" %7.1f cycles/call", (double)cycles / ITERATIONS);
+    printf("\n");
+}
+
+int main(void) {
+    // a minute's worth of clock face redraws.
+    char strings[60][11];
+    for (uint8_t second = 0; second < 60; second++) sprintf(strings[second], "TU171013%02d", second);
+
+    if (!check_glyphs()) return 1;
+    printf("glyph table matches the reference for all %d positions\n", Num_Chars);
+
+    bench("reference", reference_display_string, strings, 60);
+    bench("glyph table", watch_display_string, strings, 60);
+
+    // keep the compiler from deciding the drawing was pointless.
+    return segments[0] == 0x12345678;
+}
@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// compares converting accelerometer readings to milli-g in fixed point, as lis2dw_readings_to_milli_g does, with
+// the floating point conversion lis2dw_get_acceleration_measurement used to do. first it checks that the fixed point
+// conversion is within a milli-g of the exact answer for every reading at every range, then it times each on
+// a FIFO's worth of samples. the watch has no FPU, so the difference there is much bigger than it is here.
+// build and run it with `make HOST=1 COLOR=GREEN bench`.
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "lis2dw.h"
+
+#define ITERATIONS 100000
+#define FIFO_SIZE 32
+
+static lis2dw_reading_t readings[FIFO_SIZE];
+static lis2dw_milli_g_t milli_g[FIFO_SIZE];
+static lis2dw_acceleration_measurement_t measurements[FIFO_SIZE];
+
+// this is the conversion in lis2dw_get_acceleration_measurement as it was, with its own scale factors. it lived in
+// the driver, so keep it out of line here too, where it pays for a call like lis2dw_reading_to_milli_g does.
+__attribute__((noinline)) static lis2dw_acceleration_measurement_t reference_convert(lis2dw_reading_t reading, lis2dw_range_t range) {
+    uint8_t lsb_value = 1;
+    if (range == LIS2DW_RANGE_2_G) lsb_value = 4;
+    if (range == LIS2DW_RANGE_4_G) lsb_value = 8;
+    if (range == LIS2DW_RANGE_8_G) lsb_value = 16;
+    if (range == LIS2DW_RANGE_16_G) lsb_value = 48;
+
+    lis2dw_acceleration_measurement_t retval;
+
+    retval.x = lsb_value * ((float)reading.x / 64000.0);
+    retval.y = lsb_value * ((float)reading.y / 64000.0);
+    retval.z = lsb_value * ((float)reading.z / 64000.0);
+
+    return retval;
+}
+
+static bool check_conversion(void) {
+    // the data sheet's sensitivity at ±2g, in milli-g per LSB of the left-justified reading; it doubles with each range.
+    const double sensitivity = 0.061;
+    double worst = 0;
+
+    for (uint8_t range = LIS2DW_RANGE_2_G; range <= LIS2DW_RANGE_16_G; range++) {
+        for (int32_t value = INT16_MIN; value <= INT16_MAX; value++) {
+            lis2dw_reading_t reading = { value, value, value };
+            lis2dw_milli_g_t result = lis2dw_reading_to_milli_g(reading, range);
+            double exact = value * sensitivity * (1 << range);
+            double error = fabs(result.x - exact);
+            if (error > worst) worst = error;
+            if (error >= 1 || result.y != result.x || result.z != result.x) {
+                printf("mismatch: %d at range %d is %d mg, not %.2f\n", value, range, result.x, exact);
+                return false;
+            }
+        }
+    }
+    printf("fixed point is within %.3f mg of the data sheet at every range\n", worst);
+
+    return true;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void report(const char *name, double start_ns, uint64_t start_cycles) {
+    uint64_t cycles = now_cycles() - start_cycles;
+    double ns = now_ns() - start_ns;
+    printf("%-15s %6.2f ns/sample", name, ns / ITERATIONS / FIFO_SIZE);
+    if (cycles) printf(" %6.2f cycles/sample", (double)cycles / ITERATIONS / FIFO_SIZE);
+    printf("\n");
+}
+
+int main(void) {
+    if (!check_conversion()) return 1;
+
+    // a wrist's worth of samples at ±4g, in a FIFO's worth.
+    for (uint8_t i = 0; i < FIFO_SIZE; i++) {
+        readings[i] = (lis2dw_reading_t) { 1000 * i - 16000, 8000 - 500 * i, 250 * i + 4000 };
+    }
+
+    double start_ns = now_ns();
+    uint64_t start_cycles = now_cycles();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        // the range comes from a volatile read, so the compiler can't hoist the work out of the loop.
+        volatile lis2dw_range_t range = LIS2DW_RANGE_4_G;
+        for (uint8_t j = 0; j < FIFO_SIZE; j++) measurements[j] = reference_convert(readings[j], range);
+    }
+    report("float", start_ns, start_cycles);
+
+    start_ns = now_ns();
+    start_cycles = now_cycles();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        volatile lis2dw_range_t range = LIS2DW_RANGE_4_G;
+        for (uint8_t j = 0; j < FIFO_SIZE; j++) milli_g[j] = lis2dw_reading_to_milli_g(readings[j], range);
+    }
+    report("fixed", start_ns, start_cycles);
+
+    start_ns = now_ns();
+    start_cycles = now_cycles();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        volatile lis2dw_range_t range = LIS2DW_RANGE_4_G;
+        lis2dw_readings_to_milli_g(readings, milli_g, FIFO_SIZE, range);
+    }
+    report("fixed, in bulk", start_ns, start_cycles);
+
+    // keep the compiler from deciding the conversions were pointless.
+    return measurements[FIFO_SIZE - 1].x == 1234.5f && milli_g[FIFO_SIZE - 1].x == 12345;
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "watch.h"
+#include "watch_main_loop.h"
+#include "watch_utility.h"
+
+// Usage: watch [-t unix_time] [-s seconds] [-u] [script]
+//
+// Runs Movement on a virtual clock, as fast as the host can go. With -u, the watch is plugged in to USB, and
+// standard input goes to the shell. The script (or standard input, if there's no script or duration and the watch
+// isn't plugged in) is a list of commands, one per line, run in virtual time:
+//
+//   wait <seconds>                    let the watch run
+//   press <mode|light|alarm> [secs]   press a button and hold it (default 0.1 seconds)
+//   down <button>, up <button>        press or release a button
+//   lcd                               print the display
+//   quit                              stop here
+//
+// Lines starting with # are ignored. A summary goes to stderr at the end of the run.
+
+#define MAIN_LOOP_DEFAULT_PRESS_TICKS (MAIN_LOOP_TICKS_PER_SECOND / 10)
+
+static FILE *script;
+static uint8_t held_pin;
+static bool holding;
+
+static uint32_t app_loops;
+static struct timespec started;
+
+static void _main_loop_finish(void *user_data) {
+    (void) user_data;
+    struct timespec finished;
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double elapsed = (finished.tv_sec - started.tv_sec) + (finished.tv_nsec - started.tv_nsec) / 1e9;
+    double simulated = (double)main_loop_get_ticks() / MAIN_LOOP_TICKS_PER_SECOND;
+
+    fflush(stdout);
+    fprintf(stderr, "%.0f seconds simulated in %.3f seconds (%.0fx); %u wakeups, %u calls to app_loop\n",
+            simulated, elapsed, elapsed > 0 ? simulated / elapsed : 0, main_loop_get_wakeups(), app_loops);
+    exit(0);
+}
+
+static bool _main_loop_parse_button(const char *name, uint8_t *pin) {
+    if (name == NULL) return false;
+    if (strcmp(name, "mode") == 0) *pin = BTN_MODE;
+    else if (strcmp(name, "light") == 0) *pin = BTN_LIGHT;
+    else if (strcmp(name, "alarm") == 0) *pin = BTN_ALARM;
+    else return false;
+    return true;
+}
+
+static void _main_loop_run_script(void *user_data) {
+    (void) user_data;
+    char line[128];
+    uint64_t wait = 0;
+    bool yield = false;
+
+    if (holding) {
+        holding = false;
+        watch_host_set_button(held_pin, false);
+        // give the watch a chance to see the release before going on.
+        main_loop_set_timer(_main_loop_run_script, NULL, main_loop_get_ticks(), 0);
+        return;
+    }
+
+    // run commands until one of them takes time or touches a button, then come back when the watch has caught up.
+    while (wait == 0 && !yield) {
+        if (fgets(line, sizeof(line), script) == NULL) {
+            _main_loop_finish(NULL);
+        }
+
+        char *command = strtok(line, " \t\r\n");
+        char *argument = strtok(NULL, " \t\r\n");
+        char *duration = strtok(NULL, " \t\r\n");
+        uint8_t pin;
+
+        if (command == NULL || command[0] == '#') continue;
+
+        if (strcmp(command, "wait") == 0 && argument != NULL) {
+            wait = atof(argument) * MAIN_LOOP_TICKS_PER_SECOND;
+        } else if (strcmp(command, "press") == 0 && _main_loop_parse_button(argument, &pin)) {
+            wait = duration ? atof(duration) * MAIN_LOOP_TICKS_PER_SECOND : MAIN_LOOP_DEFAULT_PRESS_TICKS;
+            held_pin = pin;
+            holding = true;
+            watch_host_set_button(pin, true);
+        } else if (strcmp(command, "down") == 0 && _main_loop_parse_button(argument, &pin)) {
+            watch_host_set_button(pin, true);
+            yield = true;
+        } else if (strcmp(command, "up") == 0 && _main_loop_parse_button(argument, &pin)) {
+            watch_host_set_button(pin, false);
+            yield = true;
+        } else if (strcmp(command, "lcd") == 0) {
+            watch_host_print_display(stdout);
+        } else if (strcmp(command, "quit") == 0) {
+            _main_loop_finish(NULL);
+        } else {
+            fprintf(stderr, "unknown command: %s\n", command);
+            exit(1);
+        }
+    }
+
+    main_loop_set_timer(_main_loop_run_script, NULL, main_loop_get_ticks() + wait, 0);
+}
+
+int main(int argc, char **argv) {
+    int64_t start_time = -1;
+    double duration = -1;
+    const char *script_path = NULL;
+    bool usb_enabled = false;
+
+    // unistd.h clashes with the watch library's read() and sleep(), so no getopt here.
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            start_time = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-u") == 0) {
+            usb_enabled = true;
+        } else if (script_path == NULL && (argv[i][0] != '-' || argv[i][1] == 0)) {
+            script_path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-t unix_time] [-s seconds] [-u] [script]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (script_path != NULL && strcmp(script_path, "-") != 0) {
+        script = fopen(script_path, "r");
+        if (script == NULL) {
+            perror(script_path);
+            return 1;
+        }
+    } else if (script_path != NULL || (duration < 0 && !usb_enabled)) {
+        script = stdin;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    if (usb_enabled) {
+        _watch_enable_usb();
+        // the shell is on standard output; send each line as it's printed, for programs talking to it over a pipe.
+        setvbuf(stdout, NULL, _IOLBF, 0);
+    }
+
+    app_init();
+    _watch_init();
+
+    if (start_time >= 0) {
+        watch_rtc_set_date_time(watch_utility_date_time_from_unix_time(start_time, 0));
+    }
+
+    app_setup();
+
+    if (script) main_loop_set_timer(_main_loop_run_script, NULL, 0, 0);
+    if (duration >= 0) main_loop_set_timer(_main_loop_finish, NULL, duration * MAIN_LOOP_TICKS_PER_SECOND, 0);
+
+    while (1) {
+        bool can_sleep = app_loop();
+        watch_display_commit();
+        app_loops++;
+        if (can_sleep && !usb_enabled) {
+            app_prepare_for_standby();
+            main_loop_wait_for_interrupt();
+            app_wake_from_standby();
+        } else {
+            // the watch is busy; let a little time pass before the next go around the loop.
+            main_loop_advance(1);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch.h"
+
+// the virtual clock and its timers. main.c drives them; they live on their own so that benchmarks can link
+// against the parts of the watch library that use them without pulling in main().
+
+#define MAIN_LOOP_MAX_TIMERS 16
+
+typedef struct {
+    uint64_t deadline;
+    uint32_t period;
+    main_loop_timer_cb_t callback;
+    void *user_data;
+    bool active;
+} main_loop_timer_t;
+
+static main_loop_timer_t timers[MAIN_LOOP_MAX_TIMERS];
+static uint64_t now;
+static bool interrupted;
+static uint32_t wakeups;
+
+static int8_t _main_loop_next_timer(void) {
+    int8_t next = -1;
+    for (int8_t i = 0; i < MAIN_LOOP_MAX_TIMERS; i++) {
+        if (!timers[i].active) continue;
+        if (next < 0 || timers[i].deadline < timers[next].deadline) next = i;
+    }
+    return next;
+}
+
+static void _main_loop_fire_timer(int8_t timer_id) {
+    main_loop_timer_t *timer = &timers[timer_id];
+    if (timer->deadline > now) now = timer->deadline;
+    if (timer->period) timer->deadline += timer->period;
+    else timer->active = false;
+    timer->callback(timer->user_data);
+}
+
+uint64_t main_loop_get_ticks(void) {
+    return now;
+}
+
+int8_t main_loop_set_timer(main_loop_timer_cb_t callback, void *user_data, uint64_t deadline, uint32_t period) {
+    for (int8_t i = 0; i < MAIN_LOOP_MAX_TIMERS; i++) {
+        if (timers[i].active) continue;
+        timers[i] = (main_loop_timer_t) { deadline, period, callback, user_data, true };
+        return i;
+    }
+    return -1;
+}
+
+void main_loop_clear_timer(int8_t timer_id) {
+    if (timer_id < 0) return;
+    timers[timer_id].active = false;
+}
+
+void main_loop_advance(uint64_t ticks) {
+    uint64_t until = now + ticks;
+    int8_t timer_id;
+    while ((timer_id = _main_loop_next_timer()) >= 0 && timers[timer_id].deadline <= until) {
+        _main_loop_fire_timer(timer_id);
+    }
+    now = until;
+}
+
+void main_loop_wait_for_interrupt(void) {
+    wakeups++;
+    interrupted = false;
+    while (!interrupted) {
+        // the end of the run is always scheduled, so there is always something to wait for.
+        _main_loop_fire_timer(_main_loop_next_timer());
+    }
+}
+
+uint32_t main_loop_get_wakeups(void) {
+    return wakeups;
+}
+
+void resume_main_loop(void) {
+    interrupted = true;
+}
+
+void delay_ms(const uint16_t ms) {
+    main_loop_advance((uint64_t)ms * MAIN_LOOP_TICKS_PER_SECOND / 1000);
+}
+
+void delay_us(const uint16_t us) {
+    main_loop_advance((uint64_t)us * MAIN_LOOP_TICKS_PER_SECOND / 1000000);
+}
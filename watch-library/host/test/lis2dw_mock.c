@@ -0,0 +1,151 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <string.h>
+#include "lis2dw.h"
+#include "lis2dw_mock.h"
+#include "watch_i2c.h"
+
+uint32_t lis2dw_mock_transactions;
+
+static uint8_t registers[0x40];
+static uint8_t address;
+static int16_t fifo[32][3];
+static uint8_t fifo_count;
+static bool fifo_overrun;
+
+void lis2dw_mock_add_samples(uint8_t count, int16_t first) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (fifo_count == 32) {
+            memmove(fifo[0], fifo[1], sizeof(fifo) - sizeof(fifo[0]));
+            fifo_count--;
+            fifo_overrun = true;
+        }
+        fifo[fifo_count][0] = first + i;
+        fifo[fifo_count][1] = -(first + i);
+        fifo[fifo_count][2] = 1000 + first + i;
+        fifo_count++;
+    }
+}
+
+bool lis2dw_mock_check_samples(const void *readings, uint8_t count, int16_t first) {
+    const lis2dw_reading_t *reading = (const lis2dw_reading_t *)readings;
+    for (uint8_t i = 0; i < count; i++) {
+        if (reading[i].x != first + i || reading[i].y != -(first + i) || reading[i].z != 1000 + first + i) return false;
+    }
+    return true;
+}
+
+uint8_t lis2dw_mock_fifo_count(void) {
+    return fifo_count;
+}
+
+void lis2dw_mock_set_overrun(bool overrun) {
+    fifo_overrun = overrun;
+}
+
+uint8_t lis2dw_mock_register(uint8_t reg) {
+    return registers[reg];
+}
+
+bool lis2dw_mock_int1(void) {
+    uint8_t threshold = registers[LIS2DW_REG_FIFO_CTRL] & LIS2DW_FIFO_CTRL_FTH;
+    return (registers[LIS2DW_REG_CTRL4_INT1] & LIS2DW_CTRL4_INT1_FTH) && threshold && fifo_count >= threshold;
+}
+
+static void _pop_fifo(void) {
+    if (fifo_count == 0) return;
+    // reading a sample makes room, so the overrun flag goes.
+    fifo_overrun = false;
+    memmove(fifo[0], fifo[1], sizeof(fifo) - sizeof(fifo[0]));
+    fifo_count--;
+}
+
+static void _lis2dw_mock_write(const uint8_t *buf, uint16_t length) {
+    // the first byte is the register address; the high bit asks for auto-increment, which is always on here.
+    address = buf[0] & 0x7F;
+    for (uint16_t i = 1; i < length; i++) {
+        // turning the FIFO off empties it.
+        if (address == LIS2DW_REG_FIFO_CTRL && (buf[i] >> 5) == LIS2DW_FIFO_MODE_OFF) {
+            fifo_count = 0;
+            fifo_overrun = false;
+        }
+        // a soft reset puts the control registers back the way they were at power-on, and both it and a boot
+        // clear themselves when they're done.
+        if (address == LIS2DW_REG_CTRL2 && (buf[i] & LIS2DW_CTRL2_VAL_SOFT_RESET)) {
+            memset(registers + LIS2DW_REG_CTRL1, 0, LIS2DW_REG_CTRL7 - LIS2DW_REG_CTRL1 + 1);
+            fifo_count = 0;
+            fifo_overrun = false;
+            address++;
+            continue;
+        }
+        if (address == LIS2DW_REG_CTRL2) {
+            registers[address++] = buf[i] & ~LIS2DW_CTRL2_VAL_BOOT;
+            continue;
+        }
+        registers[address++] = buf[i];
+    }
+}
+
+static void _lis2dw_mock_read(uint8_t *buf, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        if (address >= LIS2DW_REG_OUT_X_L && address <= LIS2DW_REG_OUT_X_L + 5) {
+            uint8_t byte = address - LIS2DW_REG_OUT_X_L;
+            buf[i] = (uint16_t)fifo[0][byte / 2] >> (8 * (byte % 2));
+            // like the real thing with its FIFO on: after OUT_Z_H, the next sample, back at OUT_X_L.
+            if (byte == 5) {
+                _pop_fifo();
+                address = LIS2DW_REG_OUT_X_L;
+                continue;
+            }
+        } else if (address == LIS2DW_REG_FIFO_SAMPLE) {
+            uint8_t threshold = registers[LIS2DW_REG_FIFO_CTRL] & LIS2DW_FIFO_CTRL_FTH;
+            buf[i] = fifo_count | (fifo_overrun ? LIS2DW_FIFO_SAMPLE_OVERRUN : 0);
+            if (threshold && fifo_count >= threshold) buf[i] |= LIS2DW_FIFO_SAMPLE_THRESHOLD;
+        } else {
+            buf[i] = registers[address];
+        }
+        address++;
+    }
+}
+
+static bool _lis2dw_mock_transfer(const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length) {
+    lis2dw_mock_transactions++;
+    if (write_length) _lis2dw_mock_write(write_buf, write_length);
+    if (read_length) _lis2dw_mock_read(read_buf, read_length);
+    return true;
+}
+
+void lis2dw_mock_reset(void) {
+    memset(registers, 0, sizeof(registers));
+    registers[LIS2DW_REG_WHO_AM_I] = LIS2DW_WHO_AM_I_VAL;
+    address = 0;
+    fifo_count = 0;
+    fifo_overrun = false;
+    lis2dw_mock_transactions = 0;
+
+    static const watch_host_i2c_device_t device = { LIS2DW_ADDRESS, _lis2dw_mock_transfer };
+    watch_host_i2c_attach(&device);
+}
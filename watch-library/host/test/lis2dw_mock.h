@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIS2DW_MOCK_H_
+#define LIS2DW_MOCK_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+// a pretend LIS2DW, for testing the driver and what's built on it on the host. it sits on the host's pretend I2C
+// bus (see watch_main_loop.h), which times the traffic; it keeps its registers, a FIFO that the test fills by
+// hand, and a count of the transactions addressed to it.
+
+extern uint32_t lis2dw_mock_transactions;
+
+// back to power-on: registers cleared, an empty FIFO, no transactions. this also puts it on the bus.
+void lis2dw_mock_reset(void);
+
+// adds count samples to the FIFO, numbered from first: x is the number, y its negative and z 1000 more. in
+// continuous mode, a full FIFO drops its oldest sample and notes an overrun, like the real thing.
+void lis2dw_mock_add_samples(uint8_t count, int16_t first);
+
+// checks that readings hold count samples numbered from first, as lis2dw_mock_add_samples made them.
+bool lis2dw_mock_check_samples(const void *readings, uint8_t count, int16_t first);
+
+uint8_t lis2dw_mock_fifo_count(void);
+void lis2dw_mock_set_overrun(bool overrun);
+uint8_t lis2dw_mock_register(uint8_t reg);
+
+// the level of INT1: high while the FIFO threshold interrupt is routed there and the FIFO has reached it.
+bool lis2dw_mock_int1(void);
+
+#endif // LIS2DW_MOCK_H_
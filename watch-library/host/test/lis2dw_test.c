@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks lis2dw_read_fifo against a mock LIS2DW on the host's pretend I2C bus (see lis2dw_mock.h), and counts the
+// bus transactions: reading a full FIFO should take one burst, not an address phase and a read for every sample.
+// build and run it with `make HOST=1 COLOR=GREEN test`.
+
+#include <stdio.h>
+#include "lis2dw.h"
+#include "lis2dw_mock.h"
+#include "watch.h"
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        return 1; \
+    } \
+} while (0)
+
+int main(void) {
+    lis2dw_fifo_t fifo_data;
+    lis2dw_reading_t readings[32];
+    bool overrun;
+
+    watch_enable_i2c();
+
+    // a nearly full FIFO: one read for the count, and one burst for the samples, each a write of the register
+    // address and a read after a repeated start.
+    lis2dw_mock_reset();
+    lis2dw_mock_add_samples(25, 1);
+    watch_host_get_i2c_stats(true);
+    CHECK(!lis2dw_read_fifo(&fifo_data));
+    CHECK(fifo_data.count == 25);
+    CHECK(lis2dw_mock_check_samples(fifo_data.readings, 25, 1));
+    CHECK(lis2dw_mock_fifo_count() == 0);
+    CHECK(lis2dw_mock_transactions == 2);
+    watch_host_i2c_stats_t stats = watch_host_get_i2c_stats(true);
+    CHECK(stats.bytes == 1 + 1 + 1 + 25 * 6);
+    // each byte is 9 bits at 10 µs, plus the addresses, starts and stops.
+    CHECK(stats.bus_us == 10 * (2 * (1 + 9 + 1 + 9 + 1) + 9 * stats.bytes));
+    printf("25 samples in %lu transactions, %lu µs on the bus (%d transactions a sample at a time)\n",
+           (unsigned long)lis2dw_mock_transactions, (unsigned long)stats.bus_us, 2 + 2 * 25);
+
+    // a full one that overran.
+    lis2dw_mock_add_samples(32, -300);
+    lis2dw_mock_set_overrun(true);
+    CHECK(lis2dw_read_fifo(&fifo_data));
+    CHECK(fifo_data.count == 32);
+    CHECK(lis2dw_mock_check_samples(fifo_data.readings, 32, -300));
+
+    // an empty one doesn't bother with the burst.
+    lis2dw_mock_transactions = 0;
+    CHECK(!lis2dw_read_fifo(&fifo_data));
+    CHECK(fifo_data.count == 0);
+    CHECK(lis2dw_mock_transactions == 1);
+
+    // reading fewer than are waiting leaves the rest, in order, for next time.
+    lis2dw_mock_add_samples(20, 7);
+    CHECK(lis2dw_read_fifo_burst(readings, 8, &overrun) == 8);
+    CHECK(!overrun);
+    CHECK(lis2dw_mock_check_samples(readings, 8, 7));
+    CHECK(lis2dw_mock_fifo_count() == 12);
+    CHECK(lis2dw_read_fifo_burst(readings, 32, NULL) == 12);
+    CHECK(lis2dw_mock_check_samples(readings, 12, 15));
+
+    // after a reset, the driver has its own copy of the control registers, so asking costs nothing...
+    lis2dw_mock_reset();
+    CHECK(lis2dw_begin());
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL2) == (LIS2DW_CTRL2_VAL_BDU | LIS2DW_CTRL2_VAL_IF_ADD_INC));
+    lis2dw_mock_transactions = 0;
+    CHECK(lis2dw_get_range() == LIS2DW_RANGE_2_G);
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_POWERDOWN);
+    lis2dw_get_acceleration_measurement(NULL);
+    CHECK(lis2dw_mock_transactions == 1);
+
+    // ...changing something is one write, and changing it to what it already was is none.
+    lis2dw_mock_transactions = 0;
+    lis2dw_set_range(LIS2DW_RANGE_8_G);
+    CHECK(lis2dw_mock_transactions == 1);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL6) == LIS2DW_CTRL6_VAL_RANGE_8G);
+    lis2dw_set_range(LIS2DW_RANGE_8_G);
+    CHECK(lis2dw_mock_transactions == 1);
+    CHECK(lis2dw_get_range() == LIS2DW_RANGE_8_G);
+    lis2dw_set_low_noise_mode(true);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL6) == (LIS2DW_CTRL6_VAL_RANGE_8G | LIS2DW_CTRL6_VAL_LOW_NOISE));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL1) == 0);
+
+    // a whole configuration goes out in one write, leaving the registers in between as they were.
+    lis2dw_config_t config = {
+        .data_rate = LIS2DW_DATA_RATE_25_HZ,
+        .mode = LIS2DW_MODE_LOW_POWER,
+        .low_power_mode = LIS2DW_LP_MODE_2,
+        .range = LIS2DW_RANGE_4_G,
+        .bandwidth = LIS2DW_BANDWIDTH_FILTER_DIV4,
+        .filter = LIS2DW_FILTER_LOW_PASS,
+        .low_noise = true,
+    };
+    lis2dw_mock_transactions = 0;
+    lis2dw_apply_config(&config);
+    CHECK(lis2dw_mock_transactions == 1);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL1) == (LIS2DW_CTRL1_VAL_ODR_25HZ | LIS2DW_CTRL1_VAL_MODE_LOW_POWER | LIS2DW_CTRL1_VAL_LPMODE_2));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL2) == (LIS2DW_CTRL2_VAL_BDU | LIS2DW_CTRL2_VAL_IF_ADD_INC));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL6) == (LIS2DW_CTRL6_VAL_BANDWIDTH_DIV4 | LIS2DW_CTRL6_VAL_RANGE_4G | LIS2DW_CTRL6_VAL_LOW_NOISE));
+    lis2dw_apply_config(&config);
+    CHECK(lis2dw_mock_transactions == 1);
+    config.data_rate = LIS2DW_DATA_RATE_50_HZ;
+    lis2dw_apply_config(&config);
+    CHECK(lis2dw_mock_transactions == 2);
+    CHECK(lis2dw_get_data_rate() == LIS2DW_DATA_RATE_50_HZ);
+    CHECK(lis2dw_get_low_power_mode() == LIS2DW_LP_MODE_2);
+    CHECK(lis2dw_get_bandwidth_filtering() == LIS2DW_BANDWIDTH_FILTER_DIV4);
+
+    // milli-g come from the range it already knows about, so a measurement is one transaction.
+    lis2dw_mock_add_samples(1, 1000);
+    lis2dw_mock_transactions = 0;
+    lis2dw_milli_g_t milli_g = lis2dw_get_milli_g(NULL);
+    CHECK(lis2dw_mock_transactions == 1);
+    CHECK(milli_g.x == 122 && milli_g.y == -122 && milli_g.z == 244);
+
+    // the wakeup interrupt: the duration and threshold together, CTRL3 and CTRL4 together, and CTRL7.
+    lis2dw_mock_transactions = 0;
+    lis2dw_configure_wakeup_int1(10, true, false);
+    CHECK(lis2dw_mock_transactions == 3);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_WAKE_UP_THS) == (10 | LIS2DW_WAKE_UP_THS_VAL_SLEEP_ON));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL3) == (LIS2DW_CTRL3_VAL_LIR | LIS2DW_CTRL3_VAL_H_L_ACTIVE));
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL4_INT1) == LIS2DW_CTRL4_INT1_WU);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL7) == LIS2DW_CTRL7_VAL_INTERRUPTS_ENABLE);
+    lis2dw_configure_wakeup_int1(10, false, true);
+    CHECK(lis2dw_mock_register(LIS2DW_REG_CTRL3) == 0);
+
+    printf("lis2dw passed\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// checks the host's I2C bus: that transactions queue up and finish in order, call back when they're done and time
+// the bus the way the watch's would, and that a missing device or a disabled bus fails the way it should.
+// build and run it with `make HOST=1 COLOR=GREEN test`.
+
+#include <stdio.h>
+#include <string.h>
+#include "watch.h"
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        return 1; \
+    } \
+} while (0)
+
+#define DEVICE_ADDRESS 0x20
+#define MISSING_ADDRESS 0x21
+
+// a device with a few registers that auto-increment, the way most of them do.
+static uint8_t registers[16];
+
+static bool _device_transfer(const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length) {
+    static uint8_t address;
+    if (write_length) address = write_buf[0];
+    for (uint16_t i = 1; i < write_length; i++) registers[address++ % 16] = write_buf[i];
+    for (uint16_t i = 0; i < read_length; i++) read_buf[i] = registers[address++ % 16];
+    return true;
+}
+
+static watch_i2c_transaction_t *finished[8];
+static uint8_t num_finished;
+static uint64_t finished_at[8];
+
+static void _record(watch_i2c_transaction_t *transaction) {
+    finished_at[num_finished] = main_loop_get_ticks();
+    finished[num_finished++] = transaction;
+}
+
+// a callback that queues the next transaction as soon as this one's done, as a driver reading in a chain would.
+static void _chain(watch_i2c_transaction_t *transaction) {
+    _record(transaction);
+    if (transaction->user_data != NULL) watch_i2c_submit((watch_i2c_transaction_t *)transaction->user_data);
+}
+
+int main(void) {
+    static const watch_host_i2c_device_t device = { DEVICE_ADDRESS, _device_transfer };
+    uint8_t write[3] = { 4, 0xAB, 0xCD };
+    uint8_t reg = 4;
+    uint8_t read[2] = {0};
+    watch_host_i2c_stats_t stats;
+
+    watch_host_i2c_attach(&device);
+
+    // with the bus off, nothing goes anywhere, and it says so right away.
+    watch_i2c_transaction_t off = { .addr = DEVICE_ADDRESS, .write_buf = write, .write_length = 3, .callback = _record };
+    watch_i2c_submit(&off);
+    CHECK(off.status == WATCH_I2C_ERROR);
+    CHECK(num_finished == 1);
+    CHECK(!watch_i2c_busy());
+
+    // a write, then a register read in one transaction: 3 bytes at 9 bits each plus a start, the address and a
+    // stop; then a start, the address, the register, a repeated start, the address again, 2 bytes and a stop.
+    watch_enable_i2c();
+    watch_host_get_i2c_stats(true);
+    CHECK(watch_i2c_write_read(DEVICE_ADDRESS, write, 3, NULL, 0));
+    CHECK(watch_i2c_write_read(DEVICE_ADDRESS, &reg, 1, read, 2));
+    CHECK(read[0] == 0xAB && read[1] == 0xCD);
+    stats = watch_host_get_i2c_stats(true);
+    CHECK(stats.transactions == 2);
+    CHECK(stats.bytes == 6);
+    CHECK(stats.bus_us == 10 * ((1 + 9 + 9 * 3 + 1) + (1 + 9 + 9 + 1 + 9 + 9 * 2 + 1)));
+    CHECK(stats.wait_ticks >= 1);
+
+    // nobody home: the address is NACKed, and that's all the time it takes.
+    CHECK(!watch_i2c_write_read(MISSING_ADDRESS, &reg, 1, read, 2));
+    stats = watch_host_get_i2c_stats(true);
+    CHECK(stats.failures == 1);
+    CHECK(stats.bus_us == 10 * (1 + 9 + 1));
+
+    // three queued at once go out back to back, in order, without the CPU waiting on any of them. each takes
+    // about 0.4 ms, so they're all done within two ticks of the virtual clock, rather than a tick apiece.
+    watch_i2c_transaction_t queued[3];
+    uint8_t results[3][2];
+    num_finished = 0;
+    uint64_t start = main_loop_get_ticks();
+    for (uint8_t i = 0; i < 3; i++) {
+        queued[i] = (watch_i2c_transaction_t) { .addr = DEVICE_ADDRESS, .write_buf = &reg, .write_length = 1,
+                                                .read_buf = results[i], .read_length = 2, .callback = _record };
+        watch_i2c_submit(&queued[i]);
+    }
+    CHECK(watch_i2c_busy());
+    CHECK(queued[0].status == WATCH_I2C_PENDING);
+    CHECK(num_finished == 0);
+    main_loop_advance(2);
+    CHECK(!watch_i2c_busy());
+    CHECK(num_finished == 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(finished[i] == &queued[i]);
+        CHECK(queued[i].status == WATCH_I2C_DONE);
+        CHECK(results[i][0] == 0xAB && results[i][1] == 0xCD);
+    }
+    CHECK(finished_at[2] - start <= 2);
+    stats = watch_host_get_i2c_stats(true);
+    CHECK(stats.wait_ticks == 0);
+
+    // a callback can queue the next one, and waiting on the last waits through the whole chain.
+    num_finished = 0;
+    queued[2] = (watch_i2c_transaction_t) { .addr = DEVICE_ADDRESS, .write_buf = &reg, .write_length = 1,
+                                            .read_buf = results[2], .read_length = 2, .callback = _record };
+    queued[1] = (watch_i2c_transaction_t) { .addr = MISSING_ADDRESS, .write_buf = write, .write_length = 3,
+                                            .callback = _chain, .user_data = &queued[2] };
+    queued[0] = (watch_i2c_transaction_t) { .addr = DEVICE_ADDRESS, .write_buf = write, .write_length = 3,
+                                            .callback = _chain, .user_data = &queued[1] };
+    watch_i2c_submit(&queued[0]);
+    CHECK(watch_i2c_wait(&queued[0]));
+    CHECK(num_finished == 1);
+    CHECK(!watch_i2c_wait(&queued[1]));
+    CHECK(queued[1].status == WATCH_I2C_NACK);
+    CHECK(watch_i2c_wait(&queued[2]));
+    CHECK(num_finished == 3);
+
+    // turning the bus off lets what's queued finish first.
+    watch_i2c_submit(&queued[2]);
+    watch_disable_i2c();
+    CHECK(queued[2].status == WATCH_I2C_DONE);
+    CHECK(!watch_i2c_write_read(DEVICE_ADDRESS, &reg, 1, read, 2));
+
+    printf("watch_i2c passed\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_extint.h"
+#include "watch_main_loop.h"
+
+static uint32_t watch_backup_data[8];
+// whether A4 is set up to wake us, in which case sleep leaves its interrupt alone.
+static bool a4_extwake;
+
+void watch_register_extwake_callback(uint8_t pin, ext_irq_cb_t callback, bool level) {
+    if (pin == BTN_ALARM || pin == A4) {
+        watch_enable_external_interrupts();
+        watch_register_interrupt_callback(pin, callback, level ? INTERRUPT_TRIGGER_RISING : INTERRUPT_TRIGGER_FALLING);
+        if (pin == A4) a4_extwake = true;
+    }
+}
+
+void watch_disable_extwake_interrupt(uint8_t pin) {
+    if (pin == BTN_ALARM || pin == A4) {
+        watch_register_interrupt_callback(pin, NULL, INTERRUPT_TRIGGER_NONE);
+        if (pin == A4) a4_extwake = false;
+    }
+}
+
+void watch_store_backup_data(uint32_t data, uint8_t reg) {
+    if (reg < 8) {
+        watch_backup_data[reg] = data;
+    }
+}
+
+uint32_t watch_get_backup_data(uint8_t reg) {
+    if (reg < 8) {
+        return watch_backup_data[reg];
+    }
+
+    return 0;
+}
+
+void watch_enter_sleep_mode(void) {
+    // whatever is on screen now is what we'll show while we sleep.
+    watch_display_commit();
+
+    // on the watch, this shuts down the EIC, leaving only the RTC alarm and the extwake pin to wake us.
+    watch_register_interrupt_callback(BTN_MODE, NULL, INTERRUPT_TRIGGER_NONE);
+    watch_register_interrupt_callback(BTN_LIGHT, NULL, INTERRUPT_TRIGGER_NONE);
+    if (!a4_extwake) watch_register_interrupt_callback(A4, NULL, INTERRUPT_TRIGGER_NONE);
+    // and the I2C bus.
+    watch_disable_i2c();
+
+    // disable tick interrupt
+    watch_rtc_disable_all_periodic_callbacks();
+
+    // enter standby (4); we basically hang out here until an interrupt wakes us.
+    main_loop_wait_for_interrupt();
+
+    // call app_setup so the app can re-enable everything we disabled.
+    app_setup();
+
+    // and call app_wake_from_standby (since main won't have a chance to do it)
+    app_wake_from_standby();
+}
+
+void watch_enter_deep_sleep_mode(void) {
+    // identical to sleep mode except we disable the LCD first.
+    watch_clear_display();
+
+    watch_enter_sleep_mode();
+}
+
+void watch_enter_backup_mode(void) {
+    // go into backup sleep mode (5). when we exit, the reset controller will take over.
+    // there's no reset to simulate, so like the simulator, we just carry on.
+}
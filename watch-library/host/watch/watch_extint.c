@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_extint.h"
+#include "watch_main_loop.h"
+
+static bool external_interrupt_enabled = false;
+static ext_irq_cb_t external_interrupt_mode_callback = NULL;
+static watch_interrupt_trigger external_interrupt_mode_trigger = INTERRUPT_TRIGGER_NONE;
+static ext_irq_cb_t external_interrupt_light_callback = NULL;
+static watch_interrupt_trigger external_interrupt_light_trigger = INTERRUPT_TRIGGER_NONE;
+static ext_irq_cb_t external_interrupt_alarm_callback = NULL;
+static watch_interrupt_trigger external_interrupt_alarm_trigger = INTERRUPT_TRIGGER_NONE;
+
+void watch_enable_external_interrupts(void) {
+    external_interrupt_enabled = true;
+}
+
+void watch_disable_external_interrupts(void) {
+    external_interrupt_enabled = false;
+}
+
+void watch_host_set_button(uint8_t pin, bool level) {
+    ext_irq_cb_t callback;
+    watch_interrupt_trigger trigger;
+
+    if (pin == BTN_MODE) {
+        callback = external_interrupt_mode_callback;
+        trigger = external_interrupt_mode_trigger;
+    } else if (pin == BTN_LIGHT) {
+        callback = external_interrupt_light_callback;
+        trigger = external_interrupt_light_trigger;
+    } else if (pin == BTN_ALARM) {
+        callback = external_interrupt_alarm_callback;
+        trigger = external_interrupt_alarm_trigger;
+    } else {
+        return;
+    }
+
+    // the buttons read high when pressed.
+    watch_set_pin_level(pin, level);
+
+    if (!external_interrupt_enabled) return;
+
+    watch_interrupt_trigger event = level ? INTERRUPT_TRIGGER_RISING : INTERRUPT_TRIGGER_FALLING;
+    if (callback && (event & trigger) != 0) {
+        callback();
+        resume_main_loop();
+    }
+}
+
+void watch_register_interrupt_callback(const uint8_t pin, ext_irq_cb_t callback, watch_interrupt_trigger trigger) {
+    if (pin == BTN_MODE) {
+        external_interrupt_mode_callback = callback;
+        external_interrupt_mode_trigger = trigger;
+    } else if (pin == BTN_LIGHT) {
+        external_interrupt_light_callback = callback;
+        external_interrupt_light_trigger = trigger;
+    } else if (pin == BTN_ALARM) {
+        external_interrupt_alarm_callback = callback;
+        external_interrupt_alarm_trigger = trigger;
+    }
+}
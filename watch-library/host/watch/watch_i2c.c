@@ -0,0 +1,216 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <string.h>
+#include "watch_i2c.h"
+
+// the watch runs its bus at 100 kHz (CONF_SERCOM_1_I2CM_BAUD), so a bit takes 10 µs.
+#define WATCH_HOST_I2C_BIT_US 10
+#define WATCH_HOST_I2C_MAX_DEVICES 8
+
+static watch_host_i2c_device_t devices[WATCH_HOST_I2C_MAX_DEVICES];
+static bool enabled;
+static watch_host_i2c_stats_t stats;
+
+// transactions waiting for the bus, oldest first, like the watch's. the one at the head is on the bus now, and
+// finishes when its timer fires.
+static watch_i2c_transaction_t *queue_head;
+static watch_i2c_transaction_t *queue_tail;
+static int8_t transfer_timer = -1;
+static uint64_t transfer_deadline;
+// the bus is timed in microseconds, so that back to back transactions don't each round up to a whole tick.
+static uint64_t bus_free_us;
+
+void watch_host_i2c_attach(const watch_host_i2c_device_t *device) {
+    for (uint8_t i = 0; i < WATCH_HOST_I2C_MAX_DEVICES; i++) {
+        if (devices[i].transfer == NULL || devices[i].addr == device->addr) {
+            devices[i] = *device;
+            return;
+        }
+    }
+}
+
+watch_host_i2c_stats_t watch_host_get_i2c_stats(bool reset) {
+    watch_host_i2c_stats_t retval = stats;
+    if (reset) memset(&stats, 0, sizeof(stats));
+    return retval;
+}
+
+static const watch_host_i2c_device_t *_watch_i2c_find_device(int16_t addr) {
+    for (uint8_t i = 0; i < WATCH_HOST_I2C_MAX_DEVICES; i++) {
+        if (devices[i].transfer != NULL && devices[i].addr == addr) return &devices[i];
+    }
+    return NULL;
+}
+
+// a start, the address and its ACK, each byte and its ACK, and a stop; a read after a write adds a repeated
+// start and the address again. a NACKed address ends it there.
+static uint32_t _watch_i2c_duration_us(watch_i2c_transaction_t *transaction, bool acked) {
+    uint32_t bits = 1 + 9 + 1;
+    if (acked) {
+        bits += 9 * (transaction->write_length + transaction->read_length);
+        if (transaction->write_length && transaction->read_length) bits += 1 + 9;
+    }
+    return bits * WATCH_HOST_I2C_BIT_US;
+}
+
+static void _watch_i2c_finished(void *user_data);
+
+static void _watch_i2c_start(void) {
+    watch_i2c_transaction_t *transaction = queue_head;
+    if (transaction == NULL) return;
+
+    // the next one in the queue goes out as soon as the last one's done, not when its timer gets around to firing.
+    uint32_t duration = _watch_i2c_duration_us(transaction, _watch_i2c_find_device(transaction->addr) != NULL);
+    bus_free_us += duration;
+    stats.bus_us += duration;
+    // like the storage, the interrupt comes on the first tick after the transaction's done.
+    transfer_deadline = (bus_free_us * MAIN_LOOP_TICKS_PER_SECOND + 999999) / 1000000;
+    transfer_timer = main_loop_set_timer(_watch_i2c_finished, NULL, transfer_deadline, 0);
+}
+
+// the bytes change hands when the transaction's done, which is when the device would have seen all of them.
+static void _watch_i2c_finished(void *user_data) {
+    (void) user_data;
+    watch_i2c_transaction_t *transaction = queue_head;
+    const watch_host_i2c_device_t *device = _watch_i2c_find_device(transaction->addr);
+    watch_i2c_status_t status = WATCH_I2C_NACK;
+
+    transfer_timer = -1;
+    stats.transactions++;
+    if (device != NULL && device->transfer(transaction->write_buf, transaction->write_length, transaction->read_buf, transaction->read_length)) {
+        stats.bytes += transaction->write_length + transaction->read_length;
+        status = WATCH_I2C_DONE;
+    } else {
+        stats.failures++;
+    }
+
+    queue_head = transaction->next;
+    if (queue_head == NULL) queue_tail = NULL;
+    transaction->next = NULL;
+    _watch_i2c_start();
+
+    transaction->status = status;
+    if (transaction->callback != NULL) transaction->callback(transaction);
+    // this stands in for the I2C interrupt, which wakes the watch.
+    resume_main_loop();
+}
+
+void watch_enable_i2c(void) {
+    enabled = true;
+}
+
+void watch_disable_i2c(void) {
+    while (queue_head != NULL) watch_i2c_wait(queue_head);
+    enabled = false;
+}
+
+void watch_i2c_submit(watch_i2c_transaction_t *transaction) {
+    transaction->status = WATCH_I2C_PENDING;
+    transaction->next = NULL;
+    if (!enabled) {
+        stats.failures++;
+        transaction->status = WATCH_I2C_ERROR;
+        if (transaction->callback != NULL) transaction->callback(transaction);
+        return;
+    }
+
+    if (queue_tail == NULL) {
+        uint64_t now_us = main_loop_get_ticks() * 1000000 / MAIN_LOOP_TICKS_PER_SECOND;
+        if (bus_free_us < now_us) bus_free_us = now_us;
+        queue_head = queue_tail = transaction;
+        _watch_i2c_start();
+    } else {
+        queue_tail->next = transaction;
+        queue_tail = transaction;
+    }
+}
+
+bool watch_i2c_wait(watch_i2c_transaction_t *transaction) {
+    while (transaction->status == WATCH_I2C_PENDING) {
+        // sleep until the transaction at the head of the queue is done; if it isn't ours, go around again.
+        uint64_t now = main_loop_get_ticks();
+        uint64_t ticks = transfer_deadline > now ? transfer_deadline - now : 0;
+        stats.wait_ticks += ticks;
+        main_loop_advance(ticks);
+    }
+
+    return transaction->status == WATCH_I2C_DONE;
+}
+
+bool watch_i2c_busy(void) {
+    return queue_head != NULL;
+}
+
+bool watch_i2c_write_read(int16_t addr, const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length) {
+    watch_i2c_transaction_t transaction = {
+        .addr = addr,
+        .write_buf = write_buf,
+        .write_length = write_length,
+        .read_buf = read_buf,
+        .read_length = read_length,
+    };
+
+    if (write_length == 0 && read_length == 0) return true;
+    watch_i2c_submit(&transaction);
+    return watch_i2c_wait(&transaction);
+}
+
+void watch_i2c_send(int16_t addr, uint8_t *buf, uint16_t length) {
+    watch_i2c_write_read(addr, buf, length, NULL, 0);
+}
+
+void watch_i2c_receive(int16_t addr, uint8_t *buf, uint16_t length) {
+    watch_i2c_write_read(addr, NULL, 0, buf, length);
+}
+
+void watch_i2c_write8(int16_t addr, uint8_t reg, uint8_t data) {
+    uint8_t buf[2] = { reg, data };
+    watch_i2c_send(addr, buf, 2);
+}
+
+uint8_t watch_i2c_read8(int16_t addr, uint8_t reg) {
+    uint8_t data = 0;
+    watch_i2c_write_read(addr, &reg, 1, &data, 1);
+    return data;
+}
+
+uint16_t watch_i2c_read16(int16_t addr, uint8_t reg) {
+    uint16_t data = 0;
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 2);
+    return data;
+}
+
+uint32_t watch_i2c_read24(int16_t addr, uint8_t reg) {
+    uint32_t data = 0;
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 3);
+    return data << 8;
+}
+
+uint32_t watch_i2c_read32(int16_t addr, uint8_t reg) {
+    uint32_t data = 0;
+    watch_i2c_write_read(addr, &reg, 1, (uint8_t *)&data, 4);
+    return data;
+}
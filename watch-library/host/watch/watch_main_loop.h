@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WATCH_MAIN_LOOP_H_
+#define WATCH_MAIN_LOOP_H_
+
+#include <stdio.h>
+#include "driver_init.h"
+
+// The host backend has no real clock. Instead, time is counted in ticks of the RTC's 1024 Hz prescaler, and only
+// moves forward when the main loop sleeps or a delay is requested. Everything that would be an interrupt on the
+// watch (RTC ticks and alarms, buttons, the buzzer sequencer) is a timer on this virtual clock, so a run is fully
+// determined by its start time and the button presses fed to it.
+#define MAIN_LOOP_TICKS_PER_SECOND 1024
+
+typedef void (*main_loop_timer_cb_t)(void *user_data);
+
+/// Returns the number of ticks since the virtual clock was started.
+uint64_t main_loop_get_ticks(void);
+
+/** @brief Schedules a callback on the virtual clock.
+  * @param callback The function to call when the timer fires.
+  * @param user_data Passed through to the callback.
+  * @param deadline The tick at which the timer should first fire.
+  * @param period If nonzero, the timer fires again every period ticks until it is cleared.
+  * @return An ID for main_loop_clear_timer, or -1 if no timers are free.
+  * @note Timers don't wake the watch by themselves; a callback standing in for an interrupt should call
+  *       resume_main_loop, as the simulator's do.
+  */
+int8_t main_loop_set_timer(main_loop_timer_cb_t callback, void *user_data, uint64_t deadline, uint32_t period);
+
+/// Cancels a timer set with main_loop_set_timer. Passing -1 is a no-op.
+void main_loop_clear_timer(int8_t timer_id);
+
+/// Moves the virtual clock forward, firing any timers that come due along the way.
+void main_loop_advance(uint64_t ticks);
+
+/// Fires timers in order until one of them calls resume_main_loop.
+void main_loop_wait_for_interrupt(void);
+
+/// Returns the number of times the watch has waited for an interrupt.
+uint32_t main_loop_get_wakeups(void);
+
+/// Called by interrupt callbacks to wake the watch from standby.
+void resume_main_loop(void);
+
+void delay_ms(const uint16_t ms);
+
+/// Drives a button as if it had been pressed (level true) or released (level false).
+void watch_host_set_button(uint8_t pin, bool level);
+
+/// Writes what the LCD is showing as a line of text: the ten characters, then any lit indicators.
+void watch_host_print_display(FILE *stream);
+
+/// Counts of the calls made to watch_storage, so benchmarks can see how hard a workload works the flash.
+typedef struct {
+    uint32_t reads;
+    uint32_t bytes_read;
+    uint32_t writes;
+    uint32_t bytes_written;
+    uint32_t erases;
+    uint32_t syncs;
+    uint32_t most_erases;   // the most times any one row was erased, which is what wears the flash out
+    uint64_t wait_ticks;    // virtual time spent waiting for writes and erases to finish
+} watch_host_storage_stats_t;
+
+/// Returns the storage counts since the last reset, and optionally resets them.
+watch_host_storage_stats_t watch_host_get_storage_stats(bool reset);
+
+/** @brief A device on the host's pretend I2C bus.
+  * @details Each transaction is a write of write_length bytes, then a read of read_length bytes after a repeated
+  *          start; either can be empty. Return false to NACK it, and the read buffer is left as it was.
+  */
+typedef struct {
+    int16_t addr;
+    bool (*transfer)(const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length);
+} watch_host_i2c_device_t;
+
+/// Puts a device on the bus, in place of any other at its address. Nothing answers at an address with no device.
+void watch_host_i2c_attach(const watch_host_i2c_device_t *device);
+
+/// Counts of the I2C bus's traffic, so tests and benchmarks can see how busy a driver keeps it.
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;         // data bytes, both ways, not counting addresses
+    uint32_t failures;      // transactions that were NACKed, or tried with the bus off
+    uint64_t bus_us;        // time the bus was busy, at its 100 kHz
+    uint64_t wait_ticks;    // virtual time the CPU spent waiting on the bus
+} watch_host_i2c_stats_t;
+
+/// Returns the I2C counts since the last reset, and optionally resets them.
+watch_host_i2c_stats_t watch_host_get_i2c_stats(bool reset);
+
+#endif // WATCH_MAIN_LOOP_H_
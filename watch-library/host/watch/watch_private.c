@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "watch_private.h"
+
+void _watch_init(void) {
+    // External wake depends on RTC; calendar is a required module.
+    _watch_rtc_init();
+}
+
+// the watch seeds arc4random from its true random number generator, and glibc seeds it from the kernel.
+// on the host we want every run to play out the same way, so faces get numbers from a fixed-seed xorshift instead.
+static uint32_t random_state = 0x5EED5EED;
+
+uint32_t arc4random(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+uint32_t arc4random_uniform(uint32_t upper_bound) {
+    if (upper_bound < 2) return 0;
+    // reject the values that would bias the result toward the low end.
+    uint32_t min = -upper_bound % upper_bound;
+    uint32_t r;
+    do r = arc4random(); while (r < min);
+    return r % upper_bound;
+}
+
+void arc4random_buf(void *buf, size_t nbytes) {
+    uint8_t *bytes = buf;
+    for (size_t i = 0; i < nbytes; i++) bytes[i] = arc4random();
+}
+
+void _watch_enable_tcc(void) {}
+
+void _watch_disable_tcc(void) {}
+
+extern bool _watch_host_usb_enabled;
+
+void _watch_enable_usb(void) {
+    // the shell reads from standard input, so the script has to come from a file.
+    _watch_host_usb_enabled = true;
+}
+
+void watch_disable_TRNG(void) {}
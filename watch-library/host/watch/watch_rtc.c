@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_rtc.h"
+#include "watch_main_loop.h"
+#include "watch_utility.h"
+
+// like main.c on the watch, start the clock at the beginning of 2023 if nobody sets it.
+static uint32_t time_offset = 1672531200;
+static int8_t tick_timers[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+static ext_irq_cb_t tick_callbacks[8];
+static int8_t alarm_timer = -1;
+static ext_irq_cb_t alarm_callback;
+static watch_date_time registered_alarm_time;
+static watch_rtc_alarm_match registered_alarm_mask;
+
+static uint32_t _watch_rtc_get_timestamp(void) {
+    return time_offset + main_loop_get_ticks() / MAIN_LOOP_TICKS_PER_SECOND;
+}
+
+bool _watch_rtc_is_enabled(void) {
+    return true;
+}
+
+void _watch_rtc_init(void) {
+}
+
+void watch_rtc_set_date_time(watch_date_time date_time) {
+    // the prescaler keeps running, so sub-second phase is preserved, as on the watch.
+    time_offset = watch_utility_date_time_to_unix_time(date_time, 0) - main_loop_get_ticks() / MAIN_LOOP_TICKS_PER_SECOND;
+
+    // the alarm compares against the clock, so it has to be rescheduled against the new time.
+    if (alarm_timer != -1) watch_rtc_register_alarm_callback(alarm_callback, registered_alarm_time, registered_alarm_mask);
+}
+
+watch_date_time watch_rtc_get_date_time(void) {
+    return watch_utility_date_time_from_unix_time(_watch_rtc_get_timestamp(), 0);
+}
+
+void watch_rtc_register_tick_callback(ext_irq_cb_t callback) {
+    watch_rtc_register_periodic_callback(callback, 1);
+}
+
+void watch_rtc_disable_tick_callback(void) {
+    watch_rtc_disable_periodic_callback(1);
+}
+
+static void watch_invoke_periodic_callback(void *userData) {
+    ext_irq_cb_t callback = *(ext_irq_cb_t *)userData;
+    if (callback) callback();
+    resume_main_loop();
+}
+
+void watch_rtc_register_periodic_callback(ext_irq_cb_t callback, uint8_t frequency) {
+    // we told them, it has to be a power of 2.
+    if (__builtin_popcount(frequency) != 1) return;
+
+    // this left-justifies the period in a 32-bit integer.
+    uint32_t tmp = (frequency & 0xFF) << 24;
+    // now we can count the leading zeroes to get the value we need.
+    // 0x01 (1 Hz) will have 7 leading zeros for PER7. 0xF0 (128 Hz) will have no leading zeroes for PER0.
+    uint8_t per_n = __builtin_clz(tmp);
+
+    // periodic interrupts come from the prescaler, so they land on multiples of their period.
+    uint32_t period = MAIN_LOOP_TICKS_PER_SECOND / frequency;
+    uint64_t deadline = (main_loop_get_ticks() / period + 1) * period;
+
+    main_loop_clear_timer(tick_timers[per_n]);
+    tick_callbacks[per_n] = callback;
+    tick_timers[per_n] = main_loop_set_timer(watch_invoke_periodic_callback, &tick_callbacks[per_n], deadline, period);
+}
+
+void watch_rtc_disable_periodic_callback(uint8_t frequency) {
+    if (__builtin_popcount(frequency) != 1) return;
+    uint8_t per_n = __builtin_clz((frequency & 0xFF) << 24);
+    main_loop_clear_timer(tick_timers[per_n]);
+    tick_timers[per_n] = -1;
+}
+
+void watch_rtc_disable_matching_periodic_callbacks(uint8_t mask) {
+    for (int i = 0; i < 8; i++) {
+        if ((mask & (1 << i)) != 0) {
+            main_loop_clear_timer(tick_timers[i]);
+            tick_timers[i] = -1;
+        }
+    }
+}
+
+void watch_rtc_disable_all_periodic_callbacks(void) {
+    watch_rtc_disable_matching_periodic_callbacks(0xFF);
+}
+
+static void watch_invoke_alarm_callback(void *userData) {
+    (void) userData;
+    // a full date and time match only fires once.
+    if (registered_alarm_mask == ALARM_MATCH_YYMMDDHHMMSS) alarm_timer = -1;
+    if (alarm_callback) alarm_callback();
+    resume_main_loop();
+}
+
+void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time alarm_time, watch_rtc_alarm_match mask) {
+    watch_rtc_disable_alarm_callback();
+
+    uint32_t now = _watch_rtc_get_timestamp();
+    uint32_t phase = alarm_time.unit.second;
+    uint32_t period;
+    uint32_t match;
+
+    switch (mask) {
+        case ALARM_MATCH_SS:
+            period = 60;
+            break;
+        case ALARM_MATCH_MMSS:
+            period = 60 * 60;
+            phase += alarm_time.unit.minute * 60;
+            break;
+        case ALARM_MATCH_HHMMSS:
+            period = 60 * 60 * 24;
+            phase += alarm_time.unit.minute * 60 + alarm_time.unit.hour * 60 * 60;
+            break;
+        case ALARM_MATCH_YYMMDDHHMMSS:
+            period = 0;
+            break;
+        default:
+            return;
+    }
+
+    if (period) {
+        // the next second, counting this one, that matches the masked fields.
+        match = now + (phase + period - now % period) % period;
+    } else {
+        match = watch_utility_date_time_to_unix_time(alarm_time, 0);
+        // a full date and time match in the past never happens.
+        if (match < now) return;
+    }
+
+    // like the watch, fire on the clock edge after the match.
+    uint64_t deadline = (uint64_t)(match + 1 - time_offset) * MAIN_LOOP_TICKS_PER_SECOND;
+
+    alarm_callback = callback;
+    registered_alarm_time = alarm_time;
+    registered_alarm_mask = mask;
+    alarm_timer = main_loop_set_timer(watch_invoke_alarm_callback, NULL, deadline, period * MAIN_LOOP_TICKS_PER_SECOND);
+}
+
+void watch_rtc_disable_alarm_callback(void) {
+    alarm_callback = NULL;
+    main_loop_clear_timer(alarm_timer);
+    alarm_timer = -1;
+}
+
+void watch_rtc_enable(bool en)
+{
+    //Not simulated
+}
+
+void watch_rtc_freqcorr_write(int16_t value, int16_t sign)
+{
+    //Not simulated
+}
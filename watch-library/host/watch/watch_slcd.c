@@ -0,0 +1,172 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "watch_slcd.h"
+#include "watch_private_display.h"
+#include "watch_main_loop.h"
+#include "hpl_slcd_config.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Segmented Display
+
+// one bit per segment, per common line: as drawn, and as last committed (i.e. what's on screen).
+static uint32_t segments[4];
+static uint32_t committed_segments[4];
+
+static char blink_character;
+static bool blink_state;
+static int8_t blink_timer = -1;
+static bool tick_state;
+static int8_t tick_timer = -1;
+
+void watch_enable_display(void) {
+    watch_clear_display();
+}
+
+void watch_set_pixel(uint8_t com, uint8_t seg) {
+    segments[com] |= 1ul << seg;
+}
+
+void watch_clear_pixel(uint8_t com, uint8_t seg) {
+    segments[com] &= ~(1ul << seg);
+}
+
+void watch_clear_display(void) {
+    for (uint8_t com = 0; com < 4; com++) segments[com] = 0;
+}
+
+void _watch_display_write_segments(const uint32_t mask[3], const uint32_t value[3]) {
+    for (uint8_t com = 0; com < 3; com++) segments[com] = (segments[com] & ~mask[com]) | value[com];
+}
+
+void watch_display_commit(void) {
+    memcpy(committed_segments, segments, sizeof(segments));
+}
+
+static void watch_invoke_blink_callback(void *userData) {
+    (void) userData;
+    blink_state = !blink_state;
+    watch_display_character(blink_state ? blink_character : ' ', 7);
+    watch_clear_pixel(2, 10); // clear segment B of position 7 since it can't blink
+    // on the watch, the SLCD blinks on its own, so this shows up without the app committing it.
+    watch_display_commit();
+}
+
+void watch_start_character_blink(char character, uint32_t duration) {
+    if (blink_timer != -1) return;
+    watch_display_character(character, 7);
+    watch_clear_pixel(2, 10); // clear segment B of position 7 since it can't blink
+    watch_display_commit();
+
+    uint32_t period = duration * MAIN_LOOP_TICKS_PER_SECOND / 1000;
+    blink_state = true;
+    blink_character = character;
+    blink_timer = main_loop_set_timer(watch_invoke_blink_callback, NULL, main_loop_get_ticks() + period, period);
+}
+
+void watch_stop_blink(void) {
+    main_loop_clear_timer(blink_timer);
+    blink_timer = -1;
+    blink_state = false;
+}
+
+static void watch_invoke_tick_callback(void *userData) {
+    (void) userData;
+    tick_state = !tick_state;
+    if (tick_state) {
+        watch_clear_pixel(0, 2);
+        watch_set_pixel(0, 3);
+    } else {
+        watch_clear_pixel(0, 3);
+        watch_set_pixel(0, 2);
+    }
+    watch_display_commit();
+}
+
+void watch_start_tick_animation(uint32_t duration) {
+    if (tick_timer != -1) return;
+    watch_display_character(' ', 8);
+    watch_display_commit();
+
+    uint32_t period = duration * MAIN_LOOP_TICKS_PER_SECOND / 1000;
+    tick_state = true;
+    tick_timer = main_loop_set_timer(watch_invoke_tick_callback, NULL, main_loop_get_ticks() + period, period);
+}
+
+bool watch_tick_animation_is_running(void) {
+    return tick_timer != -1;
+}
+
+void watch_stop_tick_animation(void) {
+    main_loop_clear_timer(tick_timer);
+    tick_timer = -1;
+    tick_state = false;
+
+    watch_display_character(' ', 8);
+    watch_display_commit();
+}
+
+static char _watch_host_read_character(uint8_t position) {
+    // several characters can share a pattern, so these are tried in the order you'd most likely want to see them.
+    static const char candidates[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_=\"'()[]<>/\\^`~!&*+,.?@{|}$#";
+    uint32_t displayed[4];
+    memcpy(displayed, segments, sizeof(segments));
+
+    // the character on display is the one that, drawn again, doesn't change anything.
+    for (const char *c = candidates; *c; c++) {
+        watch_display_character(*c, position);
+        bool match = memcmp(displayed, segments, sizeof(segments)) == 0;
+        memcpy(segments, displayed, sizeof(segments));
+        if (match) return *c;
+    }
+
+    return '?';
+}
+
+void watch_host_print_display(FILE *stream) {
+    static const char *indicator_names[] = { "signal", "bell", "pm", "24h", "lap" };
+    static const uint8_t indicator_pixels[][2] = { {0, 17}, {0, 16}, {2, 17}, {2, 16}, {1, 10} };
+    uint64_t ticks = main_loop_get_ticks();
+    watch_date_time date_time = watch_rtc_get_date_time();
+
+    uint32_t drawn[4];
+
+    fprintf(stream, "%02d:%02d:%02d.%03d \"", date_time.unit.hour, date_time.unit.minute, date_time.unit.second,
+            (int)(ticks % MAIN_LOOP_TICKS_PER_SECOND * 1000 / MAIN_LOOP_TICKS_PER_SECOND));
+    // decode what's on screen, not whatever the app has drawn since it last committed.
+    memcpy(drawn, segments, sizeof(segments));
+    memcpy(segments, committed_segments, sizeof(segments));
+    for (uint8_t position = 0; position < Num_Chars; position++) {
+        fputc(_watch_host_read_character(position), stream);
+    }
+    memcpy(segments, drawn, sizeof(segments));
+    fputc('"', stream);
+
+    if (committed_segments[1] & (1ul << 16)) fputs(" colon", stream);
+    for (uint8_t i = 0; i < sizeof(indicator_names) / sizeof(indicator_names[0]); i++) {
+        if (committed_segments[indicator_pixels[i][0]] & (1ul << indicator_pixels[i][1])) fprintf(stream, " %s", indicator_names[i]);
+    }
+    fputc('\n', stream);
+}
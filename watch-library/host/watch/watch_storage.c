@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Joey Castillo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "watch_storage.h"
+
+#define WATCH_STORAGE_SIZE (NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
+
+static uint8_t storage[WATCH_STORAGE_SIZE];
+static bool storage_initialized = false;
+static watch_host_storage_stats_t stats;
+static uint32_t row_erases[NVMCTRL_RWWEE_PAGES / 4];
+
+// writes and erases take as long as they would on the watch, in virtual time.
+static uint64_t busy_until;
+static ext_irq_cb_t storage_callback;
+static int8_t callback_timer = -1;
+
+static void _watch_storage_wait(void) {
+    uint64_t now = main_loop_get_ticks();
+    if (busy_until > now) {
+        stats.wait_ticks += busy_until - now;
+        main_loop_advance(busy_until - now);
+    }
+}
+
+static void _watch_storage_finished(void *user_data) {
+    (void) user_data;
+    callback_timer = -1;
+    if (storage_callback != NULL) storage_callback();
+}
+
+static void _watch_storage_start(uint32_t duration_us) {
+    _watch_storage_wait();
+    // round up, so that even a page write keeps the flash busy for a tick.
+    busy_until = main_loop_get_ticks() + ((uint64_t)duration_us * MAIN_LOOP_TICKS_PER_SECOND + 999999) / 1000000;
+    if (storage_callback != NULL) {
+        main_loop_clear_timer(callback_timer);
+        callback_timer = main_loop_set_timer(_watch_storage_finished, NULL, busy_until, 0);
+    }
+}
+
+static bool _is_valid_range(uint32_t row, uint32_t offset, uint32_t size) {
+    uint32_t address = row * NVMCTRL_ROW_SIZE + offset;
+    if (!storage_initialized) {
+        // like the watch's flash, start out erased.
+        memset(storage, 0xff, sizeof(storage));
+        storage_initialized = true;
+    }
+    return address <= WATCH_STORAGE_SIZE && size <= WATCH_STORAGE_SIZE - address;
+}
+
+bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    if (!_is_valid_range(row, offset, size)) return false;
+    _watch_storage_wait();
+    stats.reads++;
+    stats.bytes_read += size;
+    memcpy(buffer, storage + row * NVMCTRL_ROW_SIZE + offset, size);
+
+    return true;
+}
+
+bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    if (!_is_valid_range(row, offset, size)) return false;
+    _watch_storage_start(WATCH_STORAGE_WRITE_US);
+    stats.writes++;
+    stats.bytes_written += size;
+
+    // programming flash can only clear bits; writing to a row that wasn't erased won't do what you expect.
+    uint8_t *destination = storage + row * NVMCTRL_ROW_SIZE + offset;
+    for (uint32_t i = 0; i < size; i++) destination[i] &= buffer[i];
+
+    return true;
+}
+
+bool watch_storage_erase(uint32_t row) {
+    if (!_is_valid_range(row, 0, NVMCTRL_ROW_SIZE)) return false;
+    _watch_storage_start(WATCH_STORAGE_ERASE_US);
+    stats.erases++;
+    if (++row_erases[row] > stats.most_erases) stats.most_erases = row_erases[row];
+    memset(storage + row * NVMCTRL_ROW_SIZE, 0xff, NVMCTRL_ROW_SIZE);
+
+    return true;
+}
+
+bool watch_storage_sync(void) {
+    stats.syncs++;
+    _watch_storage_wait();
+
+    return true;
+}
+
+bool watch_storage_busy(void) {
+    return main_loop_get_ticks() < busy_until;
+}
+
+void watch_storage_register_callback(ext_irq_cb_t callback) {
+    storage_callback = callback;
+}
+
+watch_host_storage_stats_t watch_host_get_storage_stats(bool reset) {
+    watch_host_storage_stats_t retval = stats;
+    if (reset) {
+        memset(&stats, 0, sizeof(stats));
+        memset(row_erases, 0, sizeof(row_erases));
+    }
+    return retval;
+}
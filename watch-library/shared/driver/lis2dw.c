@@ -22,10 +22,44 @@
  * SOFTWARE.
  */
 
+#include <string.h>
 #include "lis2dw.h"
 #include "watch.h"
 
+// what's in CTRL1 through CTRL6, which sit next to each other, and CTRL7, as we last wrote them. lis2dw_begin reads
+// them back after the reset; from then on the setters change them here and write them out, and the getters don't
+// need the bus at all.
+static uint8_t ctrl[LIS2DW_REG_CTRL6 - LIS2DW_REG_CTRL1 + 1];
+static uint8_t ctrl7;
+
+static uint8_t *_lis2dw_ctrl(uint8_t reg) {
+    if (reg == LIS2DW_REG_CTRL7) return &ctrl7;
+    return &ctrl[reg - LIS2DW_REG_CTRL1];
+}
+
+// writes the control registers from first to last, between CTRL1 and CTRL6, in one transaction.
+static void _lis2dw_write_ctrl(uint8_t first, uint8_t last) {
+    uint8_t buf[1 + sizeof(ctrl)];
+    uint8_t length = last - first + 1;
+
+    buf[0] = first;
+    memcpy(buf + 1, _lis2dw_ctrl(first), length);
+    watch_i2c_send(LIS2DW_ADDRESS, buf, 1 + length);
+}
+
+// changes the bits in mask to bits, and only goes to the bus if that changes anything.
+static void _lis2dw_update_ctrl(uint8_t reg, uint8_t mask, uint8_t bits) {
+    uint8_t *shadow = _lis2dw_ctrl(reg);
+    uint8_t value = (*shadow & ~mask) | (bits & mask);
+
+    if (value == *shadow) return;
+    *shadow = value;
+    watch_i2c_write8(LIS2DW_ADDRESS, reg, value);
+}
+
 bool lis2dw_begin(void) {
+    uint8_t reg = LIS2DW_REG_CTRL1 | 0x80; // set high bit for consecutive reads
+
     if (lis2dw_get_device_id() != LIS2DW_WHO_AM_I_VAL) {
         return false;
     }
@@ -44,6 +78,9 @@ bool lis2dw_begin(void) {
     //  * Low noise mode off
     //  * FIFO disabled
 
+    watch_i2c_write_read(LIS2DW_ADDRESS, &reg, 1, ctrl, sizeof(ctrl));
+    ctrl7 = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL7);
+
     return true;
 }
 
@@ -61,8 +98,7 @@ lis2dw_reading_t lis2dw_get_raw_reading(void) {
     uint8_t reg = LIS2DW_REG_OUT_X_L | 0x80; // set high bit for consecutive reads
     lis2dw_reading_t retval;
 
-    watch_i2c_send(LIS2DW_ADDRESS, &reg, 1);
-    watch_i2c_receive(LIS2DW_ADDRESS, (uint8_t *)&buffer, 6);
+    watch_i2c_write_read(LIS2DW_ADDRESS, &reg, 1, (uint8_t *)&buffer, 6);
 
     retval.x = buffer[0];
     retval.x |= ((uint16_t)buffer[1]) << 8;
@@ -74,112 +110,136 @@ lis2dw_reading_t lis2dw_get_raw_reading(void) {
     return retval;
 }
 
- lis2dw_acceleration_measurement_t lis2dw_get_acceleration_measurement(lis2dw_reading_t *out_reading) {
+lis2dw_acceleration_measurement_t lis2dw_get_acceleration_measurement(lis2dw_reading_t *out_reading) {
+    lis2dw_milli_g_t milli_g = lis2dw_get_milli_g(out_reading);
+    lis2dw_acceleration_measurement_t retval;
+
+    retval.x = milli_g.x / 1000.0f;
+    retval.y = milli_g.y / 1000.0f;
+    retval.z = milli_g.z / 1000.0f;
+
+    return retval;
+}
+
+// milli-g per LSB of a reading, times 65536, for each range. the readings are left-justified, so whatever the mode,
+// this is the data sheet's sensitivity for 14-bit data divided by 4: 0.061, 0.122, 0.244 and 0.488 mg.
+static const int32_t milli_g_scale[] = {
+    [LIS2DW_RANGE_2_G] = 3998,
+    [LIS2DW_RANGE_4_G] = 7995,
+    [LIS2DW_RANGE_8_G] = 15991,
+    [LIS2DW_RANGE_16_G] = 31982,
+};
+
+// rounds to the nearest milli-g. the product fits easily: 32767 * 31982 is under 2^30.
+static inline int16_t _lis2dw_scale(int16_t value, int32_t scale) {
+    return (value * scale + 32768) >> 16;
+}
+
+lis2dw_milli_g_t lis2dw_get_milli_g(lis2dw_reading_t *out_reading) {
     lis2dw_reading_t reading = lis2dw_get_raw_reading();
-    uint8_t range = lis2dw_get_range();
     if (out_reading != NULL) *out_reading = reading;
 
-    // this bit is cribbed from Adafruit's LIS3DH driver; from their notes, the magic number below
-    // converts from 16-bit lsb to 10-bit and divides by 1k to convert from milli-gs.
-    // final value is raw_lsb => 10-bit lsb -> milli-gs -> gs
-    uint8_t lsb_value = 1;
-    if (range == LIS2DW_RANGE_2_G) lsb_value = 4;
-    if (range == LIS2DW_RANGE_4_G) lsb_value = 8;
-    if (range == LIS2DW_RANGE_8_G) lsb_value = 16;
-    if (range == LIS2DW_RANGE_16_G) lsb_value = 48;
+    return lis2dw_reading_to_milli_g(reading, lis2dw_get_range());
+}
 
-    lis2dw_acceleration_measurement_t retval;
+lis2dw_milli_g_t lis2dw_reading_to_milli_g(lis2dw_reading_t reading, lis2dw_range_t range) {
+    int32_t scale = milli_g_scale[range & LIS2DW_RANGE_16_G];
+    lis2dw_milli_g_t retval;
 
-    retval.x = lsb_value * ((float)reading.x / 64000.0);
-    retval.y = lsb_value * ((float)reading.y / 64000.0);
-    retval.z = lsb_value * ((float)reading.z / 64000.0);
+    retval.x = _lis2dw_scale(reading.x, scale);
+    retval.y = _lis2dw_scale(reading.y, scale);
+    retval.z = _lis2dw_scale(reading.z, scale);
 
     return retval;
 }
 
+void lis2dw_readings_to_milli_g(const lis2dw_reading_t *readings, lis2dw_milli_g_t *milli_g, uint8_t count, lis2dw_range_t range) {
+    int32_t scale = milli_g_scale[range & LIS2DW_RANGE_16_G];
+
+    for (uint8_t i = 0; i < count; i++) {
+        milli_g[i].x = _lis2dw_scale(readings[i].x, scale);
+        milli_g[i].y = _lis2dw_scale(readings[i].y, scale);
+        milli_g[i].z = _lis2dw_scale(readings[i].z, scale);
+    }
+}
+
 uint16_t lis2dw_get_temperature(void) {
     return watch_i2c_read16(LIS2DW_ADDRESS, LIS2DW_REG_OUT_TEMP_L);
 }
 
 void lis2dw_set_range(lis2dw_range_t range) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & ~(LIS2DW_RANGE_16_G << 4);
-    uint8_t bits = range << 4;
-
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL6, LIS2DW_RANGE_16_G << 4, range << 4);
 }
 
 lis2dw_range_t lis2dw_get_range(void) {
-    uint8_t retval = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & (LIS2DW_RANGE_16_G << 4);
-    retval >>= 4;
-    return (lis2dw_range_t)retval;
+    return (lis2dw_range_t)((*_lis2dw_ctrl(LIS2DW_REG_CTRL6) >> 4) & LIS2DW_RANGE_16_G);
 }
 
 void lis2dw_set_data_rate(lis2dw_data_rate_t dataRate) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & ~(0b1111 << 4);
-    uint8_t bits = dataRate << 4;
-
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL1, 0b1111 << 4, dataRate << 4);
 }
 
 lis2dw_data_rate_t lis2dw_get_data_rate(void) {
-    return watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) >> 4;
+    return *_lis2dw_ctrl(LIS2DW_REG_CTRL1) >> 4;
 }
 
 void lis2dw_set_filter_type(lis2dw_filter_t bwfilter) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & ~(LIS2DW_CTRL6_VAL_FDS_HIGH);
-    uint8_t bits = bwfilter << 3;
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL6, LIS2DW_CTRL6_VAL_FDS_HIGH, bwfilter << 3);
 }
 
 lis2dw_filter_t lis2dw_get_filter_type(void) {
-    uint8_t retval = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & (LIS2DW_CTRL6_VAL_FDS_HIGH);
-    retval >>= 3;
-    return (lis2dw_filter_t)retval;
+    return (lis2dw_filter_t)((*_lis2dw_ctrl(LIS2DW_REG_CTRL6) & LIS2DW_CTRL6_VAL_FDS_HIGH) >> 3);
 }
 
 void lis2dw_set_bandwidth_filtering(lis2dw_bandwidth_filtering_mode_t bwfilter) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & ~(LIS2DW_CTRL6_VAL_BANDWIDTH_DIV20);
-    uint8_t bits = bwfilter << 6;
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL6, LIS2DW_CTRL6_VAL_BANDWIDTH_DIV20, bwfilter << 6);
 }
 
 lis2dw_bandwidth_filtering_mode_t lis2dw_get_bandwidth_filtering(void) {
-    uint8_t retval = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL6) & (LIS2DW_CTRL6_VAL_BANDWIDTH_DIV20);
-    retval >>= 6;
-    return (lis2dw_bandwidth_filtering_mode_t)retval;
+    return (lis2dw_bandwidth_filtering_mode_t)(*_lis2dw_ctrl(LIS2DW_REG_CTRL6) >> 6);
 }
 
 void lis2dw_set_mode(lis2dw_mode_t mode) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & ~(0b1100);
-    uint8_t bits = (mode << 2) & 0b1100;
-
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL1, 0b1100, mode << 2);
 }
 
 lis2dw_mode_t lis2dw_get_mode(void) {
-    return (lis2dw_mode_t)(watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & 0b1100) >> 2;
+    return (lis2dw_mode_t)((*_lis2dw_ctrl(LIS2DW_REG_CTRL1) & 0b1100) >> 2);
 }
 
 void lis2dw_set_low_power_mode(lis2dw_low_power_mode_t mode) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & ~(0b11);
-    uint8_t bits = mode & 0b11;
-
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL1, 0b11, mode);
 }
 
 lis2dw_low_power_mode_t lis2dw_get_low_power_mode(void) {
-    return watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & 0b11;
+    return *_lis2dw_ctrl(LIS2DW_REG_CTRL1) & 0b11;
 }
 
 void lis2dw_set_low_noise_mode(bool on) {
-    uint8_t val = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & ~(LIS2DW_CTRL6_VAL_LOW_NOISE);
-    uint8_t bits = on ? LIS2DW_CTRL6_VAL_LOW_NOISE : 0;
-
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1, val | bits);
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL6, LIS2DW_CTRL6_VAL_LOW_NOISE, on ? LIS2DW_CTRL6_VAL_LOW_NOISE : 0);
 }
 
 bool lis2dw_get_low_noise_mode(void) {
-    return (watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL1) & LIS2DW_CTRL6_VAL_LOW_NOISE) != 0;
+    return (*_lis2dw_ctrl(LIS2DW_REG_CTRL6) & LIS2DW_CTRL6_VAL_LOW_NOISE) != 0;
+}
+
+void lis2dw_apply_config(const lis2dw_config_t *config) {
+    uint8_t ctrl1 = (config->data_rate << 4) | ((config->mode << 2) & 0b1100) | (config->low_power_mode & 0b11);
+    uint8_t ctrl6 = ((config->bandwidth << 6) & LIS2DW_CTRL6_VAL_BANDWIDTH_DIV20) |
+                    ((config->range << 4) & LIS2DW_CTRL6_VAL_RANGE_16G) |
+                    ((config->filter << 3) & LIS2DW_CTRL6_VAL_FDS_HIGH) |
+                    (config->low_noise ? LIS2DW_CTRL6_VAL_LOW_NOISE : 0);
+    uint8_t *shadow1 = _lis2dw_ctrl(LIS2DW_REG_CTRL1);
+    uint8_t *shadow6 = _lis2dw_ctrl(LIS2DW_REG_CTRL6);
+    bool ctrl1_changed = ctrl1 != *shadow1;
+    bool ctrl6_changed = ctrl6 != *shadow6;
+
+    *shadow1 = ctrl1;
+    *shadow6 = ctrl6;
+    // if both changed, CTRL2 through CTRL5 go along for the ride, as they are: one write is cheaper than two.
+    if (ctrl1_changed && ctrl6_changed) _lis2dw_write_ctrl(LIS2DW_REG_CTRL1, LIS2DW_REG_CTRL6);
+    else if (ctrl1_changed) _lis2dw_write_ctrl(LIS2DW_REG_CTRL1, LIS2DW_REG_CTRL1);
+    else if (ctrl6_changed) _lis2dw_write_ctrl(LIS2DW_REG_CTRL6, LIS2DW_REG_CTRL6);
 }
 
 inline void lis2dw_disable_fifo(void) {
@@ -191,16 +251,27 @@ inline void lis2dw_enable_fifo(void) {
 }
 
 bool lis2dw_read_fifo(lis2dw_fifo_t *fifo_data) {
+    bool overrun;
+
+    fifo_data->count = lis2dw_read_fifo_burst(fifo_data->readings, sizeof(fifo_data->readings) / sizeof(lis2dw_reading_t), &overrun);
+
+    return overrun;
+}
+
+uint8_t lis2dw_read_fifo_burst(lis2dw_reading_t *readings, uint8_t max_count, bool *overrun) {
     uint8_t temp = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_FIFO_SAMPLE);
-    bool overrun = !!(temp & LIS2DW_FIFO_SAMPLE_OVERRUN);
+    uint8_t count = temp & LIS2DW_FIFO_SAMPLE_COUNT;
+    uint8_t reg = LIS2DW_REG_OUT_X_L | 0x80; // set high bit for consecutive reads
 
-    fifo_data->count = temp & LIS2DW_FIFO_SAMPLE_COUNT;
+    if (overrun != NULL) *overrun = !!(temp & LIS2DW_FIFO_SAMPLE_OVERRUN);
+    if (count > max_count) count = max_count;
+    if (count == 0) return 0;
 
-    for(int i = 0; i < fifo_data->count; i++) {
-        fifo_data->readings[i] = lis2dw_get_raw_reading();
-    }
+    // with the FIFO on, the auto-incrementing address wraps from OUT_Z_H back to OUT_X_L and moves on to the next
+    // sample, so one read drains them all. the samples are little-endian x, y, z, like lis2dw_reading_t itself.
+    watch_i2c_write_read(LIS2DW_ADDRESS, &reg, 1, (uint8_t *)readings, count * sizeof(lis2dw_reading_t));
 
-    return overrun;
+    return count;
 }
 
 void lis2dw_clear_fifo(void) {
@@ -209,24 +280,34 @@ void lis2dw_clear_fifo(void) {
 }
 
 void lis2dw_configure_wakeup_int1(uint8_t threshold, bool latch, bool active_state) {
-    uint8_t configuration;
-
-    // enable wakeup interrupt on INT1 pin
-    configuration = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL4_INT1);
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL4_INT1, configuration | LIS2DW_CTRL4_INT1_WU);
+    // set the duration and threshold, which sit next to each other
+    uint8_t buf[3] = { LIS2DW_REG_INT1_DUR, 0b01111111, threshold | LIS2DW_WAKE_UP_THS_VAL_SLEEP_ON };
+    watch_i2c_send(LIS2DW_ADDRESS, buf, 3);
+
+    // set the pin's behavior in CTRL3, and enable wakeup interrupt on INT1 pin in CTRL4, in one write
+    uint8_t *ctrl3 = _lis2dw_ctrl(LIS2DW_REG_CTRL3);
+    *ctrl3 &= ~(LIS2DW_CTRL3_VAL_LIR | LIS2DW_CTRL3_VAL_H_L_ACTIVE);
+    if (!active_state) *ctrl3 |= LIS2DW_CTRL3_VAL_H_L_ACTIVE;
+    if (latch) *ctrl3 |= LIS2DW_CTRL3_VAL_LIR;
+    *_lis2dw_ctrl(LIS2DW_REG_CTRL4_INT1) |= LIS2DW_CTRL4_INT1_WU;
+    _lis2dw_write_ctrl(LIS2DW_REG_CTRL3, LIS2DW_REG_CTRL4_INT1);
 
-    // set threshold
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_WAKE_UP_THS, threshold | LIS2DW_WAKE_UP_THS_VAL_SLEEP_ON);
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_INT1_DUR, 0b01111111);
+    // enable interrupts
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL7, LIS2DW_CTRL7_VAL_INTERRUPTS_ENABLE, LIS2DW_CTRL7_VAL_INTERRUPTS_ENABLE);
+}
 
-    configuration = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL3) & ~(LIS2DW_CTRL3_VAL_LIR);
-    if (!active_state) configuration |= LIS2DW_CTRL3_VAL_H_L_ACTIVE;
-    if (latch) configuration |= LIS2DW_CTRL3_VAL_LIR;
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL3, configuration);
+void lis2dw_configure_fifo_threshold_int1(uint8_t threshold) {
+    if (threshold == 0) {
+        _lis2dw_update_ctrl(LIS2DW_REG_CTRL4_INT1, LIS2DW_CTRL4_INT1_FTH, 0);
+        watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_FIFO_CTRL, LIS2DW_FIFO_CTRL_MODE_OFF);
+        return;
+    }
 
-    // enable interrupts
-    configuration = watch_i2c_read8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL7);
-    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_CTRL7, configuration | LIS2DW_CTRL7_VAL_INTERRUPTS_ENABLE);
+    // start from an empty FIFO, then keep collecting: in continuous mode the oldest samples are only overwritten if
+    // nobody reads them, and INT1 stays high for as long as there are at least threshold samples waiting.
+    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_FIFO_CTRL, LIS2DW_FIFO_CTRL_MODE_OFF);
+    watch_i2c_write8(LIS2DW_ADDRESS, LIS2DW_REG_FIFO_CTRL, LIS2DW_FIFO_CTRL_MODE_COLLECT_CONTINUOUS | (threshold & LIS2DW_FIFO_CTRL_FTH));
+    _lis2dw_update_ctrl(LIS2DW_REG_CTRL4_INT1, LIS2DW_CTRL4_INT1_FTH, LIS2DW_CTRL4_INT1_FTH);
 }
 
 lis2dw_wakeup_source lis2dw_get_wakeup_source() {
@@ -40,6 +40,12 @@ typedef struct {
     float z;
 } lis2dw_acceleration_measurement_t;
 
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} lis2dw_milli_g_t;
+
 typedef struct {
     int8_t count;
     lis2dw_reading_t readings[32];
@@ -117,6 +123,17 @@ typedef enum {
   LIS2DW_WAKEUP_SRC_WAKEUP_Z    = 0b00000001
 } lis2dw_wakeup_source;
 
+// everything about how the accelerometer takes its measurements, for setting all at once with lis2dw_apply_config.
+typedef struct {
+    lis2dw_data_rate_t data_rate;
+    lis2dw_mode_t mode;
+    lis2dw_low_power_mode_t low_power_mode;
+    lis2dw_range_t range;
+    lis2dw_bandwidth_filtering_mode_t bandwidth;
+    lis2dw_filter_t filter;
+    bool low_noise;
+} lis2dw_config_t;
+
 // Assumes SA0 is high; if low, its 0x18
 #define LIS2DW_ADDRESS (0x19)
 
@@ -287,6 +304,8 @@ typedef enum {
 #define LIS2DW_CTRL7_VAL_HP_REF_MODE        0b00000010
 #define LIS2DW_CTRL7_VAL_LPASS_ON6D         0b00000001
 
+// resets the accelerometer and reads back its control registers. the driver keeps its own copy of them from then on,
+// so the getters below don't go to the bus, and the setters only do when something changes; call this first.
 bool lis2dw_begin(void);
 
 uint8_t lis2dw_get_device_id(void);
@@ -297,6 +316,15 @@ lis2dw_reading_t lis2dw_get_raw_reading(void);
 
 lis2dw_acceleration_measurement_t lis2dw_get_acceleration_measurement(lis2dw_reading_t *out_reading);
 
+// like lis2dw_get_acceleration_measurement, but in whole milli-g, without any floating point.
+lis2dw_milli_g_t lis2dw_get_milli_g(lis2dw_reading_t *out_reading);
+
+// converts a raw reading taken at the given range to milli-g.
+lis2dw_milli_g_t lis2dw_reading_to_milli_g(lis2dw_reading_t reading, lis2dw_range_t range);
+
+// converts count raw readings, as from lis2dw_read_fifo_burst, to milli-g.
+void lis2dw_readings_to_milli_g(const lis2dw_reading_t *readings, lis2dw_milli_g_t *milli_g, uint8_t count, lis2dw_range_t range);
+
 uint16_t lis2dw_get_temperature(void);
 
 void lis2dw_set_range(lis2dw_range_t range);
@@ -327,16 +355,27 @@ void lis2dw_set_low_noise_mode(bool on);
 
 bool lis2dw_get_low_noise_mode(void);
 
+// sets the data rate, modes, range and filtering all at once, in a single I2C write, or none if nothing's changed.
+void lis2dw_apply_config(const lis2dw_config_t *config);
+
 void lis2dw_disable_fifo(void);
 
 void lis2dw_enable_fifo(void);
 
 bool lis2dw_read_fifo(lis2dw_fifo_t *fifo_data);
 
+// reads up to max_count samples from the FIFO in a single I2C transfer, and returns how many it read. overrun, if
+// not NULL, is set if the FIFO filled up and dropped samples.
+uint8_t lis2dw_read_fifo_burst(lis2dw_reading_t *readings, uint8_t max_count, bool *overrun);
+
 void lis2dw_clear_fifo(void);
 
 void lis2dw_configure_wakeup_int1(uint8_t threshold, bool latch, bool active_state);
 
+// collects samples in the FIFO continuously, and raises INT1 while at least threshold (1-31) are waiting. a threshold
+// of 0 turns the FIFO and the interrupt off again.
+void lis2dw_configure_fifo_threshold_int1(uint8_t threshold);
+
 lis2dw_interrupt_source lis2dw_get_interrupt_source(void);
 
 lis2dw_wakeup_source lis2dw_get_wakeup_source(void);
@@ -36,16 +36,14 @@ THE SOFTWARE.
 uint16_t opt3001_readManufacturerID(uint8_t devaddr) {
 	uint8_t buf[2];
 	buf[0] = (uint8_t) OPT3001_MANUFACTURER_ID; 
-	watch_i2c_send(devaddr, buf, 1);
-	watch_i2c_receive(devaddr, buf, 2);
+	watch_i2c_write_read(devaddr, buf, 1, buf, 2);
     return ((uint16_t) buf[0] << 8) | ((uint16_t) buf[1]);
 }
 
 uint16_t opt3001_readDeviceID(uint8_t devaddr) {
 	uint8_t buf[2];
    	buf[0] = (uint8_t) OPT3001_DEVICE_ID; 
-	watch_i2c_send(devaddr, buf, 1);
-	watch_i2c_receive(devaddr, buf, 2);
+	watch_i2c_write_read(devaddr, buf, 1, buf, 2);
     return ((uint16_t) buf[0] << 8) | ((uint16_t) buf[1]);
 }
 
@@ -53,8 +51,7 @@ opt3001_Config_t opt3001_readConfig(uint8_t devaddr) {
 	opt3001_Config_t config;
 	uint8_t buf[2];
 	buf[0] = (uint8_t) OPT3001_CONFIG; 
-	watch_i2c_send(devaddr, buf, 1);
-	watch_i2c_receive(devaddr, buf, 2);
+	watch_i2c_write_read(devaddr, buf, 1, buf, 2);
     config.rawData = ((uint16_t) buf[0] << 8) | ((uint16_t) buf[1]);
 	return config;
 }
@@ -82,8 +79,7 @@ opt3001_t opt3001_readRegister(uint8_t devaddr, opt3001_Command_t command) {
     opt3001_ER_t er;
     uint8_t buf[2]; 
 	buf[0] = (uint8_t) command; 
-	watch_i2c_send(devaddr, buf, 1);
-	watch_i2c_receive(devaddr, buf, 2);
+	watch_i2c_write_read(devaddr, buf, 1, buf, 2);
     er.rawData = ((uint16_t) buf[0] << 8) | ((uint16_t) buf[1]);
     result.raw = er;
     result.lux = 0.01*pow(2, er.Exponent)*er.Result;
@@ -33,9 +33,9 @@
 #define SWCLK GPIO(GPIO_PORTA, 30)
 #define SWDIO GPIO(GPIO_PORTA, 31)
 
-#ifdef __EMSCRIPTEN__
+#if defined(__EMSCRIPTEN__) || defined(WATCH_HOST)
 #include "watch_main_loop.h"
-#endif // __EMSCRIPTEN__
+#endif // __EMSCRIPTEN__ || WATCH_HOST
 
 /** @mainpage Sensor Watch Documentation
  *  @brief This documentation covers most of the functions you will use to interact with the Sensor Watch
@@ -95,6 +95,18 @@ void watch_reset_to_bootloader(void);
   */
 void cdc_task(void);
 
+typedef struct {
+    uint32_t bytes_sent;            // handed to the USB stack since USB was enabled
+    uint32_t bytes_dropped;         // written while the buffers were full and there was no terminal to send them to
+    uint32_t bytes_per_second;      // sent over the last second
+    uint32_t peak_bytes_per_second; // the most sent in any one second
+} watch_cdc_stats_t;
+
+/** @brief Gets counters for the USB serial's transmit path, for checking how fast output is going out.
+  * @param stats filled in with the counters. They stay at zero where there's no USB serial, as in the simulator.
+  */
+void watch_cdc_get_stats(watch_cdc_stats_t *stats);
+
 /** @brief Reads up to len bytes from the USB serial.
   * @param file ignored, you can pass in 0
   * @param ptr pointer to a buffer of at least len bytes
@@ -105,6 +117,6 @@ int read(int file, char *ptr, int len);
 
 /** @brief Disables the TRNG twice in order to work around silicon erratum 1.16.1.
  */
-void watch_disable_TRNG();
+void watch_disable_TRNG(void);
 
 #endif /* WATCH_H_ */
@@ -37,7 +37,7 @@
   */
 void watch_enable_i2c(void);
 
-/** @brief Disables the I2C peripheral.
+/** @brief Disables the I2C peripheral, after any queued transactions have finished.
   */
 void watch_disable_i2c(void);
 
@@ -55,6 +55,68 @@ void watch_i2c_send(int16_t addr, uint8_t *buf, uint16_t length);
   */
 void watch_i2c_receive(int16_t addr, uint8_t *buf, uint16_t length);
 
+/** @brief Writes some bytes to a device and then reads some back, with a repeated start in between.
+  * @details This is how most devices expect a register read: the register address, then the data, without
+  *          letting go of the bus. It's one transaction instead of a send and a receive.
+  * @param addr The address of the device you wish to talk to.
+  * @param write_buf The bytes to send first, usually a register address.
+  * @param write_length The number of bytes in write_buf; if 0, this is just a receive.
+  * @param read_buf Storage for the incoming bytes.
+  * @param read_length The number of bytes to receive; if 0, this is just a send.
+  * @return true if the device acknowledged everything; false if it didn't, or there was a bus error.
+  */
+bool watch_i2c_write_read(int16_t addr, const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length);
+
+typedef enum {
+    WATCH_I2C_PENDING = 0,  // queued, or on the bus now
+    WATCH_I2C_DONE,         // finished, and the device acknowledged everything
+    WATCH_I2C_NACK,         // the device didn't acknowledge its address or a byte we sent
+    WATCH_I2C_ERROR,        // the bus went wrong: lost arbitration, a bus error, or the I2C peripheral is off
+} watch_i2c_status_t;
+
+typedef struct watch_i2c_transaction watch_i2c_transaction_t;
+
+/** @brief Called when an asynchronous transaction finishes.
+  * @param transaction The transaction, with its status set. It's no longer in the queue, so it's yours again:
+  *                    you can reuse it, or submit it again.
+  * @warning On the watch, this is called from the I2C interrupt. Keep it short, and don't call the blocking
+  *          functions above from it; submitting another transaction is fine.
+  */
+typedef void (*watch_i2c_callback_t)(watch_i2c_transaction_t *transaction);
+
+/** @brief A transfer to queue on the bus: an optional write, then an optional read after a repeated start.
+  * @details Fill in the first seven fields. The transaction and its buffers must stay put until it's done.
+  */
+struct watch_i2c_transaction {
+    int16_t addr;                   // the address of the device
+    const uint8_t *write_buf;       // bytes to send, or NULL
+    uint16_t write_length;
+    uint8_t *read_buf;              // storage for bytes to receive, or NULL
+    uint16_t read_length;
+    watch_i2c_callback_t callback;  // called when it's done, or NULL
+    void *user_data;                // for your callback
+    volatile watch_i2c_status_t status;
+    watch_i2c_transaction_t *next;  // private; the queue is a linked list of transactions
+};
+
+/** @brief Queues a transaction, and returns right away. It starts as soon as the ones ahead of it finish.
+  * @details While the bytes go out one by one, the CPU is free to do something else, or sleep: each byte only
+  *          takes a moment of its time, in the I2C interrupt. A register read at 100 kHz takes about 0.4 ms.
+  * @param transaction The transaction to queue. Its status is set to WATCH_I2C_PENDING.
+  */
+void watch_i2c_submit(watch_i2c_transaction_t *transaction);
+
+/** @brief Waits for a transaction to finish, sleeping while it does.
+  * @param transaction A transaction you've submitted.
+  * @return true if it finished with WATCH_I2C_DONE.
+  */
+bool watch_i2c_wait(watch_i2c_transaction_t *transaction);
+
+/** @brief Checks whether there's anything on the bus or waiting to go on it.
+  * @return true if transactions are queued or in progress.
+  */
+bool watch_i2c_busy(void);
+
 /** @brief Writes a byte to a register in an I2C device.
   * @param addr The address of the device you wish to address.
   * @param reg The register on the device that you wish to set.
@@ -141,6 +141,11 @@ static const uint64_t Segment_Map[] = {
 
 static const uint8_t Num_Chars = 10;
 
+/** @brief Sets the segments in each COM line's mask to the matching bits of value, leaving the rest alone.
+  * @details Each backend's watch_slcd.c implements this; watch_display_character draws through it.
+  */
+void _watch_display_write_segments(const uint32_t mask[3], const uint32_t value[3]);
+
 void watch_display_character(uint8_t character, uint8_t position);
 void watch_display_character_lp_seconds(uint8_t character, uint8_t position);
 
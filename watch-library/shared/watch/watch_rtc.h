@@ -58,6 +58,7 @@ typedef enum watch_rtc_alarm_match {
     ALARM_MATCH_SS,
     ALARM_MATCH_MMSS,
     ALARM_MATCH_HHMMSS,
+    ALARM_MATCH_YYMMDDHHMMSS = 6,
 } watch_rtc_alarm_match;
 
 /** @brief Called by main.c to check if the RTC is enabled.
@@ -93,8 +94,10 @@ watch_date_time watch_rtc_get_date_time(void);
   *           * if mask is ALARM_MATCH_SS, the alarm will fire every minute when the clock ticks to seconds == 0.
   *           * with ALARM_MATCH_MMSS, the alarm will once an hour, at the top of each hour.
   *           * with ALARM_MATCH_HHMMSS, the alarm will fire at midnight every day.
-  *          In theory the SAM L22's alarm function can match on days, months and even years, but I have not had
-  *          success with this yet; as such, I am omitting these options for now.
+  *           * with ALARM_MATCH_YYMMDDHHMMSS, the alarm will fire once, when the full date and time match.
+  *          The SAM L22 can also match on days and months, but those options are omitted for now.
+  *          Note that after a match, the interrupt fires at the next rising edge of CLK_RTC_CNT, i.e. one second
+  *          after the time you provide.
   */
 void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time alarm_time, watch_rtc_alarm_match mask);
 
@@ -73,6 +73,15 @@ void watch_clear_pixel(uint8_t com, uint8_t seg);
   */
 void watch_clear_display(void);
 
+/** @brief Pushes any changes made since the last commit out to the display.
+  * @details On hardware, the functions in this section draw into a copy of the display's segment
+  *          registers in RAM, and nothing appears on screen until you call this function; it then writes
+  *          only the registers that changed. main.c commits after every call to app_loop, and the watch
+  *          library commits before sleeping and before playing a note, so most apps never need to call it.
+  *          If you draw something and then block with delay_ms, call this first so it actually appears.
+  */
+void watch_display_commit(void);
+
 /** @brief Displays a string at the given position, starting from the top left. There are ten digits.
            A space in any position will clear that digit.
   * @param string A null-terminated string.
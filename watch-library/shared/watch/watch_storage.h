@@ -37,6 +37,14 @@
 #define NVMCTRL_RWWEE_PAGES 128
 #endif
 
+// how long the flash takes to write a page and erase a row, at most, for the simulator and host to imitate.
+#ifndef WATCH_STORAGE_WRITE_US
+#define WATCH_STORAGE_WRITE_US 2500
+#endif
+#ifndef WATCH_STORAGE_ERASE_US
+#define WATCH_STORAGE_ERASE_US 6000
+#endif
+
 /** @addtogroup storage Flash Storage
   * @brief This section covers functions related to the SAM L22's 8 kilobyte EEPROM emulation area.
   * @details The SAM L22 inside Sensor Watch has a 256 kilobyte Flash memory array that can be
@@ -86,7 +94,21 @@ bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, u
 bool watch_storage_erase(uint32_t row);
 
 /** @brief Waits for any pending writes to complete.
+  * @details Writes and erases return as soon as the flash has started on them, and the next read, write or
+  *          erase waits for the last one to finish. A row erase takes several milliseconds; on the watch, this
+  *          function sleeps through the wait rather than spinning, and other interrupts are handled as usual.
   */
 bool watch_storage_sync(void);
+
+/** @brief Checks whether a write or erase is still in progress.
+  * @return true if the storage area is busy; false if it's ready for the next read, write or erase.
+  */
+bool watch_storage_busy(void);
+
+/** @brief Registers a function to call whenever a write or erase finishes.
+  * @param callback The function to call, or NULL to stop calling one. On the watch, it's called from the
+  *                 flash controller's interrupt, so keep it short.
+  */
+void watch_storage_register_callback(ext_irq_cb_t callback);
 /// @}
 #endif
@@ -33,12 +33,123 @@
 #define ANIMATION_FRAME_ID_INVALID (-1)
 #define ANIMATION_FRAME_ID_SUSPENDED (-2)
 
+#define MAIN_LOOP_NUM_TIMERS 16
+// firing this many timers in one go means we're far behind; let the browser breathe before catching up.
+#define MAIN_LOOP_MAX_TIMERS_PER_CALL 1000
+
+typedef struct {
+    main_loop_timer_cb_t callback;
+    void *user_data;
+    double deadline;
+    double period;
+    bool active;
+} main_loop_timer_t;
+
 static bool sleeping = true;
 static volatile long animation_frame_id = ANIMATION_FRAME_ID_INVALID;
 
+// the virtual clock: virtual_time_base was the time when the browser's clock read real_time_base,
+// and since then it has run at speed times real time (plus any time we skipped ahead).
+static double virtual_time_base;
+static double real_time_base;
+static double speed = 1;
+static bool skip_ahead = false;
+// while a timer's callback runs, the clock reads exactly that timer's deadline.
+static double firing_time = 0;
+
+static main_loop_timer_t timers[MAIN_LOOP_NUM_TIMERS];
+static long timeout_id = -1;
+
 // make compiler happy
 static void main_loop_set_sleeping(bool sleeping);
 static EM_BOOL main_loop(double time, void *userData);
+static void _main_loop_schedule(void);
+
+static main_loop_timer_t *_main_loop_next_timer(void) {
+    main_loop_timer_t *next = NULL;
+    for (int i = 0; i < MAIN_LOOP_NUM_TIMERS; i++) {
+        if (timers[i].active && (next == NULL || timers[i].deadline < next->deadline)) next = &timers[i];
+    }
+    return next;
+}
+
+static void _main_loop_fire_timers(void *userData) {
+    timeout_id = -1;
+    double now = main_loop_get_time();
+
+    for (int i = 0; i < MAIN_LOOP_MAX_TIMERS_PER_CALL; i++) {
+        main_loop_timer_t *timer = _main_loop_next_timer();
+        if (timer == NULL || timer->deadline > now) break;
+
+        firing_time = timer->deadline;
+        // reschedule before calling back, so the callback is free to clear or replace its own timer.
+        if (timer->period > 0) timer->deadline += timer->period;
+        else timer->active = false;
+        timer->callback(timer->user_data);
+        firing_time = 0;
+    }
+
+    _main_loop_schedule();
+}
+
+static void _main_loop_schedule(void) {
+    if (timeout_id != -1) {
+        emscripten_clear_timeout(timeout_id);
+        timeout_id = -1;
+    }
+
+    main_loop_timer_t *next = _main_loop_next_timer();
+    if (next == NULL) return;
+
+    double delay = (next->deadline - main_loop_get_time()) / speed;
+    timeout_id = emscripten_set_timeout(_main_loop_fire_timers, delay > 0 ? delay : 0, NULL);
+}
+
+static void _main_loop_skip_to_next_timer(void) {
+    main_loop_timer_t *next = _main_loop_next_timer();
+    if (next == NULL) return;
+
+    double now = main_loop_get_time();
+    if (next->deadline > now) virtual_time_base += next->deadline - now;
+    _main_loop_schedule();
+}
+
+double main_loop_get_time(void) {
+    if (firing_time) return firing_time;
+    return virtual_time_base + (emscripten_get_now() - real_time_base) * speed;
+}
+
+int8_t main_loop_set_timer(main_loop_timer_cb_t callback, void *user_data, double deadline, double period) {
+    for (int8_t i = 0; i < MAIN_LOOP_NUM_TIMERS; i++) {
+        if (timers[i].active) continue;
+        timers[i].callback = callback;
+        timers[i].user_data = user_data;
+        timers[i].deadline = deadline;
+        timers[i].period = period;
+        timers[i].active = true;
+        _main_loop_schedule();
+        return i;
+    }
+
+    printf("main loop: out of timers!\n");
+    return -1;
+}
+
+void main_loop_clear_timer(int8_t timer) {
+    if (timer < 0 || timer >= MAIN_LOOP_NUM_TIMERS) return;
+    timers[timer].active = false;
+    _main_loop_schedule();
+}
+
+void main_loop_set_speed(double new_speed, bool new_skip_ahead) {
+    if (new_speed <= 0) return;
+
+    virtual_time_base = main_loop_get_time();
+    real_time_base = emscripten_get_now();
+    speed = new_speed;
+    skip_ahead = new_skip_ahead;
+    _main_loop_schedule();
+}
 
 static inline void request_next_frame(void) {
     if (animation_frame_id == ANIMATION_FRAME_ID_INVALID) {
@@ -64,6 +175,7 @@ static EM_BOOL main_loop(double time, void *userData) {
         app_prepare_for_standby();
         sleeping = true;
         animation_frame_id = ANIMATION_FRAME_ID_INVALID;
+        if (skip_ahead) _main_loop_skip_to_next_timer();
         return EM_FALSE;
     }
 
@@ -87,7 +199,7 @@ void suspend_main_loop(void) {
 
 void main_loop_sleep(uint32_t ms) {
     main_loop_set_sleeping(true);
-    emscripten_sleep(ms);
+    emscripten_sleep(ms / speed);
     main_loop_set_sleeping(false);
     animation_frame_id = ANIMATION_FRAME_ID_INVALID;
 }
@@ -107,6 +219,9 @@ void delay_ms(const uint16_t ms) {
 }
 
 int main(void) {
+    virtual_time_base = EM_ASM_DOUBLE({ return Date.now(); });
+    real_time_base = emscripten_get_now();
+
     app_init();
     _watch_init();
     app_setup();
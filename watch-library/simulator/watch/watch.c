@@ -1,3 +1,4 @@
+#include <string.h>
 #include "watch.h"
 
 bool watch_is_buzzer_or_led_enabled(void) {
@@ -11,3 +12,8 @@ bool watch_is_usb_enabled(void) {
 void watch_reset_to_bootloader(void) {
     // No bootloader in the simulator; nothing to do here
 }
+
+void watch_cdc_get_stats(watch_cdc_stats_t *stats) {
+    // output goes straight to the console here, so there's nothing to count.
+    memset(stats, 0, sizeof(watch_cdc_stats_t));
+}
@@ -28,6 +28,25 @@ void watch_enable_i2c(void) {}
 
 void watch_disable_i2c(void) {}
 
+// there's nothing on the simulator's bus, so every transaction is NACKed, right away.
+void watch_i2c_submit(watch_i2c_transaction_t *transaction) {
+    transaction->next = NULL;
+    transaction->status = WATCH_I2C_NACK;
+    if (transaction->callback != NULL) transaction->callback(transaction);
+}
+
+bool watch_i2c_wait(watch_i2c_transaction_t *transaction) {
+    return transaction->status == WATCH_I2C_DONE;
+}
+
+bool watch_i2c_busy(void) {
+    return false;
+}
+
+bool watch_i2c_write_read(int16_t addr, const uint8_t *write_buf, uint16_t write_length, uint8_t *read_buf, uint16_t read_length) {
+    return false;
+}
+
 void watch_i2c_send(int16_t addr, uint8_t *buf, uint16_t length) {}
 
 void watch_i2c_receive(int16_t addr, uint8_t *buf, uint16_t length) {}
@@ -24,6 +24,25 @@
 
 #include "driver_init.h"
 
+// the simulator keeps time on a virtual clock, in milliseconds since the epoch. it normally runs in step
+// with the browser's clock, but it can be sped up, and it can skip straight to the next timer whenever
+// the watch goes to sleep. the RTC keeps time and schedules its interrupts against this clock.
+
+typedef void (*main_loop_timer_cb_t)(void *user_data);
+
+double main_loop_get_time(void);
+
+/** @brief Calls callback once the virtual clock reaches deadline, and then every period milliseconds
+  *        after that if period is nonzero. Like an interrupt, a callback that needs the watch to
+  *        notice it should call resume_main_loop. Returns a timer ID, or -1 if none are free.
+  */
+int8_t main_loop_set_timer(main_loop_timer_cb_t callback, void *user_data, double deadline, double period);
+
+void main_loop_clear_timer(int8_t timer);
+
+/// @brief Runs the virtual clock at speed times real time, optionally skipping ahead while the watch sleeps.
+void main_loop_set_speed(double speed, bool skip_ahead);
+
 void suspend_main_loop(void);
 
 void resume_main_loop(void);
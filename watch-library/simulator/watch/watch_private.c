@@ -57,7 +57,7 @@ void _watch_disable_tcc(void) {}
 
 void _watch_enable_usb(void) {}
 
-void watch_disable_TRNG() {}
+void watch_disable_TRNG(void) {}
 
 // this function ends up getting called by printf to log stuff to the USB console.
 int _write(int file, char *ptr, int len) {
@@ -25,15 +25,17 @@
 #include "watch_rtc.h"
 #include "watch_main_loop.h"
 
+#include <math.h>
 #include <emscripten.h>
-#include <emscripten/html5.h>
 
+// how far the watch's clock is ahead of the virtual clock, in milliseconds.
 static double time_offset = 0;
-static long tick_callbacks[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+static int8_t tick_callbacks[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
 
-static long alarm_interval_id = -1;
-static long alarm_timeout_id = -1;
+static int8_t alarm_timer = -1;
 static double alarm_interval;
+static watch_date_time registered_alarm_time;
+static watch_rtc_alarm_match registered_alarm_mask;
 ext_irq_cb_t alarm_callback;
 ext_irq_cb_t btn_alarm_callback;
 ext_irq_cb_t a2_callback;
@@ -55,21 +57,24 @@ void watch_rtc_set_date_time(watch_date_time date_time) {
         const minute = ($0 >> 6) & 0x3f;
         const second = $0 & 0x3f;
         const date = new Date(year, month - 1, day, hour, minute, second);
-        return date - Date.now();
-    }, date_time.reg);
+        return date - $1;
+    }, date_time.reg, main_loop_get_time());
+
+    // the alarm was scheduled against the old time, so schedule it again.
+    if (alarm_timer != -1) watch_rtc_register_alarm_callback(alarm_callback, registered_alarm_time, registered_alarm_mask);
 }
 
 watch_date_time watch_rtc_get_date_time(void) {
     watch_date_time retval;
     retval.reg = EM_ASM_INT({
-        const date = new Date(Date.now() + $0);
+        const date = new Date($1 + $0);
         return date.getSeconds() |
             (date.getMinutes() << 6) |
             (date.getHours() << 12) |
             (date.getDate() << 17) |
             ((date.getMonth() + 1) << 22) |
             ((date.getFullYear() - 2020) << 26);
-    }, time_offset);
+    }, time_offset, main_loop_get_time());
     return retval;
 }
 
@@ -99,23 +104,25 @@ void watch_rtc_register_periodic_callback(ext_irq_cb_t callback, uint8_t frequen
 
     double interval = 1000.0 / frequency; // in msec
 
-    if (tick_callbacks[per_n] != -1) emscripten_clear_interval(tick_callbacks[per_n]);
-    tick_callbacks[per_n] = emscripten_set_interval(watch_invoke_periodic_callback, interval, (void *)callback);
+    // like the prescaler's outputs, line the ticks up with the watch's seconds.
+    double watch_time = main_loop_get_time() + time_offset;
+    double deadline = (floor(watch_time / interval) + 1) * interval - time_offset;
+
+    main_loop_clear_timer(tick_callbacks[per_n]);
+    tick_callbacks[per_n] = main_loop_set_timer(watch_invoke_periodic_callback, (void *)callback, deadline, interval);
 }
 
 void watch_rtc_disable_periodic_callback(uint8_t frequency) {
     if (__builtin_popcount(frequency) != 1) return;
     uint8_t per_n = __builtin_clz((frequency & 0xFF) << 24);
-    if (tick_callbacks[per_n] != -1) {
-        emscripten_clear_interval(tick_callbacks[per_n]);
-        tick_callbacks[per_n] = -1;
-    }
+    main_loop_clear_timer(tick_callbacks[per_n]);
+    tick_callbacks[per_n] = -1;
 }
 
 void watch_rtc_disable_matching_periodic_callbacks(uint8_t mask) {
     for (int i = 0; i < 8; i++) {
         if (tick_callbacks[i] != -1 && (mask & (1 << i)) != 0) {
-            emscripten_clear_interval(tick_callbacks[i]);
+            main_loop_clear_timer(tick_callbacks[i]);
             tick_callbacks[i] = -1;
         }
     }
@@ -125,13 +132,11 @@ void watch_rtc_disable_all_periodic_callbacks(void) {
     watch_rtc_disable_matching_periodic_callbacks(0xFF);
 }
 
-static void watch_invoke_alarm_interval_callback(void *userData) {
-    if (alarm_callback) alarm_callback();
-}
-
 static void watch_invoke_alarm_callback(void *userData) {
+    // a full date and time match only fires once.
+    if (alarm_interval == 0) alarm_timer = -1;
     if (alarm_callback) alarm_callback();
-    alarm_interval_id = emscripten_set_interval(watch_invoke_alarm_interval_callback, alarm_interval, NULL);
+    resume_main_loop();
 }
 
 void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time alarm_time, watch_rtc_alarm_match mask) {
@@ -147,12 +152,16 @@ void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time al
             alarm_interval = 60 * 60 * 1000;
             break;
         case ALARM_MATCH_HHMMSS:
-            alarm_interval = 60 * 60 * 60 * 1000;
+            alarm_interval = 24 * 60 * 60 * 1000;
+            break;
+        case ALARM_MATCH_YYMMDDHHMMSS:
+            alarm_interval = 0;
             break;
     }
 
+    double now = main_loop_get_time();
     double timeout = EM_ASM_DOUBLE({
-        const now = Date.now();
+        const now = $3;
         const date = new Date(now + $0);
 
         const hour = ($1 >> 12) & 0x1f;
@@ -171,30 +180,32 @@ void watch_rtc_register_alarm_callback(ext_irq_cb_t callback, watch_date_time al
             if (minute < date.getMinutes()) date.setHours(date.getHours() + 1);
             if (hour < date.getHours()) date.setDate(date.getDate() + 1);
             date.setHours(hour, minute, second);
+        } else if ($2 == 6) { // YYMMDDHHMMSS
+            const year = 2020 + (($1 >> 26) & 0x3f);
+            const month = ($1 >> 22) & 0xf;
+            const day = ($1 >> 17) & 0x1f;
+            // like the hardware, fire on the clock edge after the match.
+            const match = new Date(year, month - 1, day, hour, minute, second + 1);
+            return Math.max(0, match - (now + $0));
         } else {
             throw 'Invalid alarm match mask';
         }
 
         return date - now;
-    }, time_offset, alarm_time.reg, mask);
+    }, time_offset, alarm_time.reg, mask, now);
 
     alarm_callback = callback;
-    alarm_timeout_id = emscripten_set_timeout(watch_invoke_alarm_callback, timeout, NULL);
+    registered_alarm_time = alarm_time;
+    registered_alarm_mask = mask;
+    alarm_timer = main_loop_set_timer(watch_invoke_alarm_callback, NULL, now + timeout, alarm_interval);
 }
 
 void watch_rtc_disable_alarm_callback(void) {
     alarm_callback = NULL;
     alarm_interval = 0;
 
-    if (alarm_timeout_id != -1) {
-        emscripten_clear_timeout(alarm_timeout_id);
-        alarm_timeout_id = -1;
-    }
-
-    if (alarm_interval_id != -1) {
-        emscripten_clear_interval(alarm_interval_id);
-        alarm_interval_id = -1;
-    }
+    main_loop_clear_timer(alarm_timer);
+    alarm_timer = -1;
 }
 
 void watch_rtc_enable(bool en)
@@ -38,29 +38,77 @@ static long blink_interval_id = - 1;
 static bool tick_state;
 static long tick_interval_id = -1;
 
+// drawing only touches this bitmap, one word per COM line with a bit per segment. once per animation
+// frame, the segments that changed since the last push are copied to the page in a single call.
+static uint32_t segments[3];
+static uint32_t pushed_segments[3];
+static bool display_dirty = false;
+
+static EM_BOOL watch_push_display(double time, void *userData) {
+    display_dirty = false;
+    uint32_t changed[3];
+    for (int i = 0; i < 3; i++) changed[i] = segments[i] ^ pushed_segments[i];
+    if (!(changed[0] | changed[1] | changed[2])) return EM_FALSE;
+
+    EM_ASM({
+        if (!Module['segmentElements']) {
+            // look up each segment's elements (one per skin) once, indexed by com * 24 + seg.
+            Module['segmentElements'] = [];
+            for (let i = 0; i < 72; i++) Module['segmentElements'][i] = [];
+            document.querySelectorAll("[data-com][data-seg]").forEach((e) => {
+                Module['segmentElements'][e.dataset.com * 24 + +e.dataset.seg].push(e);
+            });
+        }
+        const segments = [$0, $1, $2];
+        const changed = [$3, $4, $5];
+        for (let com = 0; com < 3; com++) {
+            for (let seg = 0; seg < 24; seg++) {
+                if (!(changed[com] & (1 << seg))) continue;
+                const opacity = (segments[com] >> seg) & 1;
+                Module['segmentElements'][com * 24 + seg].forEach((e) => e.style.opacity = opacity);
+            }
+        }
+        Module['displayUpdates'] = (Module['displayUpdates'] || 0) + 1;
+    }, segments[0], segments[1], segments[2], changed[0], changed[1], changed[2]);
+
+    for (int i = 0; i < 3; i++) pushed_segments[i] = segments[i];
+    return EM_FALSE;
+}
+
+static void watch_mark_display_dirty(void) {
+    if (display_dirty) return;
+    display_dirty = true;
+    emscripten_request_animation_frame(watch_push_display, NULL);
+}
+
 void watch_enable_display(void) {
+    // the page starts out showing every segment, so make sure the first push clears them all.
+    for (int i = 0; i < 3; i++) pushed_segments[i] = 0x00FFFFFF;
     watch_clear_display();
 }
 
 void watch_set_pixel(uint8_t com, uint8_t seg) {
-    EM_ASM({
-        document.querySelectorAll("[data-com='" + $0 + "'][data-seg='" + $1 + "']")
-            .forEach((e) => e.style.opacity = 1);
-    }, com, seg);
+    segments[com] |= 1 << seg;
+    watch_mark_display_dirty();
 }
 
 void watch_clear_pixel(uint8_t com, uint8_t seg) {
-    EM_ASM({
-        document.querySelectorAll("[data-com='" + $0 + "'][data-seg='" + $1 + "']")
-            .forEach((e) => e.style.opacity = 0);
-    }, com, seg);
+    segments[com] &= ~(1 << seg);
+    watch_mark_display_dirty();
 }
 
 void watch_clear_display(void) {
-    EM_ASM({
-        document.querySelectorAll("[data-com][data-seg]")
-            .forEach((e) => e.style.opacity = 0);
-    });
+    for (int i = 0; i < 3; i++) segments[i] = 0;
+    watch_mark_display_dirty();
+}
+
+void _watch_display_write_segments(const uint32_t mask[3], const uint32_t value[3]) {
+    for (int i = 0; i < 3; i++) segments[i] = (segments[i] & ~mask[i]) | value[i];
+    watch_mark_display_dirty();
+}
+
+void watch_display_commit(void) {
+    // nothing to do; the bitmap goes to the page on the next animation frame regardless.
 }
 
 static void watch_invoke_blink_callback(void *userData) {
@@ -1,12 +1,34 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include "watch_storage.h"
 
 uint8_t storage[NVMCTRL_ROW_SIZE * NVMCTRL_RWWEE_PAGES];
 
+// writes and erases take as long as they would on the watch, in the main loop's virtual time.
+static double busy_until;
+static ext_irq_cb_t storage_callback;
+static int8_t callback_timer = -1;
+
+static void _watch_storage_finished(void *user_data) {
+    (void) user_data;
+    callback_timer = -1;
+    if (storage_callback != NULL) storage_callback();
+}
+
+static void _watch_storage_start(uint32_t duration_us) {
+    watch_storage_sync();
+    busy_until = main_loop_get_time() + duration_us / 1000.0;
+    if (storage_callback != NULL) {
+        main_loop_clear_timer(callback_timer);
+        callback_timer = main_loop_set_timer(_watch_storage_finished, NULL, busy_until, 0);
+    }
+}
+
 bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
     // printf("read row %ld offset %ld size %ld\n", row, offset, size);
+    watch_storage_sync();
     memcpy(buffer, storage + row * NVMCTRL_ROW_SIZE + offset, size);
 
     return true;
@@ -14,6 +36,7 @@ bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t
 
 bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
     // printf("write row %ld offset %ld size %ld\n", row, offset, size);
+    _watch_storage_start(WATCH_STORAGE_WRITE_US);
     memcpy(storage + row * NVMCTRL_ROW_SIZE + offset, buffer, size);
 
     return true;
@@ -21,12 +44,23 @@ bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, u
 
 bool watch_storage_erase(uint32_t row) {
     // printf("erase row %ld\n", row);
+    _watch_storage_start(WATCH_STORAGE_ERASE_US);
     memset(storage + row * NVMCTRL_ROW_SIZE, 0xff, NVMCTRL_ROW_SIZE);
 
     return true;
 }
 
 bool watch_storage_sync(void) {
-    // nothing to do here!
+    double remaining = busy_until - main_loop_get_time();
+    if (remaining > 0) delay_ms(ceil(remaining));
+
     return true;
 }
+
+bool watch_storage_busy(void) {
+    return main_loop_get_time() < busy_until;
+}
+
+void watch_storage_register_callback(ext_irq_cb_t callback) {
+    storage_callback = callback;
+}